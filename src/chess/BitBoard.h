@@ -3,6 +3,7 @@
 #include "Board.h"
 #include "Types.h"
 #include <array>
+#include <bit>
 namespace Chess::BB {
 
     using Offsets = std::pair<BoardOffset, BoardOffset>;
@@ -116,14 +117,9 @@ namespace Chess::BB {
 
     inline BoardIndex popLsb(BitBoard& bb) {
         //        ASSERT(bb != 0);
-        BitBoard lsb = bb & (~bb + 1);
-        BoardIndex bi = 0;
-        while (lsb != 0) {
-            ++bi;
-            lsb >>= 1;
-        }
+        auto bi = static_cast<BoardIndex>(std::countr_zero(bb));
         bb &= bb - 1;
-        return bi - 1;
+        return bi;
     }
 
     inline bool moreThanOne(BitBoard bb) {
@@ -131,12 +127,7 @@ namespace Chess::BB {
     }
 
     inline BoardIndex countBits(BitBoard bb) {
-        BoardIndex count = 0;
-        while (bb) {
-            count += bb & 1;
-            bb >>= 1;
-        }
-        return count;
+        return static_cast<BoardIndex>(std::popcount(bb));
     }
 
     BitBoard between(BoardIndex a, BoardIndex b);
@@ -1,6 +1,8 @@
 #include "Board.h"
 #include "../util/Assertions.h"
 #include "BitBoard.h"
+#include "HotPathCounters.h"
+#include "Zobrist.h"
 
 #include <algorithm>
 #include <initializer_list>
@@ -67,6 +69,10 @@ namespace Chess {
         return BB::countBits(colorPiecesBB[colorIndex(c)]);
     }
 
+    uint32_t Board::countPieces(Piece p) const {
+        return BB::countBits(pieceBitBoard(p));
+    }
+
     std::optional<Piece> Board::pieceAt(BoardIndex index) const {
         if (index >= size * size || !(piecesBB & BB::squareBoard(index))) {
             return std::nullopt;
@@ -92,13 +98,27 @@ namespace Chess {
             colorPiecesBB[colorIndex(p.color())] &= erase;
             typePiecesBB[typeIndex(p.type())] &= erase;
             m_pieces[index] = Piece::noneValue();
+            m_hash ^= Zobrist::keys.pieces[colorIndex(p.color())][typeIndex(p.type())][index];
+            if (p.type() == Piece::Type::Pawn) {
+                m_pawnHash ^= Zobrist::keys.pieces[colorIndex(p.color())][typeIndex(p.type())][index];
+            }
+            m_pieceSquareScore -= PST::tables.scores[colorIndex(p.color())][typeIndex(p.type())][index];
+            m_phase -= PST::tables.phase[typeIndex(p.type())];
+            if (m_network.network() != nullptr) {
+                updateAccumulator(p, index, false);
+            }
         }
         if (!piece.has_value()) {
             return;
         }
 
         m_pieces[index] = piece->toInt();
-
+        m_hash ^= Zobrist::keys.pieces[colorIndex(piece->color())][typeIndex(piece->type())][index];
+        if (piece->type() == Piece::Type::Pawn) {
+            m_pawnHash ^= Zobrist::keys.pieces[colorIndex(piece->color())][typeIndex(piece->type())][index];
+        }
+        m_pieceSquareScore += PST::tables.scores[colorIndex(piece->color())][typeIndex(piece->type())][index];
+        m_phase += PST::tables.phase[typeIndex(piece->type())];
 
 #ifdef STORE_KING_POS
         if (piece->type() == Piece::Type::King) {
@@ -108,6 +128,9 @@ namespace Chess {
         piecesBB |= square;
         colorPiecesBB[colorIndex(piece->color())] |= square;
         typePiecesBB[typeIndex(piece->type())] |= square;
+        if (m_network.network() != nullptr) {
+            updateAccumulator(*piece, index, true);
+        }
     }
 
     Board Board::standardBoard() {
@@ -141,6 +164,7 @@ namespace Chess {
         board.setPiece(kingCol - 1, wHome, Piece{Piece::Type::Queen, Color::White});
 
         board.m_castlingRights = CastlingRight::WhiteCastling | CastlingRight::BlackCastling;
+        board.m_hash = board.computeHash();
 
         return board;
     }
@@ -199,12 +223,14 @@ namespace Chess {
 
     void Board::makeNullMove() {
         m_nextTurnColor = opposite(m_nextTurnColor);
+        m_hash ^= Zobrist::keys.blackToMove;
         ++m_halfMovesSinceCaptureOrPawn;
         ++m_halfMovesMade;
     }
 
     void Board::undoNullMove() {
         m_nextTurnColor = opposite(m_nextTurnColor);
+        m_hash ^= Zobrist::keys.blackToMove;
         ASSERT(m_halfMovesMade > 0);
         ASSERT(m_halfMovesSinceCaptureOrPawn > 0);
         --m_halfMovesSinceCaptureOrPawn;
@@ -253,7 +279,8 @@ namespace Chess {
         previousEnPassant(board.m_enPassant),
         previousCastlingRights(board.m_castlingRights),
         previousSinceCapture(board.m_halfMovesSinceCaptureOrPawn),
-        timesRepeated(board.m_repeated) {
+        timesRepeated(board.m_repeated),
+        previousHash(board.m_hash) {
     }
 
     void Board::MoveData::takeValues(Board& board) {
@@ -263,13 +290,69 @@ namespace Chess {
         board.m_repeated = timesRepeated;
     }
 
+    uint64_t Board::castlingEnPassantHash() const {
+        uint64_t hash = Zobrist::keys.castling[static_cast<uint8_t>(m_castlingRights)];
+        if (m_enPassant.has_value()) {
+            hash ^= Zobrist::keys.enPassantFile[*m_enPassant % size];
+        }
+        return hash;
+    }
+
+    uint64_t Board::computeHash() const {
+        uint64_t hash = castlingEnPassantHash();
+        if (m_nextTurnColor == Color::Black) {
+            hash ^= Zobrist::keys.blackToMove;
+        }
+        for (BoardIndex index = 0; index < size * size; ++index) {
+            if (Piece::isPiece(m_pieces[index])) {
+                Piece p = Piece::fromInt(m_pieces[index]);
+                hash ^= Zobrist::keys.pieces[colorIndex(p.color())][typeIndex(p.type())][index];
+            }
+        }
+        return hash;
+    }
+
+    uint64_t Board::computePawnHash() const {
+        uint64_t hash = 0;
+        for (Color color : {Color::White, Color::Black}) {
+            BitBoard pawns = pawnBitboard(color);
+            while (pawns) {
+                hash ^= Zobrist::keys.pieces[colorIndex(color)][typeIndex(Piece::Type::Pawn)][BB::popLsb(pawns)];
+            }
+        }
+        return hash;
+    }
+
+    PST::TaperedScore Board::computePieceSquareScore() const {
+        PST::TaperedScore score;
+        for (BoardIndex index = 0; index < size * size; ++index) {
+            if (Piece::isPiece(m_pieces[index])) {
+                Piece p = Piece::fromInt(m_pieces[index]);
+                score += PST::tables.scores[colorIndex(p.color())][typeIndex(p.type())][index];
+            }
+        }
+        return score;
+    }
+
+    int32_t Board::computeGamePhase() const {
+        int32_t phase = 0;
+        for (BoardIndex index = 0; index < size * size; ++index) {
+            if (Piece::isPiece(m_pieces[index])) {
+                phase += PST::tables.phase[typeIndex(Piece::fromInt(m_pieces[index]).type())];
+            }
+        }
+        return phase;
+    }
+
     bool Board::makeMove(Move m) {
+        COUNT_HOT_PATH(MakeMoveCalls);
         ASSERT(m.fromPosition != m.toPosition);
         ASSERT(pieceAt(m.fromPosition).has_value()
                && pieceAt(m.fromPosition)->color() == m_nextTurnColor);
 
         Piece p = pieceAt(m.fromPosition).value();
         MoveData data{*this, m};
+        m_hash ^= castlingEnPassantHash();
 
         ++m_halfMovesMade;
         ++m_halfMovesSinceCaptureOrPawn;
@@ -360,17 +443,26 @@ namespace Chess {
         removeCastlingRights(colTo, rowTo);
 
         m_nextTurnColor = opposite(m_nextTurnColor);
+        m_hash ^= castlingEnPassantHash() ^ Zobrist::keys.blackToMove;
+        ASSERT(m_hash == computeHash());
+        ASSERT(m_pawnHash == computePawnHash());
+        ASSERT(m_pieceSquareScore == computePieceSquareScore());
+        ASSERT(m_phase == computeGamePhase());
 
         m_repeated = findRepetitions();
         return true;
     }
 
     bool Board::undoMove() {
+        COUNT_HOT_PATH(UndoMoveCalls);
         if (m_history.empty()) {
             return false;
         }
 
         m_nextTurnColor = opposite(m_nextTurnColor);
+        // updated like in makeMove instead of taking the previous hash since a null move may have
+        // been made after the move (which then is not undone)
+        m_hash ^= castlingEnPassantHash() ^ Zobrist::keys.blackToMove;
 
         MoveData data = m_history.back();
         m_history.pop_back();
@@ -420,6 +512,11 @@ namespace Chess {
         }
 
         data.takeValues(*this);
+        m_hash ^= castlingEnPassantHash();
+        ASSERT(m_hash == computeHash());
+        ASSERT(m_pawnHash == computePawnHash());
+        ASSERT(m_pieceSquareScore == computePieceSquareScore());
+        ASSERT(m_phase == computeGamePhase());
 
         ASSERT(m_halfMovesMade > 0);
         --m_halfMovesMade;
@@ -438,36 +535,19 @@ namespace Chess {
             return 0;
         }
 
-        Board copy = *this;
-        auto currMove = m_history.rbegin();
-
-        auto revertMoves = [&] {
-            ASSERT(!copy.m_history.empty());
-            ASSERT(currMove->performedMove == copy.m_history.back().performedMove);
-            copy.undoMove();
-            ++currMove;
-            ASSERT(!copy.m_history.empty());
-            ASSERT(currMove->performedMove == copy.m_history.back().performedMove);
-            copy.undoMove();
-            ++currMove;
-        };
-
-        revertMoves();
-        ASSERT(currMove != m_history.rend());
-
+        COUNT_HOT_PATH(RepetitionScans);
+        // the history holds the position before every move, so the position moveIndex plies ago is
+        // moveIndex entries from the back. Castling rights and en passant are part of the hash so
+        // those positions never match even though the half move clock was not reset.
         for (uint32_t moveIndex = 4; moveIndex <= maxMoves; moveIndex += 2) {
-            revertMoves();
-
-            if (copy.m_castlingRights != m_castlingRights || copy.m_enPassant.has_value()) {
-                // castling and en passant do not reset directly but do break repetition
-                break;
-            }
-
-            if (copy.m_pieces == m_pieces) {
-                return copy.m_repeated + 1;
+            const MoveData& earlier = m_history[m_history.size() - moveIndex];
+            if (earlier.previousHash == m_hash) {
+                COUNT_HOT_PATH_N(RepetitionScanDepth, moveIndex);
+                return earlier.timesRepeated + 1;
             }
         }
 
+        COUNT_HOT_PATH_N(RepetitionScanDepth, maxMoves & ~1u);
         return 0;
     }
 
@@ -494,6 +574,10 @@ namespace Chess {
         return colorPiecesBB[colorIndex(p.color())] & typePiecesBB[typeIndex(p.type())];
     }
 
+    BitBoard Board::pawnBitboard(Color color) const {
+        return typeBitboard(Piece::Type::Pawn) & colorBitboard(color);
+    }
+
     BitBoard Board::typeBitboards(Piece::Type tp1, Piece::Type tp2) const {
         return typeBitboard(tp1) | typeBitboard(tp2);
     }
@@ -513,6 +597,7 @@ namespace Chess {
     }
 
     BitBoard Board::attacksOn(BoardIndex square, BitBoard occupied) const {
+        COUNT_HOT_PATH(AttacksOnCalls);
         if (square >= size * size) {
             return 0;
         }
@@ -555,6 +640,28 @@ namespace Chess {
         return pinned;
     }
 
+    BitBoard Board::pinnedPieces() const {
+        Color us = colorToMove();
+        BoardIndex king = m_kingPos[colorIndex(us)];
+        if (king >= size * size) {
+            return 0;
+        }
+
+        BitBoard snipers =
+                ((BB::pieceAttacksBB<Piece::Type::Bishop>(king) & typeBitboards(Piece::Type::Bishop, Piece::Type::Queen))
+                 | (BB::pieceAttacksBB<Piece::Type::Rook>(king) & typeBitboards(Piece::Type::Rook, Piece::Type::Queen)))
+                & colorBitboard(opposite(us));
+
+        BitBoard pinned = 0;
+        while (snipers) {
+            BitBoard blockers = BB::between(king, BB::popLsb(snipers)) & piecesBB;
+            if (blockers && !BB::moreThanOne(blockers)) {
+                pinned |= blockers & colorBitboard(us);
+            }
+        }
+        return pinned;
+    }
+
     bool Board::isLegal(Move mv) const {
         using namespace BB;
 
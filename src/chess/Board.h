@@ -2,8 +2,11 @@
 
 #include "Types.h"
 #include "Move.h"
+#include "NNUE.h"
 #include "Piece.h"
+#include "PieceSquareTables.h"
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <deque>
 #include <iosfwd>
@@ -16,6 +19,9 @@
 
 namespace Chess {
     class MoveList;
+    enum class GenerationMode : uint8_t;
+    class SANList;
+    struct PackedBoard;
     struct ExpectedBoard;
 
     enum class CastlingRight : uint8_t {
@@ -36,10 +42,54 @@ namespace Chess {
     CastlingRight operator&(const CastlingRight& lhs, const CastlingRight& rhs);
     std::ostream& operator<<(std::ostream& strm, const CastlingRight& cr);
 
+    enum class FENError : uint8_t {
+        None = 0,
+        TooLong,
+        WrongFieldCount,
+        UnknownPiece,
+        InvalidBoardCharacter,
+        MissingRowSeparator,
+        TrailingRowSeparator,
+        BoardTooLong,
+        BoardTooShort,
+        ConsecutiveNumbers,
+        ZeroSkip,
+        SkipTooLarge,
+        InvalidTurn,
+        InvalidCastling,
+        CastlingPiecesMissing,
+        InvalidEnPassant,
+        EnPassantWrongRow,
+        EnPassantSquareOccupied,
+        EnPassantPawnMissing,
+        InvalidHalfMoves,
+        InvalidFullMoves,
+        TooManyFullMoves,
+    };
+
+    [[nodiscard]] std::string_view describeFENError(FENError error);
+
+    struct FENParseResult {
+        FENError error = FENError::None;
+        // byte offset in the input at which the error was detected
+        uint32_t offset = 0;
+
+        explicit operator bool() const {
+            return error == FENError::None;
+        }
+
+        // Only builds a string when called, so not needed for just checking validity
+        [[nodiscard]] std::string message() const;
+    };
+
     class Board {
     public:
         [[nodiscard]] static ExpectedBoard fromFEN(std::string_view);
 
+        // Replaces all state of this board (including history) without allocating.
+        // On failure the board is valid but its contents are unspecified.
+        [[nodiscard]] FENParseResult parseFEN(std::string_view);
+
         [[nodiscard]] static Board standardBoard();
 
         [[nodiscard]] static Board emptyBoard();
@@ -54,6 +104,8 @@ namespace Chess {
 
         [[nodiscard]] uint32_t countPieces(Color) const;
 
+        [[nodiscard]] uint32_t countPieces(Piece) const;
+
         [[nodiscard]] std::optional<Piece> pieceAt(std::string_view) const;
 
         [[nodiscard]] std::optional<Piece> pieceAt(BoardIndex column, BoardIndex row) const;
@@ -66,6 +118,21 @@ namespace Chess {
 
         [[nodiscard]] std::string toFEN() const;
 
+        // 71 board characters, 5 separators and the other fields at their longest
+        constexpr static size_t maxFENLength = 71 + 5 + 1 + 4 + 2 + 10 + 10;
+
+        // Writes the FEN without null terminator into out which must hold maxFENLength chars,
+        // returns the amount of characters written.
+        size_t toFEN(char* out) const;
+
+        // Fixed size binary form of the position (see PackedBoard), nullopt if there are more than
+        // 32 pieces or the half move clock does not fit in 16 bits.
+        [[nodiscard]] std::optional<PackedBoard> pack() const;
+
+        // Replaces all state of this board like parseFEN, returns false if the data is not a position
+        // parseFEN would accept. On failure the board is valid but its contents are unspecified.
+        [[nodiscard]] bool unpack(const PackedBoard&);
+
         [[nodiscard]] static std::string columnRowToSAN(BoardIndex column, BoardIndex row);
 
         [[nodiscard]] static std::optional<std::pair<BoardIndex, BoardIndex>> SANToColRow(std::string_view);
@@ -84,6 +151,42 @@ namespace Chess {
 
         [[nodiscard]] uint32_t halfMovesSinceIrreversible() const;
 
+        // Zobrist hash of the pieces, side to move, castling rights and en passant square but not the
+        // clocks, kept up to date by every change to the board.
+        [[nodiscard]] uint64_t hash() const {
+            return m_hash;
+        }
+
+        // Zobrist hash of only the pawns (with the same keys as hash), so it changes only when a pawn
+        // moves, is captured or promotes. Keys the pawn structure evaluation (see PawnHashTable).
+        [[nodiscard]] uint64_t pawnHash() const {
+            return m_pawnHash;
+        }
+
+        [[nodiscard]] BitBoard pawnBitboard(Color color) const;
+
+        // Material plus piece square table score of all pieces from the point of view of white, kept
+        // up to date by every change to the board like the hash
+        [[nodiscard]] PST::TaperedScore pieceSquareScore() const {
+            return m_pieceSquareScore;
+        }
+
+        // Sum of the phase values of all pieces (see PST::maxPhase), kept up to date as well
+        [[nodiscard]] int32_t gamePhase() const {
+            return m_phase;
+        }
+
+        // From now on the accumulator of network is kept up to date on every change, nullptr stops
+        // that. The network must outlive the board and all its copies.
+        void setNetwork(const NNUE::Network* network);
+
+        [[nodiscard]] const NNUE::Network* network() const {
+            return m_network.network();
+        }
+
+        // Only with a network, a side left stale by a king move is refreshed first
+        [[nodiscard]] const NNUE::Accumulator& accumulator() const;
+
         // technically board specific chess constants
         constexpr static BoardIndex homeRow(Color color) {
             return color == Color::White ? 0 : 7;
@@ -115,6 +218,10 @@ namespace Chess {
 
         [[nodiscard]] std::string moveToSAN(Move mv) const;
 
+        // SAN of every move in the list in one pass, check ('+') and mate ('#') suffixes are only
+        // added if requested since moveToSAN and parseSANMove do not use them.
+        [[nodiscard]] SANList movesToSAN(const MoveList&, bool withCheckSuffix = false) const;
+
         [[nodiscard]] std::optional<Move> parseSANMove(std::string_view, const MoveList&) const;
 
         [[nodiscard]] std::optional<Move> parseSANMove(std::string_view) const;
@@ -145,11 +252,25 @@ namespace Chess {
 
         [[nodiscard]] bool attacked(BoardIndex col, BoardIndex row) const;
 
+        // Static exchange evaluation in centipawns (see pieceValues): the material won by the side to
+        // move when mv starts a sequence of captures on its destination. Both sides capture with their
+        // least valuable piece, sliders behind a capturer join in and either side may stop capturing.
+        // Pins and checks are ignored, except that a king only captures a square nothing defends.
+        [[nodiscard]] int32_t see(Move mv) const;
+
+        // see(mv) >= threshold, but stops as soon as the outcome is known
+        [[nodiscard]] bool seeGE(Move mv, int32_t threshold) const;
+
         // TODO: isPseudoLegal
     private:
-        std::optional<std::string> parseFENBoard(std::string_view);
+        FENParseResult parseFENBoard(std::string_view fen, uint32_t& position);
+
+        FENParseResult setAvailableCastles(std::string_view vw, uint32_t offset);
 
-        std::optional<std::string> setAvailableCastles(std::string_view vw);
+        // King and rook are on their home squares for every castling right
+        [[nodiscard]] bool castlingPiecesPresent() const;
+
+        void clearForParsing();
 
         [[nodiscard]] std::optional<Piece> pieceAt(BoardIndex index) const;
 
@@ -163,8 +284,28 @@ namespace Chess {
 
         [[nodiscard]] static std::optional<BoardIndex> SANToIndex(std::string_view);
 
+        // sameDestination has all squares from which a legal move to the destination of mv starts
+        size_t writeSAN(char* out, Move mv, BitBoard sameDestination) const;
+
         [[nodiscard]] uint32_t findRepetitions() const;
 
+        // Hash of everything but the pieces and side to move, which setPiece and makeMove update
+        [[nodiscard]] uint64_t castlingEnPassantHash() const;
+
+        // From scratch, for after changing castling rights or en passant directly
+        [[nodiscard]] uint64_t computeHash() const;
+
+        // From scratch, only to check the incremental updates
+        [[nodiscard]] uint64_t computePawnHash() const;
+
+        // From scratch, only to check the incremental updates
+        [[nodiscard]] PST::TaperedScore computePieceSquareScore() const;
+        [[nodiscard]] int32_t computeGamePhase() const;
+
+        // Adds or removes the network input of piece on index for both sides, a king instead makes
+        // its side stale
+        void updateAccumulator(Piece piece, BoardIndex index, bool add);
+
         [[nodiscard]] bool attacked(BoardIndex index) const;
 
         std::array<Piece::IntType, size * size> m_pieces;
@@ -178,6 +319,14 @@ namespace Chess {
 
         uint32_t m_repeated = 0;
 
+        uint64_t m_hash = 0;
+        uint64_t m_pawnHash = 0;
+        PST::TaperedScore m_pieceSquareScore{};
+        int32_t m_phase = 0;
+
+        // stale sides are refreshed when read
+        NNUE::BoardNetwork m_network;
+
         struct MoveData {
             Move performedMove;
             std::optional<Piece> capturedPiece;
@@ -185,6 +334,7 @@ namespace Chess {
             CastlingRight previousCastlingRights = CastlingRight::NoCastling;
             uint32_t previousSinceCapture;
             uint32_t timesRepeated;
+            uint64_t previousHash;
 
             MoveData(const Board& board, Move move);
 
@@ -206,7 +356,7 @@ namespace Chess {
         // TODO: simplify the friend structure here
         friend struct Move;
         friend class MoveList;
-        friend MoveList generateAllMoves(const Board& board);
+        friend MoveList generateMoves(const Board& board, GenerationMode mode);
         friend bool validateMove(MoveList& list, const Board&, Move);
 
         BitBoard piecesBB = 0u;
@@ -226,6 +376,19 @@ namespace Chess {
         [[nodiscard]] BitBoard typeBitboards(Piece::Type tp1, Piece::Type tp2) const;
 
         [[nodiscard]] bool isPinned(BoardIndex square) const;
+
+        // Least valuable piece of color in attackers, which is removed from occupied
+        [[nodiscard]] std::optional<Piece::Type> popLeastValuable(BitBoard attackers, Color color, BitBoard& occupied) const;
+
+        // Material won by the first capture of mv, sets occupied to the pieces left and onSquare to the
+        // value of the piece standing on the destination afterwards
+        [[nodiscard]] int32_t startExchange(Move mv, BitBoard& occupied, int32_t& onSquare) const;
+
+        // Sliders attacking square through the square of a just removed piece of type removed
+        [[nodiscard]] BitBoard revealedAttackers(BoardIndex square, BitBoard occupied, Piece::Type removed) const;
+
+        // Pieces of the side to move which are the only piece between its king and an opposing slider
+        [[nodiscard]] BitBoard pinnedPieces() const;
     };
 
     struct ExpectedBoard {
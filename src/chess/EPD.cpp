@@ -0,0 +1,426 @@
+#include "EPD.h"
+#include "../util/Assertions.h"
+#include "../util/StringUtil.h"
+#include "MoveGen.h"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <ostream>
+#include <sstream>
+#include <thread>
+
+namespace Chess {
+
+    constexpr static uint32_t fenFieldCount = 6;
+    constexpr static uint32_t epdPositionFields = 4;
+
+    constexpr static util::CharSet blanks{" \t"};
+
+    static bool isBlank(char c) {
+        return blanks.contains(c);
+    }
+
+    static bool isDigit(char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    static bool isLetter(char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+    }
+
+    static std::string_view trim(std::string_view sv) {
+        while (!sv.empty() && (isBlank(sv.front()) || sv.front() == '\r')) {
+            sv.remove_prefix(1);
+        }
+        while (!sv.empty() && (isBlank(sv.back()) || sv.back() == '\r')) {
+            sv.remove_suffix(1);
+        }
+        return sv;
+    }
+
+    static bool isNumber(std::string_view sv) {
+        return !sv.empty() && std::all_of(sv.begin(), sv.end(), isDigit);
+    }
+
+    EPDOpcode parseEPDOpcode(std::string_view opcode) {
+        if (opcode == "bm") {
+            return EPDOpcode::BestMove;
+        } else if (opcode == "am") {
+            return EPDOpcode::AvoidMove;
+        } else if (opcode == "id") {
+            return EPDOpcode::Id;
+        } else if (opcode == "ce") {
+            return EPDOpcode::CentipawnEvaluation;
+        } else if (opcode == "hmvc") {
+            return EPDOpcode::HalfMoveClock;
+        } else if (opcode == "fmvn") {
+            return EPDOpcode::FullMoveNumber;
+        } else if (opcode.size() == 2 && opcode[0] == 'c' && isDigit(opcode[1])) {
+            return EPDOpcode::Comment;
+        } else if (opcode.size() >= 2 && opcode[0] == 'D' && isNumber(opcode.substr(1)) && opcode[1] != '0') {
+            return EPDOpcode::PerftCount;
+        }
+        return EPDOpcode::Unknown;
+    }
+
+    std::optional<uint32_t> EPDOperation::opcodeNumber() const {
+        if (code != EPDOpcode::Comment && code != EPDOpcode::PerftCount) {
+            return std::nullopt;
+        }
+        uint32_t number = 0;
+        if (auto [ptr, ec] = std::from_chars(opcode.data() + 1, opcode.data() + opcode.size(), number);
+            ec != std::errc() || ptr != opcode.data() + opcode.size()) {
+            return std::nullopt;
+        }
+        return number;
+    }
+
+    std::string_view EPDOperation::unquoted() const {
+        if (operands.size() >= 2 && operands.front() == '"' && operands.back() == '"'
+            && operands.find('"', 1) == operands.size() - 1) {
+            return operands.substr(1, operands.size() - 2);
+        }
+        return operands;
+    }
+
+    void EPDOperation::forEachOperand(const std::function<void(std::string_view)>& func) const {
+        size_t position = 0;
+        while (position < operands.size()) {
+            if (isBlank(operands[position])) {
+                ++position;
+                continue;
+            }
+            if (operands[position] == '"') {
+                size_t end = std::min(operands.find('"', position + 1), operands.size());
+                func(operands.substr(position + 1, end - position - 1));
+                position = end + 1;
+                continue;
+            }
+            size_t start = position;
+            while (position < operands.size() && !isBlank(operands[position])) {
+                ++position;
+            }
+            func(operands.substr(start, position - start));
+        }
+    }
+
+    std::string_view describeEPDError(EPDError error) {
+        switch (error) {
+            case EPDError::None:
+                return "No error";
+            case EPDError::MissingFields:
+                return "Must start with 4 FEN fields";
+            case EPDError::InvalidPosition:
+                return "Invalid position";
+            case EPDError::InvalidOpcode:
+                return "Opcode must start with a letter and only contain letters, digits and '_'";
+            case EPDError::MissingSemicolon:
+                return "Operation must end with ';'";
+            case EPDError::UnterminatedString:
+                return "String operand is missing closing '\"'";
+        }
+        return "Unknown error";
+    }
+
+    std::string EPDParseResult::message() const {
+        std::string result = std::string(describeEPDError(error)) + " at offset " + std::to_string(offset);
+        if (error == EPDError::InvalidPosition) {
+            result += " (" + fenResult.message() + ")";
+        }
+        return result;
+    }
+
+    const EPDOperation* EPDRecord::find(std::string_view opcode) const {
+        auto it = std::find_if(operations.begin(), operations.end(), [opcode](const EPDOperation& op) {
+            return op.opcode == opcode;
+        });
+        return it == operations.end() ? nullptr : &*it;
+    }
+
+    std::optional<std::vector<Move>> EPDRecord::moves(std::string_view opcode) const {
+        const EPDOperation* op = find(opcode);
+        if (op == nullptr) {
+            return std::nullopt;
+        }
+        std::vector<Move> result;
+        bool valid = true;
+        op->forEachOperand([&](std::string_view san) {
+            if (auto move = board.parseSANMove(san); move.has_value()) {
+                result.push_back(*move);
+            } else {
+                valid = false;
+            }
+        });
+        if (!valid) {
+            return std::nullopt;
+        }
+        return result;
+    }
+
+    EPDParseResult parseEPD(std::string_view line, EPDRecord& record) {
+        record.operations.clear();
+        while (!line.empty() && (line.back() == '\r' || line.back() == '\n')) {
+            line.remove_suffix(1);
+        }
+
+        // The FEN is built from the position fields and the hmvc and fmvn operations, the offsets
+        // of every field are kept to map a FEN error back to the line.
+        std::array<std::string_view, fenFieldCount> fields{};
+        std::array<uint32_t, fenFieldCount> lineOffsets{};
+        util::Tokenizer positionFields(line, blanks);
+        for (uint32_t field = 0; field < epdPositionFields; ++field) {
+            auto token = positionFields.next();
+            if (!token.has_value()) {
+                return {EPDError::MissingFields, static_cast<uint32_t>(line.size())};
+            }
+            fields[field] = *token;
+            lineOffsets[field] = static_cast<uint32_t>(token->data() - line.data());
+        }
+        size_t position = positionFields.position();
+        // the default clock fields are not in the line, errors in those are reported at the end of the position
+        fields[4] = "0";
+        fields[5] = "1";
+        lineOffsets[4] = lineOffsets[5] = static_cast<uint32_t>(position);
+        std::array<bool, fenFieldCount> inLine{true, true, true, true, false, false};
+
+        while (true) {
+            while (position < line.size() && isBlank(line[position])) {
+                ++position;
+            }
+            if (position >= line.size()) {
+                break;
+            }
+
+            size_t opcodeStart = position;
+            if (!isLetter(line[position])) {
+                return {EPDError::InvalidOpcode, static_cast<uint32_t>(position)};
+            }
+            while (position < line.size() && (isLetter(line[position]) || isDigit(line[position]) || line[position] == '_')) {
+                ++position;
+            }
+            if (position < line.size() && !isBlank(line[position]) && line[position] != ';') {
+                return {EPDError::InvalidOpcode, static_cast<uint32_t>(position)};
+            }
+            std::string_view opcode = line.substr(opcodeStart, position - opcodeStart);
+
+            size_t operandStart = position;
+            bool inString = false;
+            while (position < line.size() && (inString || line[position] != ';')) {
+                if (line[position] == '"') {
+                    inString = !inString;
+                }
+                ++position;
+            }
+            if (inString) {
+                return {EPDError::UnterminatedString, static_cast<uint32_t>(opcodeStart)};
+            }
+            if (position >= line.size()) {
+                return {EPDError::MissingSemicolon, static_cast<uint32_t>(position)};
+            }
+
+            EPDOperation& op = record.operations.emplace_back();
+            op.code = parseEPDOpcode(opcode);
+            op.opcode = opcode;
+            op.operands = trim(line.substr(operandStart, position - operandStart));
+            ++position;
+
+            if (op.code == EPDOpcode::HalfMoveClock || op.code == EPDOpcode::FullMoveNumber) {
+                size_t field = op.code == EPDOpcode::HalfMoveClock ? 4 : 5;
+                fields[field] = op.operands;
+                lineOffsets[field] = static_cast<uint32_t>(op.operands.data() - line.data());
+                inLine[field] = true;
+            }
+        }
+
+        std::array<char, Board::maxFENLength> fen{};
+        std::array<uint32_t, fenFieldCount> fenFieldStart{};
+        size_t length = 0;
+        for (uint32_t field = 0; field < fenFieldCount; ++field) {
+            if (length + fields[field].size() + (field > 0 ? 1 : 0) > fen.size()) {
+                return {EPDError::InvalidPosition, 0, {FENError::TooLong, static_cast<uint32_t>(length)}};
+            }
+            if (field > 0) {
+                fen[length++] = ' ';
+            }
+            fenFieldStart[field] = static_cast<uint32_t>(length);
+            std::memcpy(fen.data() + length, fields[field].data(), fields[field].size());
+            length += fields[field].size();
+        }
+
+        FENParseResult fenResult = record.board.parseFEN(std::string_view(fen.data(), length));
+        if (!fenResult) {
+            uint32_t field = fenFieldCount - 1;
+            while (field > 0 && fenResult.offset < fenFieldStart[field]) {
+                --field;
+            }
+            uint32_t offset = lineOffsets[field] + (inLine[field] ? fenResult.offset - fenFieldStart[field] : 0);
+            return {EPDError::InvalidPosition, offset, fenResult};
+        }
+        return {};
+    }
+
+    static void writeOperation(std::ostream& out, std::string_view opcode, std::string_view operands) {
+        out << ' ' << opcode;
+        if (!operands.empty()) {
+            out << ' ' << operands;
+        }
+        out << ';';
+    }
+
+    void writeEPD(std::ostream& out, const EPDRecord& record, const std::vector<EPDAnnotation>& annotations) {
+        std::array<char, Board::maxFENLength> fen{};
+        std::string_view fenView(fen.data(), record.board.toFEN(fen.data()));
+        size_t end = 0;
+        for (uint32_t field = 0; field < epdPositionFields; ++field) {
+            end = fenView.find(' ', end + 1);
+        }
+        ASSERT(end != std::string_view::npos);
+        out << fenView.substr(0, end);
+
+        for (const EPDOperation& op : record.operations) {
+            auto replacement = std::find_if(annotations.begin(), annotations.end(), [&op](const EPDAnnotation& annotation) {
+                return annotation.opcode == op.opcode;
+            });
+            if (replacement == annotations.end()) {
+                writeOperation(out, op.opcode, op.operands);
+            } else {
+                writeOperation(out, replacement->opcode, replacement->operands);
+            }
+        }
+        for (const EPDAnnotation& annotation : annotations) {
+            if (record.find(annotation.opcode) == nullptr) {
+                writeOperation(out, annotation.opcode, annotation.operands);
+            }
+        }
+    }
+
+    EPDOperationFunc countLegalMoves() {
+        return [](const EPDRecord& record, std::vector<EPDAnnotation>& annotations) {
+            annotations.push_back({"D1", std::to_string(generateAllMoves(record.board).size())});
+            return true;
+        };
+    }
+
+    // Counts the leaf nodes of every depth up to counts.size() in a single walk of the tree
+    static void perftCounts(const Board& board, size_t ply, std::vector<uint64_t>& counts) {
+        MoveList moves = generateAllMoves(board);
+        counts[ply] += moves.size();
+        if (ply + 1 >= counts.size()) {
+            return;
+        }
+        moves.forEachMove([&](Move move) {
+            board.moveExcursion(move, [&](const Board& next) {
+                perftCounts(next, ply + 1, counts);
+            });
+        });
+    }
+
+    EPDOperationFunc checkPerft(uint32_t maxDepth) {
+        return [maxDepth](const EPDRecord& record, std::vector<EPDAnnotation>& annotations) {
+            uint32_t depth = 0;
+            for (const EPDOperation& op : record.operations) {
+                if (auto n = op.opcodeNumber(); op.code == EPDOpcode::PerftCount && n.has_value() && *n <= maxDepth) {
+                    depth = std::max(depth, *n);
+                }
+            }
+            if (depth == 0) {
+                return true;
+            }
+
+            std::vector<uint64_t> counts(depth, 0);
+            perftCounts(record.board, 0, counts);
+
+            std::string mismatches;
+            for (const EPDOperation& op : record.operations) {
+                auto n = op.opcodeNumber();
+                if (op.code != EPDOpcode::PerftCount || !n.has_value() || *n > maxDepth) {
+                    continue;
+                }
+                uint64_t expected = 0;
+                auto [ptr, ec] = std::from_chars(op.operands.data(), op.operands.data() + op.operands.size(), expected);
+                uint64_t actual = counts[*n - 1];
+                if (ec == std::errc() && ptr == op.operands.data() + op.operands.size() && expected == actual) {
+                    continue;
+                }
+                if (!mismatches.empty()) {
+                    mismatches += ", ";
+                }
+                mismatches += std::string(op.opcode) + " is " + std::to_string(actual) + " not " + std::string(op.operands);
+            }
+            if (mismatches.empty()) {
+                return true;
+            }
+            annotations.push_back({"c9", '"' + mismatches + '"'});
+            return false;
+        };
+    }
+
+    static EPDBatchStats processEPDPart(std::string_view input, const EPDOperationFunc& operation, std::ostream& out) {
+        EPDBatchStats stats;
+        EPDRecord record;
+        std::vector<EPDAnnotation> annotations;
+        for (std::string_view line : util::LineScanner(input)) {
+            if (trim(line).empty()) {
+                continue;
+            }
+
+            ++stats.records;
+            if (!parseEPD(line, record)) {
+                ++stats.invalid;
+                out << line << '\n';
+                continue;
+            }
+
+            annotations.clear();
+            if (!operation(record, annotations)) {
+                ++stats.failed;
+            }
+            writeEPD(out, record, annotations);
+            out << '\n';
+        }
+        return stats;
+    }
+
+    EPDBatchStats processEPD(std::string_view input, size_t threads, const EPDOperationFunc& operation, std::ostream& out) {
+        ASSERT(threads > 0);
+        std::vector<std::string_view> parts;
+        size_t start = 0;
+        for (size_t i = 1; i <= threads && start < input.size(); ++i) {
+            size_t end = input.size();
+            if (i < threads) {
+                end = input.find('\n', std::max(start, input.size() / threads * i));
+                end = end == std::string_view::npos ? input.size() : end + 1;
+            }
+            parts.push_back(input.substr(start, end - start));
+            start = end;
+        }
+
+        if (parts.size() <= 1) {
+            return processEPDPart(input, operation, out);
+        }
+
+        std::vector<std::ostringstream> outputs(parts.size());
+        std::vector<EPDBatchStats> partStats(parts.size());
+        std::vector<std::thread> workers;
+        workers.reserve(parts.size());
+        for (size_t i = 0; i < parts.size(); ++i) {
+            workers.emplace_back([&, i] {
+                partStats[i] = processEPDPart(parts[i], operation, outputs[i]);
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        EPDBatchStats total;
+        for (size_t i = 0; i < parts.size(); ++i) {
+            out << outputs[i].view();
+            total.records += partStats[i].records;
+            total.invalid += partStats[i].invalid;
+            total.failed += partStats[i].failed;
+        }
+        return total;
+    }
+
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "Board.h"
+#include "Move.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Chess {
+
+    // Extended Position Description: the first 4 FEN fields followed by operations like
+    //   rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - id "start"; D1 20; D2 400;
+    // Every operation is an opcode with zero or more operands and ends with ';'.
+
+    enum class EPDOpcode : uint8_t {
+        Unknown = 0,
+        BestMove,           // bm, SAN moves
+        AvoidMove,          // am, SAN moves
+        Id,                 // id, string
+        Comment,            // c0 to c9, string
+        PerftCount,         // D1 to Dn, amount of leaf nodes at depth n
+        CentipawnEvaluation,// ce, from the side to move
+        HalfMoveClock,      // hmvc
+        FullMoveNumber,     // fmvn
+    };
+
+    [[nodiscard]] EPDOpcode parseEPDOpcode(std::string_view opcode);
+
+    struct EPDOperation {
+        EPDOpcode code = EPDOpcode::Unknown;
+        // as written, so the depth of D<n> and number of c<n> can be found
+        std::string_view opcode;
+        // everything up to the ';' without surrounding spaces, quotes are kept
+        std::string_view operands;
+
+        // The n of D<n> or c<n>
+        [[nodiscard]] std::optional<uint32_t> opcodeNumber() const;
+
+        // Operands with the quotes removed if it is a single string
+        [[nodiscard]] std::string_view unquoted() const;
+
+        // Calls func with each space separated operand, a quoted string is a single operand
+        // (without the quotes)
+        void forEachOperand(const std::function<void(std::string_view)>& func) const;
+    };
+
+    enum class EPDError : uint8_t {
+        None = 0,
+        MissingFields,
+        InvalidPosition,
+        InvalidOpcode,
+        MissingSemicolon,
+        UnterminatedString,
+    };
+
+    [[nodiscard]] std::string_view describeEPDError(EPDError error);
+
+    struct EPDParseResult {
+        EPDError error = EPDError::None;
+        // byte offset in the line at which the error was detected
+        uint32_t offset = 0;
+        // set when error is InvalidPosition
+        FENParseResult fenResult{};
+
+        explicit operator bool() const {
+            return error == EPDError::None;
+        }
+
+        [[nodiscard]] std::string message() const;
+    };
+
+    // One parsed line, the operations are views into the line. The vector is reused when parsing
+    // into the same record so parsing many lines does not allocate for every line.
+    struct EPDRecord {
+        Board board = Board::emptyBoard();
+        std::vector<EPDOperation> operations;
+
+        [[nodiscard]] const EPDOperation* find(std::string_view opcode) const;
+
+        // Moves of a bm or am operation, nullopt if the operation is missing or a move is invalid
+        [[nodiscard]] std::optional<std::vector<Move>> moves(std::string_view opcode) const;
+    };
+
+    // The half move clock and full move number come from the hmvc and fmvn operations if present
+    [[nodiscard]] EPDParseResult parseEPD(std::string_view line, EPDRecord& record);
+
+    // An operation added (or replaced if the opcode exists) when writing a record
+    struct EPDAnnotation {
+        std::string opcode;
+        std::string operands;
+    };
+
+    // Writes the position as 4 FEN fields and all operations, annotations replace operations with
+    // the same opcode in place and the others are added at the end. Does not write a newline.
+    void writeEPD(std::ostream& out, const EPDRecord& record, const std::vector<EPDAnnotation>& annotations = {});
+
+    // Called for every valid record, may add annotations and returns false if the record fails the
+    // check. Is called concurrently from multiple threads.
+    using EPDOperationFunc = std::function<bool(const EPDRecord&, std::vector<EPDAnnotation>&)>;
+
+    // Annotates D1 with the amount of legal moves
+    [[nodiscard]] EPDOperationFunc countLegalMoves();
+
+    // Verifies every D<n> operation up to maxDepth with perft, a mismatch is annotated as c9 comment
+    [[nodiscard]] EPDOperationFunc checkPerft(uint32_t maxDepth);
+
+    struct EPDBatchStats {
+        size_t records = 0;
+        size_t invalid = 0;
+        size_t failed = 0;
+    };
+
+    // Parses every line, applies the operation on threads and writes the annotated records in input
+    // order. Invalid lines are written unchanged, empty lines are skipped.
+    EPDBatchStats processEPD(std::string_view input, size_t threads, const EPDOperationFunc& operation, std::ostream& out);
+
+}
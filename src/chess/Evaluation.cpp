@@ -0,0 +1,24 @@
+#include "Evaluation.h"
+
+namespace Chess {
+
+    static Score forSideToMove(const Board& board, PST::TaperedScore white) {
+        Score score = taperedScore(white, board.gamePhase());
+        return board.colorToMove() == Color::White ? score : -score;
+    }
+
+    Score evaluate(const Board& board) {
+        if (const NNUE::Network* network = board.network(); network != nullptr) {
+            return network->evaluate(board.accumulator(), board.colorToMove());
+        }
+        return forSideToMove(board, board.pieceSquareScore() + pawnScore(board));
+    }
+
+    Score evaluate(const Board& board, PawnHashTable& pawns) {
+        if (const NNUE::Network* network = board.network(); network != nullptr) {
+            return network->evaluate(board.accumulator(), board.colorToMove());
+        }
+        return forSideToMove(board, board.pieceSquareScore() + pawns.probe(board));
+    }
+
+}
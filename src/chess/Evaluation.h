@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Board.h"
+#include "PawnStructure.h"
+#include "Piece.h"
+#include "PieceSquareTables.h"
+#include <array>
+#include <cstdint>
+
+namespace Chess {
+
+    // Scores are in centipawns
+    using Score = int32_t;
+
+    // Indexed by the Piece::Type value, kings are never traded so have no material value. Only for
+    // exchanges and move ordering, the evaluation has its own (tapered) values in PST::tables.
+    constexpr std::array<Score, 7> pieceValues = {0, 100, 0, 330, 500, 900, 320};
+
+    [[nodiscard]] constexpr Score pieceValue(Piece::Type type) {
+        return pieceValues[static_cast<size_t>(type)];
+    }
+
+    // Static evaluation from the point of view of the side to move: material, piece square tables and
+    // pawn structure (see pawnScore) blended from the middle game to the end game score as the game
+    // phase drops. Board keeps the tables and phase up to date on every move, the pawn structure is
+    // computed from the pawn bitboards. With a network set on the board (Board::setNetwork) that
+    // network evaluates instead.
+    [[nodiscard]] Score evaluate(const Board& board);
+
+    // The same evaluation taking the pawn structure from pawns, which is what the search uses
+    [[nodiscard]] Score evaluate(const Board& board, PawnHashTable& pawns);
+
+    // At PST::maxPhase (or above) only the middle game score counts, at 0 only the end game score
+    [[nodiscard]] constexpr Score taperedScore(PST::TaperedScore score, int32_t phase) {
+        phase = phase < PST::maxPhase ? phase : PST::maxPhase;
+        return (score.middleGame * phase + score.endGame * (PST::maxPhase - phase)) / PST::maxPhase;
+    }
+
+}
@@ -7,15 +7,17 @@
 #include <array>
 #include <charconv>
 #include <cstdint>
-#include <cctype>
 #include <iterator>
 #include <limits>
 #include <optional>
-#include <sstream>
+#include <ostream>
 #include <string>
 #include <string_view>
 #include <system_error>
-#include <vector>
+
+#ifdef OUTPUT_FEN
+#include <iostream>
+#endif
 
 
 namespace Chess {
@@ -72,9 +74,63 @@ namespace Chess {
     }
 
 
-    std::optional<std::string> Board::setAvailableCastles(std::string_view vw) {
+    std::string_view describeFENError(FENError error) {
+        switch (error) {
+            case FENError::None:
+                return "No error";
+            case FENError::TooLong:
+                return "Longer than any valid FEN";
+            case FENError::WrongFieldCount:
+                return "Must have exactly 6 fields separated by a single space";
+            case FENError::UnknownPiece:
+                return "Unknown piece type";
+            case FENError::InvalidBoardCharacter:
+                return "Invalid character in board";
+            case FENError::MissingRowSeparator:
+                return "Must have '/' as row separators";
+            case FENError::TrailingRowSeparator:
+                return "Must not have trailing '/'";
+            case FENError::BoardTooLong:
+                return "Board is too long already data for _64_ squares";
+            case FENError::BoardTooShort:
+                return "Not enough data to fill board";
+            case FENError::ConsecutiveNumbers:
+                return "Multiple consecutive numbers is not allowed";
+            case FENError::ZeroSkip:
+                return "Skipping 0 is not allowed";
+            case FENError::SkipTooLarge:
+                return "Skipping more than the rest of the row";
+            case FENError::InvalidTurn:
+                return "Invalid turn value";
+            case FENError::InvalidCastling:
+                return "Invalid possible castling moves value";
+            case FENError::CastlingPiecesMissing:
+                return "Castling but pieces not present";
+            case FENError::InvalidEnPassant:
+                return "Invalid en passant value";
+            case FENError::EnPassantWrongRow:
+                return "Cannot have en passant on non 3th or 5th row";
+            case FENError::EnPassantSquareOccupied:
+                return "En passant square cannot have a piece at square";
+            case FENError::EnPassantPawnMissing:
+                return "En passant square must be just behind previously moved pawn";
+            case FENError::InvalidHalfMoves:
+                return "Invalid half moves since capture";
+            case FENError::InvalidFullMoves:
+                return "Invalid full moves made";
+            case FENError::TooManyFullMoves:
+                return "Too many full moves";
+        }
+        return "Unknown error";
+    }
+
+    std::string FENParseResult::message() const {
+        return std::string(describeFENError(error)) + " at offset " + std::to_string(offset);
+    }
+
+    FENParseResult Board::setAvailableCastles(std::string_view vw, uint32_t offset) {
         if (vw.empty() || vw.size() > 4) {
-            return "Too many or few characters";
+            return {FENError::InvalidCastling, offset};
         }
         if (vw == "-") {
             return {};
@@ -84,98 +140,97 @@ namespace Chess {
 
         auto front = castleMapping.begin();
 
-        for (const auto& c : vw) {
-            if (auto foundMapping = std::find_if(front, castleMapping.end(), [&](CastleMap mapping) {
+        for (size_t i = 0; i < vw.size(); ++i) {
+            if (auto foundMapping = std::find_if(front, castleMapping.end(), [c = vw[i]](CastleMap mapping) {
                   return mapping.c == c;
                 });
                 foundMapping == castleMapping.end()) {
-                return std::string("Unknown character: ") + c;
+                return {FENError::InvalidCastling, static_cast<uint32_t>(offset + i)};
             } else {
                 m_castlingRights |= foundMapping->right;
                 front = std::next(foundMapping);
             }
         }
 
-        if (std::any_of(castleChecks.cbegin(), castleChecks.cend(), [&](const CastleCheck& check) {
-          if ((m_castlingRights & check.right) != CastlingRight::NoCastling) {
-              if (pieceAt(check.col, homeRow(check.piece.color())) != check.piece) {
-                  return true;
-              }
-          }
-          return false;
-        })) {
-            return std::string("Castling but pieces not present: ") + std::string(vw);
+        if (!castlingPiecesPresent()) {
+            return {FENError::CastlingPiecesMissing, offset};
         }
         return {};
     }
 
+    bool Board::castlingPiecesPresent() const {
+        return std::none_of(castleChecks.cbegin(), castleChecks.cend(), [&](const CastleCheck& check) {
+            return (m_castlingRights & check.right) != CastlingRight::NoCastling
+                && pieceAt(check.col, homeRow(check.piece.color())) != check.piece;
+        });
+    }
+
+    constexpr bool isFENLetter(char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+    }
 
-    std::optional<std::string> Board::parseFENBoard(std::string_view view) {
-        auto next = view.begin();
+    constexpr bool isFENDigit(char c) {
+        return c >= '0' && c <= '9';
+    }
 
+    FENParseResult Board::parseFENBoard(std::string_view fen, uint32_t& position) {
         uint32_t row = 7;
         uint32_t col = 0;
         bool lastWasNum = false;
 
-        while (next != view.end() && row <= 7) {
+        for (; position < fen.size() && fen[position] != ' '; ++position) {
             ASSERT(col <= 8);
             ASSERT(row <= 7);
+            char c = fen[position];
             if (col == 8) {
                 if (row == 0) {
-                    if (*next == '/') {
-                        return "Must not have trailing '/'";
+                    if (c == '/') {
+                        return {FENError::TrailingRowSeparator, position};
                     }
-                    return "Board is too long already data for _64_ squares";
+                    return {FENError::BoardTooLong, position};
                 }
-                if (*next != '/') {
-                    return "Must have '/' as row separators";
+                if (c != '/') {
+                    return {FENError::MissingRowSeparator, position};
                 }
 
-                ++next;
                 --row;
                 col = 0;
                 lastWasNum = false;
-                // just in case it was the final char
                 continue;
             }
-            if (std::isalpha(*next)) {
-                auto piece = Piece::fromFEN(*next);
+            if (isFENLetter(c)) {
+                auto piece = Piece::fromFEN(c);
                 if (!piece) {
-                    return "Unknown piece type'" + std::string(1, *next) + "'";
+                    return {FENError::UnknownPiece, position};
                 }
-                setPiece(col, row, *piece);
+                setPiece(columnRowToIndex(col, row), *piece);
                 ++col;
                 lastWasNum = false;
             } else {
-                if (!std::isdigit(*next)) {
-                    return "Invalid character '" + std::string(1, *next) + "'";
+                if (!isFENDigit(c)) {
+                    return {FENError::InvalidBoardCharacter, position};
                 }
                 if (lastWasNum) {
-                    return "Multiple consecutive numbers is not allowed";
+                    return {FENError::ConsecutiveNumbers, position};
                 }
-                uint32_t val = *next - '0';
+                uint32_t val = c - '0';
                 if (val == 0) {
-                    return "Skipping 0 is not allowed";
+                    return {FENError::ZeroSkip, position};
                 }
-                if (val > size || val > (size - col)) {
-                    return "Skipping more than a full row or the current row _" + std::to_string(val) + "_";
+                if (val > (size - col)) {
+                    return {FENError::SkipTooLarge, position};
                 }
                 col += val;
 
                 lastWasNum = true;
             }
-
-            ++next;
         }
 
-
         if (row > 0 || col != 8) {
-            return "Not enough data to fill board only reached row: "
-                   + std::to_string(row) + " col: " + std::to_string(col);
+            return {FENError::BoardTooShort, position};
         }
 
-        // remember nullopt means no error here...
-        return std::nullopt;
+        return {};
     }
 
     char turnColor(Color color) {
@@ -215,110 +270,202 @@ namespace Chess {
         return std::nullopt;
     }
 
+    void Board::clearForParsing() {
+        m_pieces.fill(Piece::noneValue());
+        piecesBB = 0u;
+        colorPiecesBB = {};
+        typePiecesBB = {};
+#ifdef STORE_KING_POS
+        m_kingPos = {invalidVal, invalidVal};
+#endif
 
-    ExpectedBoard Board::fromFEN(std::string_view str) {
+        m_nextTurnColor = Color::White;
+        m_castlingRights = CastlingRight::NoCastling;
+        m_enPassant = std::nullopt;
+        m_halfMovesMade = 0;
+        m_halfMovesSinceCaptureOrPawn = 0;
+        m_repeated = 0;
+        m_hash = 0;
+        m_pawnHash = 0;
+        m_pieceSquareScore = {};
+        m_phase = 0;
+        m_network.markStale();
+
+        // keeps (some) of the memory around so reusing a board does not allocate
+        m_history.clear();
+    }
+
+    FENParseResult Board::parseFEN(std::string_view fen) {
 #ifdef OUTPUT_FEN
-        std::cout << str << '\n';
+        std::cout << fen << '\n';
 #endif
-        Board b{};
-
         //rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1
 
-        std::vector<std::string_view> parts = util::split(str, " ");
-        if (parts.size() != 6) {
-            return "Not enough pieces in FEN";
+        clearForParsing();
+
+        // since leading zeros are not allowed anything longer cannot be valid, also keeps offsets small
+        if (fen.size() > maxFENLength) {
+            return {FENError::TooLong, maxFENLength};
         }
 
-        auto error = b.parseFENBoard(parts[0]);
-        if (error) {
-            return error.value();
+        uint32_t position = 0;
+        if (auto result = parseFENBoard(fen, position); !result) {
+            return result;
         }
 
-        std::optional<Color> nextTurn = parseTurnColor(parts[1]);
+        // the field starting after the space at position, leaves position at the end of the field
+        uint32_t fieldStart = 0;
+        auto nextField = [&](std::string_view& field) {
+            if (position >= fen.size()) {
+                return false;
+            }
+            ASSERT(fen[position] == ' ');
+            fieldStart = position + 1;
+            position = static_cast<uint32_t>(std::min(util::findFirstOf(fen, ' ', fieldStart), fen.size()));
+            field = fen.substr(fieldStart, position - fieldStart);
+            return true;
+        };
+
+        std::string_view field;
+        if (!nextField(field)) {
+            return {FENError::WrongFieldCount, position};
+        }
+        std::optional<Color> nextTurn = parseTurnColor(field);
         if (!nextTurn.has_value()) {
-            return std::string("Invalid turn value: ") + std::string(parts[1]);
+            return {FENError::InvalidTurn, fieldStart};
         }
-        b.m_nextTurnColor = nextTurn.value();
+        m_nextTurnColor = nextTurn.value();
 
-        auto castling = b.setAvailableCastles(parts[2]);
-        if (castling.has_value()) {
-            return std::string("Invalid possible castling moves value: ") + castling.value() + "(" + std::string(parts[2]) + ")";
+        if (!nextField(field)) {
+            return {FENError::WrongFieldCount, position};
+        }
+        if (auto result = setAvailableCastles(field, fieldStart); !result) {
+            return result;
         }
 
-        if (parts[3] != "-") {
-            std::optional<BoardIndex> enPassantPawn = Board::SANToIndex(parts[3]);
+        if (!nextField(field)) {
+            return {FENError::WrongFieldCount, position};
+        }
+        if (field != "-") {
+            std::optional<BoardIndex> enPassantPawn = Board::SANToIndex(field);
             if (!enPassantPawn.has_value()) {
-                return std::string("Invalid en passant value: ") + std::string(parts[3]);
+                return {FENError::InvalidEnPassant, fieldStart};
             }
             auto [col, row] = Board::indexToColumnRow(*enPassantPawn);
-            Color lastMoveColor = opposite(b.m_nextTurnColor);
+            Color lastMoveColor = opposite(m_nextTurnColor);
             if ((lastMoveColor == Color::White && row != 2) || (lastMoveColor == Color::Black && row != size - 1 - 2)) {
-                return std::string("Cannot have en passant on non 3th or 5th row: " + std::string(parts[3]));
+                return {FENError::EnPassantWrongRow, fieldStart};
             }
-            if (b.pieceAt(col, row) != std::nullopt) {
-                return "En passant square cannot have a piece at square";
+            if (pieceAt(col, row) != std::nullopt) {
+                return {FENError::EnPassantSquareOccupied, fieldStart};
             }
             BoardIndex pawnRow = row + (lastMoveColor == Color::White ? 1 : -1);
-            if (b.pieceAt(col, pawnRow) != Piece{Piece::Type::Pawn, lastMoveColor}) {
-                return "En passant square must be just behind previously moved pawn";
+            if (pieceAt(col, pawnRow) != Piece{Piece::Type::Pawn, lastMoveColor}) {
+                return {FENError::EnPassantPawnMissing, fieldStart};
             }
-            b.m_enPassant = enPassantPawn;
+            m_enPassant = enPassantPawn;
         }
 
-        std::optional<uint32_t> halfMovesSinceCapture = strictParseUInt(parts[4]);
+        if (!nextField(field)) {
+            return {FENError::WrongFieldCount, position};
+        }
+        std::optional<uint32_t> halfMovesSinceCapture = strictParseUInt(field);
         if (!halfMovesSinceCapture.has_value()) {
             // must draw after 75 full moves on not capturing but it is valid FEN....
-            return std::string("Invalid half moves since capture: ") + std::string(parts[4]);
+            return {FENError::InvalidHalfMoves, fieldStart};
         }
-        b.m_halfMovesSinceCaptureOrPawn = halfMovesSinceCapture.value();
+        m_halfMovesSinceCaptureOrPawn = halfMovesSinceCapture.value();
 
-        std::optional<uint32_t> totalFullMoves = strictParseUInt(parts[5]);
+        if (!nextField(field)) {
+            return {FENError::WrongFieldCount, position};
+        }
+        std::optional<uint32_t> totalFullMoves = strictParseUInt(field);
         if (!totalFullMoves.has_value() || totalFullMoves == 0u) {
-            return std::string("Invalid full moves made: ") + std::string(parts[5]);
+            return {FENError::InvalidFullMoves, fieldStart};
         }
         if (totalFullMoves >= (std::numeric_limits<uint32_t>::max() / 2u - 3u)) {
-            return std::string("Too many full moves") + std::string(parts[5]);
+            return {FENError::TooManyFullMoves, fieldStart};
         }
-        b.m_halfMovesMade = (totalFullMoves.value() - 1) * 2 + (b.m_nextTurnColor == Color::Black);
+        m_halfMovesMade = (totalFullMoves.value() - 1) * 2 + (m_nextTurnColor == Color::Black);
 
-        return b;
-    }
+        if (position != fen.size()) {
+            return {FENError::WrongFieldCount, position};
+        }
 
-    std::string Board::toFEN() const {
-        std::stringstream val;
+        m_hash = computeHash();
 
-        BoardIndex emptyAcc = 0;
+        return {};
+    }
 
-        auto writeEmpty = [&] {
-          if (emptyAcc > 0) {
-              val << std::to_string(emptyAcc);
-              emptyAcc = 0;
-          }
-        };
+    ExpectedBoard Board::fromFEN(std::string_view str) {
+        Board b{};
+        if (auto result = b.parseFEN(str); !result) {
+            return result.message();
+        }
+        return b;
+    }
+
+    size_t Board::toFEN(char* out) const {
+        char* head = out;
 
         for (BoardIndex row = size - 1; row < size; row--) {
+            char emptyAcc = 0;
             for (BoardIndex column = 0; column < size; column++) {
-                auto nextPiece = pieceAt(column, row);
+                auto nextPiece = pieceAt(columnRowToIndex(column, row));
                 if (nextPiece) {
-                    writeEmpty();
-                    val << nextPiece->toFEN();
+                    if (emptyAcc > 0) {
+                        *head++ = static_cast<char>('0' + emptyAcc);
+                        emptyAcc = 0;
+                    }
+                    *head++ = nextPiece->toFEN();
                 } else {
                     emptyAcc++;
                 }
             }
-            writeEmpty();
+            if (emptyAcc > 0) {
+                *head++ = static_cast<char>('0' + emptyAcc);
+            }
             if (row != 0) {
-                val << '/';
+                *head++ = '/';
+            }
+        }
+
+        *head++ = ' ';
+        *head++ = turnColor(m_nextTurnColor);
+
+        *head++ = ' ';
+        char* castlingStart = head;
+        for (auto& [fen, fenRight] : castleMapping) {
+            if ((m_castlingRights & fenRight) != CastlingRight::NoCastling) {
+                *head++ = fen;
             }
         }
+        if (head == castlingStart) {
+            *head++ = '-';
+        }
+
+        *head++ = ' ';
+        if (m_enPassant.has_value()) {
+            auto [col, row] = indexToColumnRow(*m_enPassant);
+            *head++ = static_cast<char>('a' + col);
+            *head++ = static_cast<char>('1' + row);
+        } else {
+            *head++ = '-';
+        }
+
+        char* end = out + maxFENLength;
+        *head++ = ' ';
+        head = std::to_chars(head, end, m_halfMovesSinceCaptureOrPawn).ptr;
+        *head++ = ' ';
+        head = std::to_chars(head, end, fullMoves()).ptr;
 
-        val << ' ' << turnColor(m_nextTurnColor)
-            << ' ' << m_castlingRights
-            << ' ' << (m_enPassant.has_value() ? indexToSAN(m_enPassant.value()) : "-")
-            << ' ' << m_halfMovesSinceCaptureOrPawn
-            << ' ' << fullMoves();
+        ASSERT(head <= end);
+        return static_cast<size_t>(head - out);
+    }
 
-        return val.str();
+    std::string Board::toFEN() const {
+        std::array<char, maxFENLength> buffer{};
+        return std::string(buffer.data(), toFEN(buffer.data()));
     }
 
 }
@@ -0,0 +1,245 @@
+#include "GameEncoding.h"
+#include "../util/Assertions.h"
+#include "MoveGen.h"
+#include <ostream>
+
+namespace Chess {
+
+    constexpr static std::string_view archiveMagic = "CHGA";
+    constexpr static std::string_view indexMagic = "CHGI";
+    constexpr static uint8_t archiveVersion = 1;
+    constexpr static size_t archiveHeaderSize = 5;
+    constexpr static size_t archiveFooterSize = 8 + 8 + 4;
+
+    std::string_view describeGameDecodeError(GameDecodeError error) {
+        switch (error) {
+            case GameDecodeError::None:
+                return "No error";
+            case GameDecodeError::Truncated:
+                return "Data ends in the middle of a game";
+            case GameDecodeError::InvalidFEN:
+                return "FEN tag is not a valid position";
+            case GameDecodeError::InvalidResult:
+                return "Unknown game result";
+            case GameDecodeError::InvalidMoveIndex:
+                return "Move index is larger than the amount of legal moves";
+        }
+        return "Unknown error";
+    }
+
+    static void writeVarint(std::string& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    static bool readVarint(std::string_view data, size_t& position, uint64_t& value) {
+        value = 0;
+        for (uint32_t shift = 0; shift < 64 && position < data.size(); shift += 7) {
+            auto byte = static_cast<uint8_t>(data[position++]);
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static void writeFixed(std::string& out, uint64_t value) {
+        for (int i = 0; i < 8; ++i) {
+            out.push_back(static_cast<char>(value & 0xff));
+            value >>= 8;
+        }
+    }
+
+    static uint64_t readFixed(std::string_view data) {
+        ASSERT(data.size() >= 8);
+        uint64_t value = 0;
+        for (int i = 7; i >= 0; --i) {
+            value = (value << 8) | static_cast<uint8_t>(data[i]);
+        }
+        return value;
+    }
+
+    static bool readString(std::string_view data, size_t& position, std::string_view& str) {
+        uint64_t length = 0;
+        if (!readVarint(data, position, length) || length > data.size() - position) {
+            return false;
+        }
+        str = data.substr(position, length);
+        position += length;
+        return true;
+    }
+
+    bool encodeGame(std::string& out, const PGNGame& game) {
+        Board board = Board::emptyBoard();
+        if (!board.parseFEN(game.startFEN())) {
+            return false;
+        }
+
+        size_t start = out.size();
+        writeVarint(out, game.tags.size());
+        for (const PGNTag& tag : game.tags) {
+            writeVarint(out, tag.name.size());
+            out.append(tag.name);
+            writeVarint(out, tag.value.size());
+            out.append(tag.value);
+        }
+        out.push_back(static_cast<char>(game.result));
+
+        writeVarint(out, game.moves.size());
+        for (Move move : game.moves) {
+            auto index = generateAllMoves(board).indexOf(move);
+            if (!index.has_value()) {
+                out.resize(start);
+                return false;
+            }
+            static_assert(MoveList::maxMoves <= 256, "Move index must fit in a byte");
+            out.push_back(static_cast<char>(*index));
+            board.makeMove(move);
+        }
+        return true;
+    }
+
+    GameDecodeError decodeGame(std::string_view data, size_t& position, PGNGame& game) {
+        game.tags.clear();
+        game.moves.clear();
+
+        uint64_t tagCount = 0;
+        if (!readVarint(data, position, tagCount)) {
+            return GameDecodeError::Truncated;
+        }
+        for (uint64_t i = 0; i < tagCount; ++i) {
+            PGNTag tag;
+            if (!readString(data, position, tag.name) || !readString(data, position, tag.value)) {
+                return GameDecodeError::Truncated;
+            }
+            game.tags.push_back(tag);
+        }
+
+        if (position >= data.size()) {
+            return GameDecodeError::Truncated;
+        }
+        auto result = static_cast<uint8_t>(data[position++]);
+        if (result > static_cast<uint8_t>(GameResult::Final::Draw)) {
+            return GameDecodeError::InvalidResult;
+        }
+        game.result = static_cast<GameResult::Final>(result);
+
+        if (!game.board.parseFEN(game.startFEN())) {
+            return GameDecodeError::InvalidFEN;
+        }
+
+        uint64_t plies = 0;
+        if (!readVarint(data, position, plies)) {
+            return GameDecodeError::Truncated;
+        }
+        if (plies > data.size() - position) {
+            return GameDecodeError::Truncated;
+        }
+
+        game.moves.reserve(plies);
+        for (uint64_t i = 0; i < plies; ++i) {
+            auto index = static_cast<uint8_t>(data[position++]);
+            MoveList moves = generateAllMoves(game.board);
+            if (index >= moves.size()) {
+                return GameDecodeError::InvalidMoveIndex;
+            }
+            game.board.makeMove(moves[index]);
+            game.moves.push_back(moves[index]);
+        }
+        return GameDecodeError::None;
+    }
+
+    GameArchiveWriter::GameArchiveWriter() {
+        m_data.append(archiveMagic);
+        m_data.push_back(static_cast<char>(archiveVersion));
+    }
+
+    bool GameArchiveWriter::add(const PGNGame& game) {
+        size_t offset = m_data.size();
+        if (!encodeGame(m_data, game)) {
+            return false;
+        }
+        m_offsets.push_back(offset);
+        return true;
+    }
+
+    std::string GameArchiveWriter::finish() {
+        uint64_t indexOffset = m_data.size();
+        m_data.reserve(m_data.size() + m_offsets.size() * 8 + archiveFooterSize);
+        for (uint64_t offset : m_offsets) {
+            writeFixed(m_data, offset);
+        }
+        writeFixed(m_data, m_offsets.size());
+        writeFixed(m_data, indexOffset);
+        m_data.append(indexMagic);
+
+        std::string result = std::move(m_data);
+        m_offsets.clear();
+        m_data.clear();
+        m_data.append(archiveMagic);
+        m_data.push_back(static_cast<char>(archiveVersion));
+        return result;
+    }
+
+    GameArchive::GameArchive(std::string_view data, std::string_view index, size_t games)
+        : m_data(data),
+          m_index(index),
+          m_games(games) {
+    }
+
+    std::optional<GameArchive> GameArchive::open(std::string_view data) {
+        if (data.size() < archiveHeaderSize + archiveFooterSize || !data.starts_with(archiveMagic)
+            || static_cast<uint8_t>(data[archiveMagic.size()]) != archiveVersion || !data.ends_with(indexMagic)) {
+            return std::nullopt;
+        }
+
+        std::string_view footer = data.substr(data.size() - archiveFooterSize);
+        uint64_t games = readFixed(footer);
+        uint64_t indexOffset = readFixed(footer.substr(8));
+        size_t indexEnd = data.size() - archiveFooterSize;
+        if (indexOffset < archiveHeaderSize || indexOffset > indexEnd || (indexEnd - indexOffset) / 8 != games
+            || (indexEnd - indexOffset) % 8 != 0) {
+            return std::nullopt;
+        }
+
+        return GameArchive(data.substr(0, indexOffset), data.substr(indexOffset, games * 8), games);
+    }
+
+    GameDecodeError GameArchive::read(size_t index, PGNGame& game) const {
+        ASSERT(index < m_games);
+        uint64_t offset = readFixed(m_index.substr(index * 8));
+        if (offset < archiveHeaderSize || offset >= m_data.size()) {
+            return GameDecodeError::Truncated;
+        }
+        size_t position = offset;
+        game.offset = offset;
+        return decodeGame(m_data, position, game);
+    }
+
+    std::pair<std::string, size_t> pgnToArchive(std::string_view pgn) {
+        GameArchiveWriter writer;
+        size_t skipped = 0;
+        PGNReader(pgn).forEachGame([&](const PGNGame& game) {
+            if (game.error != PGNError::None || !writer.add(game)) {
+                ++skipped;
+            }
+        });
+        return {writer.finish(), skipped};
+    }
+
+    bool archiveToPGN(const GameArchive& archive, std::ostream& out) {
+        PGNGame game;
+        for (size_t i = 0; i < archive.size(); ++i) {
+            if (archive.read(i, game) != GameDecodeError::None) {
+                return false;
+            }
+            writePGN(out, game);
+        }
+        return true;
+    }
+
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "PGN.h"
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Chess {
+
+    // Binary game encoding where every ply is stored as the index of the move in the list from
+    // generateAllMoves (which has a fixed order), so one byte per ply. An encoded game is:
+    //   varint tag count, per tag: varint name length, name, varint value length, value
+    //   result byte (GameResult::Final)
+    //   varint ply count, one move index byte per ply
+    // Varints are LEB128. The start position is the FEN tag if present like in PGN.
+    // The moves are not entropy coded, one byte already is much smaller than SAN text.
+
+    enum class GameDecodeError : uint8_t {
+        None = 0,
+        Truncated,
+        InvalidFEN,
+        InvalidResult,
+        InvalidMoveIndex,
+    };
+
+    [[nodiscard]] std::string_view describeGameDecodeError(GameDecodeError error);
+
+    // Appends the encoded game to out, returns false (and appends nothing) if a move is not legal
+    bool encodeGame(std::string& out, const PGNGame& game);
+
+    // Decodes the game starting at position and replays it on game.board, position is moved past it.
+    // Tags are views into data. Only game.error, game.offset and game.errorOffset are left untouched.
+    [[nodiscard]] GameDecodeError decodeGame(std::string_view data, size_t& position, PGNGame& game);
+
+    // Encoded games with an index for random access:
+    //   magic "CHGA", version byte
+    //   all encoded games back to back
+    //   index: offset of every game as 8 byte little endian
+    //   game count and offset of the index as 8 byte little endian, magic "CHGI"
+    class GameArchiveWriter {
+    public:
+        GameArchiveWriter();
+
+        bool add(const PGNGame& game);
+
+        [[nodiscard]] size_t games() const {
+            return m_offsets.size();
+        }
+
+        // Returns the complete archive, the writer is empty afterwards
+        [[nodiscard]] std::string finish();
+
+    private:
+        std::string m_data;
+        std::vector<uint64_t> m_offsets;
+    };
+
+    class GameArchive {
+    public:
+        // The data is not copied so must outlive the archive (for example a util::MappedFile).
+        // Returns nullopt if the data is not a complete archive.
+        [[nodiscard]] static std::optional<GameArchive> open(std::string_view data);
+
+        [[nodiscard]] size_t size() const {
+            return m_games;
+        }
+
+        // Sets game.offset to the offset of the game in the archive
+        [[nodiscard]] GameDecodeError read(size_t index, PGNGame& game) const;
+
+    private:
+        GameArchive(std::string_view data, std::string_view index, size_t games);
+
+        std::string_view m_data;
+        std::string_view m_index;
+        size_t m_games = 0;
+    };
+
+    // Encodes all games without errors, returns the archive and the amount of skipped games
+    [[nodiscard]] std::pair<std::string, size_t> pgnToArchive(std::string_view pgn);
+
+    // Writes every game of the archive as PGN, returns false if a game could not be decoded
+    bool archiveToPGN(const GameArchive& archive, std::ostream& out);
+
+}
@@ -0,0 +1,152 @@
+#include "HotPathCounters.h"
+#include <cstdlib>
+#include <iostream>
+
+#ifdef HOT_PATH_COUNTERS
+#include <atomic>
+#include <mutex>
+#endif
+
+namespace Chess::Counters {
+
+#ifdef HOT_PATH_COUNTERS
+    struct ThreadCounters;
+
+    // constant initialized and not allocating so the first count on a thread never allocates
+    static std::mutex s_lock;
+    static ThreadCounters* s_liveThreads = nullptr;
+    static Values s_exitedThreads{};
+
+    struct ThreadCounters {
+        // only written by the owning thread, atomic to allow reading from allThreads()
+        std::array<std::atomic<uint64_t>, CounterCount> values{};
+        ThreadCounters* next = nullptr;
+        ThreadCounters* previous = nullptr;
+
+        ThreadCounters() {
+            std::lock_guard guard(s_lock);
+            next = s_liveThreads;
+            if (next != nullptr) {
+                next->previous = this;
+            }
+            s_liveThreads = this;
+        }
+
+        ~ThreadCounters() {
+            std::lock_guard guard(s_lock);
+            for (int i = 0; i < CounterCount; ++i) {
+                s_exitedThreads[i] += values[i].load(std::memory_order_relaxed);
+            }
+            if (previous != nullptr) {
+                previous->next = next;
+            } else {
+                s_liveThreads = next;
+            }
+            if (next != nullptr) {
+                next->previous = previous;
+            }
+        }
+
+        [[nodiscard]] Values snapshot() const {
+            Values result{};
+            for (int i = 0; i < CounterCount; ++i) {
+                result[i] = values[i].load(std::memory_order_relaxed);
+            }
+            return result;
+        }
+    };
+
+    static thread_local ThreadCounters t_counters;
+
+    void increment(Counter c, uint64_t amount) {
+        auto& value = t_counters.values[c];
+        // single writer so no need for an (expensive) atomic read-modify-write
+        value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+#endif
+
+    std::string_view name(Counter c) {
+        switch (c) {
+            case GenerateAllMovesCalls:
+                return "generateAllMoves calls";
+            case PseudoLegalMoves:
+                return "Pseudo legal moves checked";
+            case IllegalMoves:
+                return "Moves rejected by isLegal";
+            case MakeMoveCalls:
+                return "makeMove calls";
+            case UndoMoveCalls:
+                return "undoMove calls";
+            case RepetitionScans:
+                return "Repetition scans";
+            case RepetitionScanDepth:
+                return "Repetition scan depth (plies)";
+            case AttacksOnCalls:
+                return "attacksOn calls";
+            case CounterCount:
+                break;
+        }
+        return "Unknown";
+    }
+
+    Values thisThread() {
+#ifdef HOT_PATH_COUNTERS
+        return t_counters.snapshot();
+#else
+        return {};
+#endif
+    }
+
+    Values allThreads() {
+#ifdef HOT_PATH_COUNTERS
+        std::lock_guard guard(s_lock);
+        Values result = s_exitedThreads;
+        for (const ThreadCounters* counters = s_liveThreads; counters != nullptr; counters = counters->next) {
+            Values threadValues = counters->snapshot();
+            for (int i = 0; i < CounterCount; ++i) {
+                result[i] += threadValues[i];
+            }
+        }
+        return result;
+#else
+        return {};
+#endif
+    }
+
+    void resetThisThread() {
+#ifdef HOT_PATH_COUNTERS
+        for (auto& value : t_counters.values) {
+            value.store(0, std::memory_order_relaxed);
+        }
+#endif
+    }
+
+    void dump(std::ostream& out, const Values& values) {
+        if (!enabled()) {
+            out << "Hot path counters are disabled (build with WITH_HOT_PATH_COUNTERS)\n";
+            return;
+        }
+
+        for (int i = 0; i < CounterCount; ++i) {
+            out << name(static_cast<Counter>(i)) << ": " << values[i] << '\n';
+        }
+
+        if (values[PseudoLegalMoves] > 0) {
+            out << "Rejected moves: "
+                << (100.0 * static_cast<double>(values[IllegalMoves]) / static_cast<double>(values[PseudoLegalMoves])) << "%\n";
+        }
+        if (values[RepetitionScans] > 0) {
+            out << "Average repetition scan depth: "
+                << (static_cast<double>(values[RepetitionScanDepth]) / static_cast<double>(values[RepetitionScans])) << '\n';
+        }
+    }
+
+    void dumpAtExit() {
+#ifdef HOT_PATH_COUNTERS
+        std::atexit([] {
+            std::cerr << "Hot path counters:\n";
+            dump(std::cerr, allThreads());
+        });
+#endif
+    }
+}
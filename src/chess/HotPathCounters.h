@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+#include <string_view>
+
+// Counting is only compiled in with the WITH_HOT_PATH_COUNTERS cmake option,
+// otherwise COUNT_HOT_PATH compiles to nothing and all values read as 0.
+
+namespace Chess::Counters {
+
+    enum Counter {
+        GenerateAllMovesCalls = 0,
+        PseudoLegalMoves,
+        IllegalMoves,
+        MakeMoveCalls,
+        UndoMoveCalls,
+        RepetitionScans,
+        RepetitionScanDepth,
+        AttacksOnCalls,
+        CounterCount
+    };
+
+    using Values = std::array<uint64_t, CounterCount>;
+
+    [[nodiscard]] constexpr bool enabled() {
+#ifdef HOT_PATH_COUNTERS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    [[nodiscard]] std::string_view name(Counter c);
+
+    // Counters of the calling thread only
+    [[nodiscard]] Values thisThread();
+
+    // Sum of all threads, including the ones which already exited
+    [[nodiscard]] Values allThreads();
+
+    void resetThisThread();
+
+    void dump(std::ostream& out, const Values& values);
+
+    // Dumps allThreads() to std::cerr when the program exits
+    void dumpAtExit();
+
+#ifdef HOT_PATH_COUNTERS
+    void increment(Counter c, uint64_t amount);
+#endif
+}
+
+#ifdef HOT_PATH_COUNTERS
+#define COUNT_HOT_PATH_N(counter, amount) Chess::Counters::increment(Chess::Counters::counter, amount)
+#else
+#define COUNT_HOT_PATH_N(counter, amount) \
+    do {                                  \
+    } while (false)
+#endif
+
+#define COUNT_HOT_PATH(counter) COUNT_HOT_PATH_N(counter, 1)
@@ -18,9 +18,6 @@ namespace Chess {
        flag(flags) {
     }
 
-    Move::Move() : toPosition(0), fromPosition(0), flag(Flag::None) {
-    }
-
     Move::Move(std::string_view from, std::string_view to, Move::Flag flags) :
         flag(flags) {
         auto fromSquare = Board::SANToIndex(from);
@@ -24,7 +24,9 @@ namespace Chess {
 
         Flag flag : 3;
 
-        Move();
+        // inline since move lists construct a lot of them
+        Move() : toPosition(0), fromPosition(0), flag(Flag::None) {
+        }
 
         Move(BoardIndex fromIndex, BoardIndex toIndex, Flag flags = Flag::None);
 
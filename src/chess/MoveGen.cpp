@@ -5,6 +5,7 @@
 #include <optional>
 
 #include "BitBoard.h"
+#include "HotPathCounters.h"
 
 namespace Chess {
 
@@ -13,11 +14,12 @@ namespace Chess {
     void MoveList::addMove(Move move) {
         // not sure we actually want to reject none moves?
         ASSERT(move.fromPosition != move.toPosition);
-        m_moves.push_back(move);
+        ASSERT(m_size < maxMoves);
+        m_moves[m_size++] = move;
     }
 
     size_t MoveList::size() const {
-        return m_moves.size();
+        return m_size;
     }
 
     bool MoveList::isStaleMate() const {
@@ -63,8 +65,17 @@ namespace Chess {
             return false;
         }
 
-        if (board.isLegal(m)) {
+        if (!(toBB & (list.m_quietTargets | board.piecesBB)) && !m.isPromotion() && m.flag != Move::Flag::EnPassant) {
+            // not wanted by the generation mode, a slider may still continue past the empty square
+            return true;
+        }
+
+        COUNT_HOT_PATH(PseudoLegalMoves);
+        bool cannotExposeKing = (list.m_cannotExposeKing & squareBoard(m.fromPosition)) && m.flag != Move::Flag::EnPassant;
+        if (cannotExposeKing || board.isLegal(m)) {
             list.addMove(m);
+        } else {
+            COUNT_HOT_PATH(IllegalMoves);
         }
 
         return !(toBB & board.piecesBB);
@@ -236,9 +247,41 @@ namespace Chess {
     }
 
     MoveList generateAllMoves(const Board &board) {
+        return generateMoves(board, GenerationMode::All);
+    }
+
+    // Indexed by the Piece::Type value, the squares from which a piece of color and that type attacks king
+    static std::array<BitBoard, 7> checkingSquares(BoardIndex king, Color color, BitBoard occupied) {
+        BitBoard bishopLines = generateSliders<Piece::Type::Bishop>(king, occupied);
+        BitBoard rookLines = generateSliders<Piece::Type::Rook>(king, occupied);
+
+        std::array<BitBoard, 7> squares{};
+        squares[static_cast<size_t>(Piece::Type::Pawn)] = pawnAttackBB(opposite(color), king);
+        squares[static_cast<size_t>(Piece::Type::Knight)] = pieceAttacksBB<Piece::Type::Knight>(king);
+        squares[static_cast<size_t>(Piece::Type::Bishop)] = bishopLines;
+        squares[static_cast<size_t>(Piece::Type::Rook)] = rookLines;
+        squares[static_cast<size_t>(Piece::Type::Queen)] = bishopLines | rookLines;
+        return squares;
+    }
+
+    static BitBoard attacksFrom(Piece::Type type, BoardIndex square, BitBoard occupied) {
+        switch (type) {
+            case Piece::Type::Bishop:
+                return generateSliders<Piece::Type::Bishop>(square, occupied);
+            case Piece::Type::Rook:
+                return generateSliders<Piece::Type::Rook>(square, occupied);
+            case Piece::Type::Queen:
+                return generateSliders<Piece::Type::Queen>(square, occupied);
+            default:
+                return pieceAttacksBB(type, square);
+        }
+    }
+
+    MoveList generateMoves(const Board &board, GenerationMode mode) {
 #ifdef OUTPUT_FEN
         std::cout << board.toFEN() << '\n';
 #endif
+        COUNT_HOT_PATH(GenerateAllMovesCalls);
         MoveList list{};
         Color color = board.colorToMove();
 
@@ -249,8 +292,27 @@ namespace Chess {
         BitBoard pieces = board.colorBitboard(color);
         BitBoard them = board.colorBitboard(opposite(color));
 
+        auto [kingCol, kingRow] = board.kingSquare(color);
+        bool inCheck = board.attacked(kingCol, kingRow);
+        if (!inCheck) {
+            list.m_cannotExposeKing = pieces & ~board.typeBitboard(Piece::Type::King) & ~board.pinnedPieces();
+        }
+
+        // evasions are never skipped, so check mate is still detected
+        if (inCheck) {
+            mode = GenerationMode::All;
+        }
+        std::array<BitBoard, 7> quietTargets{};
+        if (mode == GenerationMode::All) {
+            quietTargets.fill(~BitBoard(0));
+        } else if (mode == GenerationMode::CapturesAndChecks) {
+            auto [theirKingCol, theirKingRow] = board.kingSquare(opposite(color));
+            quietTargets = checkingSquares(Board::columnRowToIndex(theirKingCol, theirKingRow), color, board.piecesBB);
+        }
+
         {
             BitBoard pawns = pieces & board.typeBitboard(Piece::Type::Pawn);
+            list.m_quietTargets = quietTargets[static_cast<size_t>(Piece::Type::Pawn)];
 
             if (color == Color::White) {
                 generatePawnMoves<Color::White>(pawns, board, list, pieces, them, board.enPassantBB());
@@ -267,6 +329,16 @@ namespace Chess {
             ASSERT(board.pieceAt(index).has_value());
             auto piece = board.pieceAt(index).value();
 
+            list.m_quietTargets = quietTargets[static_cast<size_t>(piece.type())];
+            if (mode != GenerationMode::All) {
+                // only a few destinations, so these are not found by walking every direction
+                BitBoard targets = attacksFrom(piece.type(), index, board.piecesBB) & (them | list.m_quietTargets);
+                while (targets) {
+                    validateMove(list, board, Move(index, popLsb(targets)));
+                }
+                continue;
+            }
+
             auto [col, row] = Board::indexToColumnRow(index);
 
             switch (piece.type()) {
@@ -293,17 +365,25 @@ namespace Chess {
 
         }
 
-        if (list.size() == 0) {
-            // add king check to differentiate check and stale mate
-            auto [kingCol, kingRow] = board.kingSquare(board.colorToMove());
-            if (board.attacked(kingCol, kingRow)) {
-                list.kingAttacked();
-            }
+        list.m_cannotExposeKing = 0;
+        list.m_quietTargets = ~BitBoard(0);
+        if (list.size() == 0 && inCheck) {
+            // to differentiate check and stale mate
+            list.kingAttacked();
         }
 
         return list;
     }
 
+    std::optional<size_t> MoveList::indexOf(Move move) const {
+        auto end = m_moves.begin() + m_size;
+        auto found = std::find(m_moves.begin(), end, move);
+        if (found == end) {
+            return std::nullopt;
+        }
+        return static_cast<size_t>(found - m_moves.begin());
+    }
+
     bool MoveList::contains(Move move) const {
         return hasMove([&move](const Move& mv) {
           return mv == move;
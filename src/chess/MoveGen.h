@@ -4,23 +4,37 @@
 #include "Types.h"
 #include "Move.h"
 #include <algorithm>
+#include <array>
 #include <cstddef>
-#include <vector>
+#include <cstdint>
+#include <optional>
 
 namespace Chess {
 
+    enum class GenerationMode : uint8_t {
+        All,
+        // Captures (including en passant) and promotions, what a quiescence search looks at
+        Captures,
+        // Captures plus the quiet moves which put a piece on a square attacking the king, discovered
+        // checks and checks by castling are not included
+        CapturesAndChecks,
+    };
+
     class MoveList {
     public:
+        // No legal position has more than 218 moves, stored inline so generating moves never allocates
+        constexpr static size_t maxMoves = 256;
+
         size_t size() const;
 
         template<typename Func>
         void forEachMove(Func f) const {
-            std::for_each(m_moves.begin(), m_moves.end(), f);
+            std::for_each(m_moves.begin(), m_moves.begin() + m_size, f);
         }
 
         template<typename Predicate>
         bool hasMove(Predicate p) const {
-            return std::any_of(m_moves.begin(), m_moves.end(), p);
+            return std::any_of(m_moves.begin(), m_moves.begin() + m_size, p);
         }
 
         template<typename Filter, typename Func>
@@ -41,6 +55,13 @@ namespace Chess {
 
         bool contains(Move mv) const;
 
+        // Moves are in generation order which is the same every time for a given position
+        [[nodiscard]] Move operator[](size_t index) const {
+            return m_moves[index];
+        }
+
+        [[nodiscard]] std::optional<size_t> indexOf(Move mv) const;
+
         [[nodiscard]] bool isStaleMate() const;
 
         [[nodiscard]] bool isCheckMate() const;
@@ -49,12 +70,24 @@ namespace Chess {
     private:
         void kingAttacked();
 
-        friend MoveList generateAllMoves(const Board& board);
+        friend MoveList generateMoves(const Board& board, GenerationMode mode);
+        friend bool validateMove(MoveList& list, const Board&, Move);
 
-        std::vector<Move> m_moves;
+        std::array<Move, maxMoves> m_moves;
+        uint16_t m_size = 0;
         bool m_inCheck = false;
+        // Only used during generation: pieces which cannot expose their king, so any of their
+        // pseudo legal moves (except en passant) is legal without checking the resulting position
+        BitBoard m_cannotExposeKing = 0;
+        // Only used during generation: destinations the current piece may move to without capturing
+        BitBoard m_quietTargets = ~BitBoard(0);
     };
 
     MoveList generateAllMoves(const Board& board);
 
+    // Only the moves of mode, in no particular order for modes but All. In check every evasion is
+    // generated regardless of mode, so an empty list is still check mate. Outside of check an empty
+    // list does not mean stale mate for any mode but All.
+    MoveList generateMoves(const Board& board, GenerationMode mode);
+
 }
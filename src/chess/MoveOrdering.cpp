@@ -0,0 +1,124 @@
+#include "MoveOrdering.h"
+#include "../util/Assertions.h"
+#include "Evaluation.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace Chess {
+
+    constexpr static int32_t firstMoveScore = 1 << 30;
+    constexpr static int32_t captureScore = 1 << 20;
+    constexpr static int32_t killerScore = 1 << 19;
+    constexpr static int32_t counterMoveScore = 1 << 18;
+    // captures losing material in the static exchange go after the quiet moves
+    constexpr static int32_t losingCaptureScore = -(1 << 19);
+    // after every quiet move, a knight, rook or bishop is hardly ever better than a queen
+    constexpr static int32_t underPromotionScore = -(1 << 20);
+
+    static_assert(OrderingTables::maxHistory < counterMoveScore, "History must stay below the counter move");
+
+    // Indexed by the Piece::Type value, the least valuable attacker should capture first
+    constexpr static std::array<int32_t, 7> attackerRank = {0, 1, 6, 3, 4, 5, 2};
+
+    static std::optional<Piece> pieceOn(const Board& board, BoardIndex index) {
+        return board.pieceAt(index % Board::size, index / Board::size);
+    }
+
+    bool isQuietMove(const Board& board, Move move) {
+        if (move.flag == Move::Flag::Castling) {
+            // the destination is the own rook
+            return true;
+        }
+        return !move.isPromotion() && move.flag != Move::Flag::EnPassant && !pieceOn(board, move.toPosition).has_value();
+    }
+
+    void OrderingTables::newSearch() {
+        m_killers = {};
+        for (auto& side : m_history) {
+            for (auto& from : side) {
+                for (int32_t& value : from) {
+                    value /= 2;
+                }
+            }
+        }
+    }
+
+    void OrderingTables::updateHistory(Color side, Move move, int32_t bonus) {
+        // moves towards the bound by the bonus scaled with the distance to it, so it never overflows
+        int32_t& value = m_history[side == Color::Black][move.fromPosition][move.toPosition];
+        value += bonus - value * std::abs(bonus) / maxHistory;
+        ASSERT(std::abs(value) <= maxHistory);
+    }
+
+    void OrderingTables::updateOnCutoff(Color side, uint32_t ply, uint32_t depth, Move move, Move previous,
+                                        const Move* tried, size_t triedCount) {
+        ASSERT(ply < maxPly);
+        if (m_killers[ply][0] != move) {
+            m_killers[ply][1] = m_killers[ply][0];
+            m_killers[ply][0] = move;
+        }
+
+        int32_t bonus = std::min<int32_t>(static_cast<int32_t>(depth * depth) * 8, maxHistory / 4);
+        updateHistory(side, move, bonus);
+        for (size_t i = 0; i < triedCount; ++i) {
+            updateHistory(side, tried[i], -bonus);
+        }
+
+        if (previous != Move{}) {
+            m_counterMoves[previous.fromPosition][previous.toPosition] = move;
+        }
+    }
+
+    MovePicker::MovePicker(const Board& board, const MoveList& moves, Move firstMove, const OrderingTables& tables,
+                           uint32_t ply, Move previous) {
+        Color side = board.colorToMove();
+        const auto& killers = tables.killers(ply);
+        Move counter = previous != Move{} ? tables.counterMove(previous) : Move{};
+
+        m_size = moves.size();
+        for (size_t i = 0; i < m_size; ++i) {
+            Move move = moves[i];
+            m_moves[i] = move;
+
+            int32_t score;
+            if (move == firstMove) {
+                score = firstMoveScore;
+            } else if (move.isPromotion() && move.promotedType() != Piece::Type::Queen) {
+                score = underPromotionScore;
+            } else if (!isQuietMove(board, move)) {
+                Piece attacker = *pieceOn(board, move.fromPosition);
+                auto captured = pieceOn(board, move.toPosition);
+                // a promotion does not have to capture
+                Piece::Type victim = move.flag == Move::Flag::EnPassant ? Piece::Type::Pawn
+                                     : captured.has_value()            ? captured->type()
+                                                                       : Piece::Type::None;
+                score = pieceValue(victim) * 8 - attackerRank[static_cast<size_t>(attacker.type())];
+                if (move.isPromotion()) {
+                    score += pieceValue(move.promotedType()) * 8;
+                }
+                score += board.seeGE(move, 0) ? captureScore : losingCaptureScore;
+            } else if (move == killers[0]) {
+                score = killerScore + 1;
+            } else if (move == killers[1]) {
+                score = killerScore;
+            } else if (move == counter) {
+                score = counterMoveScore;
+            } else {
+                score = tables.history(side, move);
+            }
+            m_scores[i] = score;
+        }
+    }
+
+    std::optional<Move> MovePicker::next() {
+        if (m_next >= m_size) {
+            return std::nullopt;
+        }
+        auto best = std::max_element(m_scores.begin() + m_next, m_scores.begin() + m_size);
+        size_t index = best - m_scores.begin();
+        std::swap(m_scores[index], m_scores[m_next]);
+        std::swap(m_moves[index], m_moves[m_next]);
+        return m_moves[m_next++];
+    }
+
+}
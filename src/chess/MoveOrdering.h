@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Board.h"
+#include "Move.h"
+#include "MoveGen.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace Chess {
+
+    // Captures, en passant and promotions, everything else (including castling) is quiet
+    [[nodiscard]] bool isQuietMove(const Board& board, Move move);
+
+    // Learned during a search from the quiet moves which caused a beta cutoff, every search thread
+    // has its own. Killers are per ply, history is per side and from/to square (butterfly board) and
+    // the counter move is the refutation of the previous move found last.
+    class OrderingTables {
+    public:
+        constexpr static size_t maxPly = 64;
+        constexpr static int32_t maxHistory = 16384;
+
+        // Forgets the killers and halves the history so older results weigh less
+        void newSearch();
+
+        // previous is the move leading to the node (Move{} at the root), tried are the quiet moves
+        // searched before move at the node which did not cause a cutoff
+        void updateOnCutoff(Color side, uint32_t ply, uint32_t depth, Move move, Move previous,
+                            const Move* tried, size_t triedCount);
+
+        [[nodiscard]] int32_t history(Color side, Move move) const {
+            return m_history[side == Color::Black][move.fromPosition][move.toPosition];
+        }
+
+        [[nodiscard]] const std::array<Move, 2>& killers(uint32_t ply) const {
+            return m_killers[ply];
+        }
+
+        [[nodiscard]] Move counterMove(Move previous) const {
+            return m_counterMoves[previous.fromPosition][previous.toPosition];
+        }
+
+    private:
+        void updateHistory(Color side, Move move, int32_t bonus);
+
+        std::array<std::array<Move, 2>, maxPly> m_killers{};
+        std::array<std::array<std::array<int32_t, 64>, 64>, 2> m_history{};
+        std::array<std::array<Move, 64>, 64> m_counterMoves{};
+    };
+
+    // Hands out the moves of a list best first: the given first move (from the transposition table
+    // or principal variation), captures and promotions which do not lose material (Board::seeGE) by
+    // most valuable victim / least valuable attacker, the killers, the counter move, the other quiet
+    // moves by history and then the losing captures. Only the best remaining move is selected on
+    // every call, so after a cutoff the rest is never sorted.
+    class MovePicker {
+    public:
+        MovePicker(const Board& board, const MoveList& moves, Move firstMove, const OrderingTables& tables,
+                   uint32_t ply, Move previous);
+
+        [[nodiscard]] std::optional<Move> next();
+
+    private:
+        std::array<Move, MoveList::maxMoves> m_moves;
+        std::array<int32_t, MoveList::maxMoves> m_scores;
+        size_t m_size = 0;
+        size_t m_next = 0;
+    };
+
+}
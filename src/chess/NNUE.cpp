@@ -0,0 +1,354 @@
+#include "NNUE.h"
+#include "../util/Assertions.h"
+#include "BitBoard.h"
+#include "Board.h"
+#include "NNUEKernels.h"
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Chess::NNUE {
+
+    static_assert(accumulatorSize % Kernels::blockSize == 0 && hiddenSize % Kernels::blockSize == 0,
+                  "Layers must fit the kernels");
+
+    // Indexed by the Piece::Type value, kings are not an input
+    constexpr static std::array<size_t, 7> kindIndex = {0, 0, 0, 2, 3, 4, 1};
+
+    constexpr static std::string_view magic = "NNUE";
+
+    std::string_view describeLoadError(LoadError error) {
+        switch (error) {
+            case LoadError::None:
+                return "No error";
+            case LoadError::CannotRead:
+                return "File cannot be read";
+            case LoadError::NotANetwork:
+                return "File is not a network";
+            case LoadError::WrongVersion:
+                return "Network has another version or other layer sizes";
+            case LoadError::WrongSize:
+                return "File is not the size of a network";
+        }
+        return "Unknown error";
+    }
+
+    BoardNetwork::BoardNetwork(const BoardNetwork& other)
+        : m_state(other.m_state == nullptr ? nullptr : std::make_unique<State>(*other.m_state)) {
+    }
+
+    BoardNetwork& BoardNetwork::operator=(const BoardNetwork& other) {
+        if (other.m_state == nullptr) {
+            m_state.reset();
+        } else if (m_state == nullptr) {
+            m_state = std::make_unique<State>(*other.m_state);
+        } else {
+            *m_state = *other.m_state;
+        }
+        return *this;
+    }
+
+    void BoardNetwork::set(const Network* network) {
+        if (network == nullptr) {
+            m_state.reset();
+            return;
+        }
+        if (m_state == nullptr) {
+            m_state = std::make_unique<State>();
+        }
+        m_state->network = network;
+        m_state->accumulator.stale = {true, true};
+    }
+
+    size_t featureIndex(Color perspective, BoardIndex kingSquare, Piece piece, BoardIndex square) {
+        ASSERT(piece.type() != Piece::Type::King);
+        // black sees the board upside down
+        BoardIndex flip = perspective == Color::White ? 0 : 56;
+        size_t kind = kindIndex[static_cast<size_t>(piece.type())] + (piece.color() == perspective ? 0 : 5);
+        return (static_cast<size_t>(kingSquare ^ flip) * pieceKinds + kind) * 64 + (square ^ flip);
+    }
+
+    namespace {
+        // Reads the little endian values of a file one after the other, stops at the end of it
+        class Reader {
+        public:
+            explicit Reader(std::string_view data) : m_data(data) {
+            }
+
+            template<typename T>
+            bool read(T& value) {
+                using Unsigned = std::make_unsigned_t<T>;
+                if (m_offset + sizeof(T) > m_data.size()) {
+                    return false;
+                }
+                Unsigned bits = 0;
+                for (size_t i = 0; i < sizeof(T); ++i) {
+                    bits |= static_cast<Unsigned>(static_cast<Unsigned>(static_cast<uint8_t>(m_data[m_offset + i])) << (8 * i));
+                }
+                m_offset += sizeof(T);
+                value = static_cast<T>(bits);
+                return true;
+            }
+
+            template<typename T, size_t N>
+            bool read(std::array<T, N>& values) {
+                return std::all_of(values.begin(), values.end(), [this](T& value) {
+                    return read(value);
+                });
+            }
+
+            [[nodiscard]] bool atEnd() const {
+                return m_offset == m_data.size();
+            }
+
+        private:
+            std::string_view m_data;
+            size_t m_offset = 0;
+        };
+
+        class Writer {
+        public:
+            template<typename T>
+            void write(T value) {
+                auto bits = static_cast<std::make_unsigned_t<T>>(value);
+                for (size_t i = 0; i < sizeof(T); ++i) {
+                    m_bytes.push_back(static_cast<char>(bits >> (8 * i)));
+                }
+            }
+
+            template<typename T, size_t N>
+            void write(const std::array<T, N>& values) {
+                for (T value : values) {
+                    write(value);
+                }
+            }
+
+            [[nodiscard]] const std::vector<char>& bytes() const {
+                return m_bytes;
+            }
+
+        private:
+            std::vector<char> m_bytes;
+        };
+    }
+
+    LoadResult Network::load(const std::string& path) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) {
+            return {nullptr, LoadError::CannotRead};
+        }
+        std::string data(static_cast<size_t>(file.tellg()), '\0');
+        file.seekg(0);
+        if (!file.read(data.data(), static_cast<std::streamsize>(data.size()))) {
+            return {nullptr, LoadError::CannotRead};
+        }
+        std::string_view contents = data;
+        if (!contents.starts_with(magic)) {
+            return {nullptr, LoadError::NotANetwork};
+        }
+
+        Reader reader(contents.substr(magic.size()));
+        uint32_t fileVersion = 0;
+        uint32_t fileAccumulatorSize = 0;
+        uint32_t fileHiddenSize = 0;
+        if (!reader.read(fileVersion) || !reader.read(fileAccumulatorSize) || !reader.read(fileHiddenSize)
+            || fileVersion != version || fileAccumulatorSize != accumulatorSize || fileHiddenSize != hiddenSize) {
+            return {nullptr, LoadError::WrongVersion};
+        }
+
+        std::unique_ptr<Network> network(new Network());
+        bool complete = reader.read(network->m_featureBiases)
+                     && std::all_of(network->m_featureWeights.begin(), network->m_featureWeights.end(), [&](auto& row) {
+                            return reader.read(row);
+                        })
+                     && reader.read(network->m_hiddenBiases)
+                     && std::all_of(network->m_hiddenWeights.begin(), network->m_hiddenWeights.end(), [&](auto& row) {
+                            return reader.read(row);
+                        })
+                     && reader.read(network->m_outputBias)
+                     && reader.read(network->m_outputWeights);
+        if (!complete || !reader.atEnd()) {
+            return {nullptr, LoadError::WrongSize};
+        }
+        return {std::move(network), LoadError::None};
+    }
+
+    bool Network::save(const std::string& path) const {
+        Writer writer;
+        for (char c : magic) {
+            writer.write(c);
+        }
+        writer.write(version);
+        writer.write(static_cast<uint32_t>(accumulatorSize));
+        writer.write(static_cast<uint32_t>(hiddenSize));
+        writer.write(m_featureBiases);
+        for (const auto& row : m_featureWeights) {
+            writer.write(row);
+        }
+        writer.write(m_hiddenBiases);
+        for (const auto& row : m_hiddenWeights) {
+            writer.write(row);
+        }
+        writer.write(m_outputBias);
+        writer.write(m_outputWeights);
+
+        std::ofstream file(path, std::ios::binary);
+        file.write(writer.bytes().data(), static_cast<std::streamsize>(writer.bytes().size()));
+        return file.good();
+    }
+
+    std::unique_ptr<Network> Network::random(uint64_t seed) {
+        std::mt19937_64 random(seed);
+        auto fill = [&random](auto& values, int32_t min, int32_t max) {
+            std::uniform_int_distribution<int32_t> distribution(min, max);
+            for (auto& value : values) {
+                value = static_cast<std::remove_reference_t<decltype(value)>>(distribution(random));
+            }
+        };
+
+        std::unique_ptr<Network> network(new Network());
+        // small enough that no accumulator leaves int16 even with every piece on the board
+        fill(network->m_featureBiases, -16, 64);
+        for (auto& row : network->m_featureWeights) {
+            fill(row, -32, 32);
+        }
+        fill(network->m_hiddenBiases, -2000, 2000);
+        for (auto& row : network->m_hiddenWeights) {
+            fill(row, -8, 8);
+        }
+        network->m_outputBias = std::uniform_int_distribution<int32_t>(-500, 500)(random);
+        fill(network->m_outputWeights, -16, 16);
+        return network;
+    }
+
+    void Network::addFeature(Accumulator& accumulator, Color perspective, size_t feature) const {
+        ASSERT(feature < featureCount);
+        Kernels::add(accumulator.values[perspective == Color::Black].data(), m_featureWeights[feature].data(),
+                     accumulatorSize);
+    }
+
+    void Network::removeFeature(Accumulator& accumulator, Color perspective, size_t feature) const {
+        ASSERT(feature < featureCount);
+        Kernels::subtract(accumulator.values[perspective == Color::Black].data(), m_featureWeights[feature].data(),
+                          accumulatorSize);
+    }
+
+    void Network::refresh(Accumulator& accumulator, Color perspective, const Board& board) const {
+        auto [kingCol, kingRow] = board.kingSquare(perspective);
+        ASSERT(board.pieceAt(kingCol, kingRow) == Piece(Piece::Type::King, perspective));
+        BoardIndex kingSquare = kingCol + Board::size * kingRow;
+
+        size_t side = perspective == Color::Black;
+        accumulator.values[side] = m_featureBiases;
+        for (BoardIndex row = 0; row < Board::size; ++row) {
+            for (BoardIndex col = 0; col < Board::size; ++col) {
+                auto piece = board.pieceAt(col, row);
+                if (piece.has_value() && piece->type() != Piece::Type::King) {
+                    addFeature(accumulator, perspective, featureIndex(perspective, kingSquare, *piece, col + Board::size * row));
+                }
+            }
+        }
+        accumulator.stale[side] = false;
+    }
+
+    int32_t Network::evaluate(const Accumulator& accumulator, Color toMove) const {
+        ASSERT(!accumulator.stale[0] && !accumulator.stale[1]);
+        size_t us = toMove == Color::Black;
+
+        alignas(64) std::array<uint8_t, 2 * accumulatorSize> input;
+        Kernels::clippedReLU(accumulator.values[us].data(), input.data(), accumulatorSize);
+        Kernels::clippedReLU(accumulator.values[us ^ 1].data(), input.data() + accumulatorSize, accumulatorSize);
+
+        alignas(64) std::array<uint8_t, hiddenSize> hidden;
+        for (size_t i = 0; i < hiddenSize; ++i) {
+            int32_t sum = m_hiddenBiases[i] + Kernels::dot(input.data(), m_hiddenWeights[i].data(), input.size());
+            hidden[i] = static_cast<uint8_t>(std::clamp(sum >> hiddenShift, 0, activationMax));
+        }
+
+        int32_t output = m_outputBias + Kernels::dot(hidden.data(), m_outputWeights.data(), hidden.size());
+        return std::clamp(output / outputScale, -maxScore, maxScore);
+    }
+
+    int32_t Network::evaluateReference(const Board& board) const {
+        std::array<std::array<int32_t, accumulatorSize>, 2> accumulators{};
+        for (Color perspective : {Color::White, Color::Black}) {
+            auto [kingCol, kingRow] = board.kingSquare(perspective);
+            BoardIndex kingSquare = kingCol + Board::size * kingRow;
+            auto& accumulator = accumulators[perspective == Color::Black];
+            std::copy(m_featureBiases.begin(), m_featureBiases.end(), accumulator.begin());
+
+            for (BoardIndex square = 0; square < Board::size * Board::size; ++square) {
+                auto piece = board.pieceAt(square % Board::size, square / Board::size);
+                if (!piece.has_value() || piece->type() == Piece::Type::King) {
+                    continue;
+                }
+                const auto& weights = m_featureWeights[featureIndex(perspective, kingSquare, *piece, square)];
+                for (size_t i = 0; i < accumulatorSize; ++i) {
+                    accumulator[i] += weights[i];
+                }
+            }
+        }
+
+        size_t us = board.colorToMove() == Color::Black;
+        std::array<int32_t, 2 * accumulatorSize> input{};
+        for (size_t i = 0; i < accumulatorSize; ++i) {
+            input[i] = std::clamp(accumulators[us][i], 0, activationMax);
+            input[accumulatorSize + i] = std::clamp(accumulators[us ^ 1][i], 0, activationMax);
+        }
+
+        int32_t output = m_outputBias;
+        for (size_t i = 0; i < hiddenSize; ++i) {
+            int32_t sum = m_hiddenBiases[i];
+            for (size_t j = 0; j < input.size(); ++j) {
+                sum += input[j] * m_hiddenWeights[i][j];
+            }
+            output += std::clamp(sum >> hiddenShift, 0, activationMax) * m_outputWeights[i];
+        }
+        return std::clamp(output / outputScale, -maxScore, maxScore);
+    }
+
+}
+
+namespace Chess {
+
+    void Board::setNetwork(const NNUE::Network* network) {
+        m_network.set(network);
+    }
+
+    const NNUE::Accumulator& Board::accumulator() const {
+        ASSERT(m_network.network() != nullptr);
+        NNUE::Accumulator& accumulator = m_network.accumulator();
+        for (Color perspective : {Color::White, Color::Black}) {
+            if (accumulator.stale[perspective == Color::Black]) {
+                m_network.network()->refresh(accumulator, perspective, *this);
+            }
+        }
+        return accumulator;
+    }
+
+    void Board::updateAccumulator(Piece piece, BoardIndex index, bool add) {
+        NNUE::Accumulator& accumulator = m_network.accumulator();
+        if (piece.type() == Piece::Type::King) {
+            accumulator.stale[piece.color() == Color::Black] = true;
+            return;
+        }
+        for (Color perspective : {Color::White, Color::Black}) {
+            if (accumulator.stale[perspective == Color::Black]) {
+                continue;
+            }
+            BitBoard king = typeBitboard(Piece::Type::King) & colorBitboard(perspective);
+            ASSERT(king != 0);
+            size_t feature = NNUE::featureIndex(perspective, BB::popLsb(king), piece, index);
+            if (add) {
+                m_network.network()->addFeature(accumulator, perspective, feature);
+            } else {
+                m_network.network()->removeFeature(accumulator, perspective, feature);
+            }
+        }
+    }
+
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "Piece.h"
+#include "Types.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace Chess {
+    class Board;
+}
+
+namespace Chess::NNUE {
+
+    // HalfKP inputs: every side sees the square of its own king combined with each non king piece
+    // (own or opposing pawn, knight, bishop, rook or queen) on each square, black with the board
+    // flipped so both sides look at it the same way
+    constexpr size_t pieceKinds = 10;
+    constexpr size_t featureCount = 64 * pieceKinds * 64;
+    constexpr size_t accumulatorSize = 256;
+    constexpr size_t hiddenSize = 32;
+
+    // Activations are clipped to [0, activationMax] so they multiply with int8 weights
+    constexpr int32_t activationMax = 127;
+    // The hidden layer sums are divided by 2^hiddenShift, the output by outputScale to get centipawns
+    constexpr int32_t hiddenShift = 6;
+    constexpr int32_t outputScale = 16;
+    // Evaluations are clamped to this so they never look like a mate
+    constexpr int32_t maxScore = 20000;
+
+    [[nodiscard]] size_t featureIndex(Color perspective, BoardIndex kingSquare, Piece piece, BoardIndex square);
+
+    // The first layer of the network for both sides (by color index) before activation, Board keeps
+    // it up to date. Moving a king changes all inputs of its side, that side is then stale until it
+    // is refreshed from scratch.
+    struct Accumulator {
+        alignas(64) std::array<std::array<int16_t, accumulatorSize>, 2> values{};
+        std::array<bool, 2> stale = {true, true};
+    };
+
+    enum class LoadError : uint8_t {
+        None = 0,
+        CannotRead,
+        NotANetwork,
+        WrongVersion,
+        WrongSize,
+    };
+
+    [[nodiscard]] std::string_view describeLoadError(LoadError error);
+
+    class Network;
+
+    struct LoadResult;
+
+    // The network a board evaluates with and the accumulator of that board. It is only allocated
+    // while there is a network, so boards without one stay small. Copies get their own accumulator.
+    class BoardNetwork {
+    public:
+        BoardNetwork() = default;
+
+        BoardNetwork(const BoardNetwork& other);
+        BoardNetwork& operator=(const BoardNetwork& other);
+
+        BoardNetwork(BoardNetwork&& other) noexcept = default;
+        BoardNetwork& operator=(BoardNetwork&& other) noexcept = default;
+
+        // nullptr frees the accumulator, otherwise both sides are stale
+        void set(const Network* network);
+
+        [[nodiscard]] const Network* network() const {
+            return m_state == nullptr ? nullptr : m_state->network;
+        }
+
+        // Only with a network
+        [[nodiscard]] Accumulator& accumulator() const {
+            return m_state->accumulator;
+        }
+
+        void markStale() {
+            if (m_state != nullptr) {
+                m_state->accumulator.stale = {true, true};
+            }
+        }
+
+    private:
+        struct State {
+            const Network* network = nullptr;
+            Accumulator accumulator;
+        };
+
+        std::unique_ptr<State> m_state;
+    };
+
+    // Layers: featureCount -> accumulatorSize (int16, per side) -> 2 * accumulatorSize clipped, side
+    // to move first -> hiddenSize (int8 weights) clipped -> 1 (int8 weights). All integer, so the
+    // vectorized and reference evaluation give exactly the same result.
+    class Network {
+    public:
+        // Fails if the file cannot be read or is not a network of these sizes. The file is little
+        // endian: "NNUE", the version, accumulatorSize and hiddenSize as uint32, then the feature
+        // biases and weights (int16), the hidden biases (int32) and weights (int8, one row of
+        // 2 * accumulatorSize per hidden unit), the output bias (int32) and the output weights (int8).
+        [[nodiscard]] static LoadResult load(const std::string& path);
+
+        // In the format load reads, false if it cannot be written
+        bool save(const std::string& path) const;
+
+        // Small random weights, for tests and benchmarks without a trained network
+        [[nodiscard]] static std::unique_ptr<Network> random(uint64_t seed);
+
+        void addFeature(Accumulator& accumulator, Color perspective, size_t feature) const;
+
+        void removeFeature(Accumulator& accumulator, Color perspective, size_t feature) const;
+
+        // From all pieces on board, which must have a king of perspective
+        void refresh(Accumulator& accumulator, Color perspective, const Board& board) const;
+
+        // In centipawns for toMove, no side of accumulator may be stale
+        [[nodiscard]] int32_t evaluate(const Accumulator& accumulator, Color toMove) const;
+
+        // The same evaluation from scratch one value at a time in int32 (without the incremental
+        // accumulator or vector kernels), to check those against
+        [[nodiscard]] int32_t evaluateReference(const Board& board) const;
+
+    private:
+        Network() = default;
+
+        constexpr static uint32_t version = 1;
+
+        alignas(64) std::array<int16_t, accumulatorSize> m_featureBiases{};
+        alignas(64) std::array<std::array<int16_t, accumulatorSize>, featureCount> m_featureWeights{};
+        alignas(64) std::array<std::array<int8_t, 2 * accumulatorSize>, hiddenSize> m_hiddenWeights{};
+        std::array<int32_t, hiddenSize> m_hiddenBiases{};
+        alignas(64) std::array<int8_t, hiddenSize> m_outputWeights{};
+        int32_t m_outputBias = 0;
+    };
+
+    struct LoadResult {
+        std::unique_ptr<Network> network;
+        LoadError error = LoadError::None;
+
+        explicit operator bool() const {
+            return error == LoadError::None;
+        }
+    };
+
+}
@@ -0,0 +1,148 @@
+#include "NNUEKernels.h"
+#include <algorithm>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define NNUE_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define NNUE_SSE2 1
+#endif
+
+namespace Chess::NNUE::Kernels {
+
+    void detail::addScalar(int16_t* values, const int16_t* weights, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            values[i] = static_cast<int16_t>(values[i] + weights[i]);
+        }
+    }
+
+    void detail::subtractScalar(int16_t* values, const int16_t* weights, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            values[i] = static_cast<int16_t>(values[i] - weights[i]);
+        }
+    }
+
+    void detail::clippedReLUScalar(const int16_t* in, uint8_t* out, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            out[i] = static_cast<uint8_t>(std::clamp<int16_t>(in[i], 0, 127));
+        }
+    }
+
+    int32_t detail::dotScalar(const uint8_t* in, const int8_t* weights, size_t size) {
+        int32_t sum = 0;
+        for (size_t i = 0; i < size; ++i) {
+            sum += int32_t(in[i]) * int32_t(weights[i]);
+        }
+        return sum;
+    }
+
+#if defined(NNUE_AVX2) || defined(NNUE_SSE2)
+    static int32_t horizontalSum(__m128i sum) {
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtsi128_si32(sum);
+    }
+#endif
+
+    void add(int16_t* values, const int16_t* weights, size_t size) {
+#if defined(NNUE_AVX2)
+        for (size_t i = 0; i < size; i += 16) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+            __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(values + i), _mm256_add_epi16(v, w));
+        }
+#elif defined(NNUE_SSE2)
+        for (size_t i = 0; i < size; i += 8) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+            __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(values + i), _mm_add_epi16(v, w));
+        }
+#else
+        detail::addScalar(values, weights, size);
+#endif
+    }
+
+    void subtract(int16_t* values, const int16_t* weights, size_t size) {
+#if defined(NNUE_AVX2)
+        for (size_t i = 0; i < size; i += 16) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+            __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(values + i), _mm256_sub_epi16(v, w));
+        }
+#elif defined(NNUE_SSE2)
+        for (size_t i = 0; i < size; i += 8) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+            __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(values + i), _mm_sub_epi16(v, w));
+        }
+#else
+        detail::subtractScalar(values, weights, size);
+#endif
+    }
+
+    void clippedReLU(const int16_t* in, uint8_t* out, size_t size) {
+#if defined(NNUE_AVX2)
+        const __m256i max = _mm256_set1_epi8(127);
+        for (size_t i = 0; i < size; i += 32) {
+            __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+            __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i + 16));
+            // packs within 128 bit lanes, so the middle two quarters have to be swapped back
+            __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(low, high), _MM_SHUFFLE(3, 1, 2, 0));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_min_epu8(packed, max));
+        }
+#elif defined(NNUE_SSE2)
+        const __m128i max = _mm_set1_epi8(127);
+        for (size_t i = 0; i < size; i += 16) {
+            __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 8));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_min_epu8(_mm_packus_epi16(low, high), max));
+        }
+#else
+        detail::clippedReLUScalar(in, out, size);
+#endif
+    }
+
+    int32_t dot(const uint8_t* in, const int8_t* weights, size_t size) {
+#if defined(NNUE_AVX2)
+        const __m256i ones = _mm256_set1_epi16(1);
+        __m256i sum = _mm256_setzero_si256();
+        for (size_t i = 0; i < size; i += 32) {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+            __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i));
+            // pairs of products never saturate int16 since inputs are at most 127
+            __m256i products = _mm256_maddubs_epi16(x, w);
+            sum = _mm256_add_epi32(sum, _mm256_madd_epi16(products, ones));
+        }
+        return horizontalSum(_mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1)));
+#elif defined(NNUE_SSE2)
+        const __m128i zero = _mm_setzero_si128();
+        __m128i sum = _mm_setzero_si128();
+        for (size_t i = 0; i < size; i += 16) {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + i));
+            // SSE2 has no unsigned times signed bytes, so both are widened to int16 first
+            __m128i xLow = _mm_unpacklo_epi8(x, zero);
+            __m128i xHigh = _mm_unpackhi_epi8(x, zero);
+            __m128i wLow = _mm_srai_epi16(_mm_unpacklo_epi8(w, w), 8);
+            __m128i wHigh = _mm_srai_epi16(_mm_unpackhi_epi8(w, w), 8);
+            sum = _mm_add_epi32(sum, _mm_add_epi32(_mm_madd_epi16(xLow, wLow), _mm_madd_epi16(xHigh, wHigh)));
+        }
+        return horizontalSum(sum);
+#else
+        return detail::dotScalar(in, weights, size);
+#endif
+    }
+
+    const char* instructionSet() {
+#if defined(NNUE_AVX2)
+        return "AVX2";
+#elif defined(NNUE_SSE2)
+        return "SSE2";
+#else
+        return "scalar";
+#endif
+    }
+
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// The vectorized parts of the network evaluation, kept apart from everything else so only this file
+// is compiled with AVX2 (see WITH_AVX2) and no inline function of another header gets AVX2 code.
+namespace Chess::NNUE::Kernels {
+
+    // Elements per call must be a multiple of this
+    constexpr size_t blockSize = 32;
+
+    // values[i] += weights[i] (wrapping like int16 arithmetic)
+    void add(int16_t* values, const int16_t* weights, size_t size);
+
+    // values[i] -= weights[i] (wrapping like int16 arithmetic)
+    void subtract(int16_t* values, const int16_t* weights, size_t size);
+
+    // out[i] = clamp(in[i], 0, 127)
+    void clippedReLU(const int16_t* in, uint8_t* out, size_t size);
+
+    // Sum of in[i] * weights[i], every in[i] must be at most 127
+    [[nodiscard]] int32_t dot(const uint8_t* in, const int8_t* weights, size_t size);
+
+    // "AVX2", "SSE2" or "scalar"
+    [[nodiscard]] const char* instructionSet();
+
+    namespace detail {
+        // One element at a time, what the vectorized kernels must match
+        void addScalar(int16_t* values, const int16_t* weights, size_t size);
+        void subtractScalar(int16_t* values, const int16_t* weights, size_t size);
+        void clippedReLUScalar(const int16_t* in, uint8_t* out, size_t size);
+        [[nodiscard]] int32_t dotScalar(const uint8_t* in, const int8_t* weights, size_t size);
+    }
+
+}
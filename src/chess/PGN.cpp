@@ -0,0 +1,422 @@
+#include "PGN.h"
+#include "../util/Assertions.h"
+#include "../util/StringUtil.h"
+#include "../util/Trace.h"
+#include "MoveGen.h"
+#include <algorithm>
+#include <atomic>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace Chess {
+
+    constexpr static std::string_view standardFEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+    std::string_view describePGNError(PGNError error) {
+        switch (error) {
+            case PGNError::None:
+                return "No error";
+            case PGNError::InvalidTag:
+                return "Tag pair must look like [Name \"value\"]";
+            case PGNError::InvalidFEN:
+                return "FEN tag is not a valid position";
+            case PGNError::UnterminatedComment:
+                return "Comment or variation is not closed";
+            case PGNError::InvalidMove:
+                return "Move is not valid SAN or not legal in the position";
+        }
+        return "Unknown error";
+    }
+
+    std::optional<std::string_view> PGNGame::tag(std::string_view name) const {
+        for (const PGNTag& t : tags) {
+            if (t.name == name) {
+                return t.value;
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::string_view PGNGame::startFEN() const {
+        return tag("FEN").value_or(standardFEN);
+    }
+
+    static bool isWhitespace(char c) {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\f' || c == '\v';
+    }
+
+    static bool isDigit(char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    static bool isTagNameChar(char c) {
+        return isDigit(c) || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+    }
+
+    // Characters which end a move (or any other symbol) in move text
+    static bool endsSymbol(char c) {
+        return isWhitespace(c) || c == '{' || c == '}' || c == '(' || c == ')' || c == ';' || c == '[' || c == '$';
+    }
+
+    PGNReader::PGNReader(std::string_view input, size_t baseOffset)
+        : m_input(input),
+          m_baseOffset(baseOffset) {
+    }
+
+    void PGNReader::setError(PGNError error, size_t position) {
+        // only the first error is kept
+        if (m_game.error == PGNError::None) {
+            m_game.error = error;
+            m_game.errorOffset = m_baseOffset + position;
+        }
+    }
+
+    void PGNReader::skipWhitespace() {
+        while (!atEnd() && isWhitespace(m_input[m_position])) {
+            ++m_position;
+        }
+    }
+
+    void PGNReader::skipLine() {
+        size_t end = util::findFirstOf(m_input, '\n', m_position);
+        m_position = end == std::string_view::npos ? m_input.size() : end + 1;
+    }
+
+    bool PGNReader::skipComment() {
+        ASSERT(m_input[m_position] == '{');
+        size_t end = util::findFirstOf(m_input, '}', m_position);
+        if (end == std::string_view::npos) {
+            setError(PGNError::UnterminatedComment, m_position);
+            m_position = m_input.size();
+            return false;
+        }
+        m_position = end + 1;
+        return true;
+    }
+
+    bool PGNReader::skipVariation() {
+        ASSERT(m_input[m_position] == '(');
+        size_t start = m_position;
+        uint32_t depth = 0;
+        while (!atEnd()) {
+            char c = m_input[m_position];
+            if (c == '{') {
+                if (!skipComment()) {
+                    return false;
+                }
+                continue;
+            }
+            if (c == ';') {
+                skipLine();
+                continue;
+            }
+            ++m_position;
+            if (c == '(') {
+                ++depth;
+            } else if (c == ')' && --depth == 0) {
+                return true;
+            }
+        }
+        setError(PGNError::UnterminatedComment, start);
+        return false;
+    }
+
+    void PGNReader::readTags() {
+        while (!atEnd() && m_input[m_position] == '[') {
+            size_t start = m_position;
+            ++m_position;
+            skipWhitespace();
+
+            size_t nameStart = m_position;
+            while (!atEnd() && isTagNameChar(m_input[m_position])) {
+                ++m_position;
+            }
+            std::string_view name = m_input.substr(nameStart, m_position - nameStart);
+            skipWhitespace();
+
+            bool valid = !name.empty() && !atEnd() && m_input[m_position] == '"';
+            size_t valueStart = ++m_position;
+            while (valid && !atEnd() && m_input[m_position] != '"') {
+                if (m_input[m_position] == '\\') {
+                    ++m_position;
+                } else if (m_input[m_position] == '\n') {
+                    valid = false;
+                }
+                ++m_position;
+            }
+
+            if (valid && !atEnd()) {
+                std::string_view value = m_input.substr(valueStart, m_position - valueStart);
+                ++m_position;
+                skipWhitespace();
+                if (!atEnd() && m_input[m_position] == ']') {
+                    ++m_position;
+                    m_game.tags.push_back(PGNTag{name, value});
+                    skipWhitespace();
+                    continue;
+                }
+            }
+
+            setError(PGNError::InvalidTag, start);
+            m_position = start;
+            skipLine();
+            skipWhitespace();
+        }
+    }
+
+    void PGNReader::readMoveText() {
+        // cannot replay anything after an invalid move or start position, but still look for the end of the game
+        bool replaying = m_game.error != PGNError::InvalidFEN;
+        while (true) {
+            skipWhitespace();
+            if (atEnd()) {
+                return;
+            }
+
+            char c = m_input[m_position];
+            std::string_view rest = m_input.substr(m_position);
+
+            switch (c) {
+                case '[':
+                    // tags of the next game, this one did not have a termination marker
+                    return;
+                case '{':
+                    skipComment();
+                    continue;
+                case ';':
+                case '%':
+                    skipLine();
+                    continue;
+                case '(':
+                    skipVariation();
+                    continue;
+                case '$':
+                    ++m_position;
+                    while (!atEnd() && isDigit(m_input[m_position])) {
+                        ++m_position;
+                    }
+                    continue;
+                case ')':
+                case '}':
+                case '.':
+                    ++m_position;
+                    continue;
+                case '*':
+                    ++m_position;
+                    m_game.result = GameResult::Final::InProgress;
+                    return;
+                default:
+                    break;
+            }
+
+            if (isDigit(c)) {
+                if (rest.starts_with("1-0")) {
+                    m_position += 3;
+                    m_game.result = GameResult::Final::WhiteWin;
+                    return;
+                }
+                if (rest.starts_with("0-1")) {
+                    m_position += 3;
+                    m_game.result = GameResult::Final::BlackWin;
+                    return;
+                }
+                if (rest.starts_with("1/2-1/2")) {
+                    m_position += 7;
+                    m_game.result = GameResult::Final::Draw;
+                    return;
+                }
+                if (!rest.starts_with("0-0")) {
+                    // move number indication, the periods are skipped separately
+                    while (!atEnd() && isDigit(m_input[m_position])) {
+                        ++m_position;
+                    }
+                    continue;
+                }
+            }
+
+            size_t start = m_position;
+            while (!atEnd() && !endsSymbol(m_input[m_position])) {
+                ++m_position;
+            }
+            std::string_view token = m_input.substr(start, m_position - start);
+            while (!token.empty() && (token.back() == '!' || token.back() == '?')) {
+                token.remove_suffix(1);
+            }
+
+            if (!replaying) {
+                continue;
+            }
+
+            // castling with zeros is not valid PGN but common enough to accept
+            if (token.starts_with("0-0-0")) {
+                token = token.size() > 5 ? std::string_view("O-O-O+") : std::string_view("O-O-O");
+            } else if (token.starts_with("0-0")) {
+                token = token.size() > 3 ? std::string_view("O-O+") : std::string_view("O-O");
+            }
+
+            auto move = m_game.board.parseSANMove(token);
+            if (!move.has_value()) {
+                setError(PGNError::InvalidMove, start);
+                replaying = false;
+                continue;
+            }
+            m_game.board.makeMove(*move);
+            m_game.moves.push_back(*move);
+        }
+    }
+
+    bool PGNReader::next() {
+        TRACE_SCOPE("PGNReader::next");
+        m_game.tags.clear();
+        m_game.moves.clear();
+        m_game.result = GameResult::Final::InProgress;
+        m_game.error = PGNError::None;
+        m_game.errorOffset = 0;
+
+        // text between games which is not part of a game
+        while (true) {
+            skipWhitespace();
+            if (atEnd()) {
+                return false;
+            }
+            char c = m_input[m_position];
+            if (c == '%' || c == ';') {
+                skipLine();
+            } else if (c == '{') {
+                skipComment();
+            } else {
+                break;
+            }
+        }
+
+        m_game.offset = m_baseOffset + m_position;
+        readTags();
+
+        std::string_view fen = m_game.startFEN();
+        if (!m_game.board.parseFEN(fen)) {
+            setError(PGNError::InvalidFEN, m_game.offset - m_baseOffset);
+            // keep a valid board to skip the move text with
+            [[maybe_unused]] auto standard = m_game.board.parseFEN(standardFEN);
+            ASSERT(standard);
+        }
+
+        readMoveText();
+        return true;
+    }
+
+    std::string_view pgnResultMarker(GameResult::Final result) {
+        switch (result) {
+            case GameResult::Final::WhiteWin:
+                return "1-0";
+            case GameResult::Final::BlackWin:
+                return "0-1";
+            case GameResult::Final::Draw:
+                return "1/2-1/2";
+            case GameResult::Final::InProgress:
+                break;
+        }
+        return "*";
+    }
+
+    void writePGN(std::ostream& out, const PGNGame& game) {
+        constexpr size_t maxLineLength = 80;
+
+        for (const PGNTag& tag : game.tags) {
+            out << '[' << tag.name << " \"" << tag.value << "\"]\n";
+        }
+        out << '\n';
+
+        Board board = Board::emptyBoard();
+        [[maybe_unused]] bool validStart = static_cast<bool>(board.parseFEN(game.startFEN()));
+        ASSERT(validStart);
+
+        size_t lineLength = 0;
+        auto writeToken = [&](std::string_view token) {
+            if (lineLength > 0 && lineLength + 1 + token.size() > maxLineLength) {
+                out << '\n';
+                lineLength = 0;
+            } else if (lineLength > 0) {
+                out << ' ';
+                ++lineLength;
+            }
+            out << token;
+            lineLength += token.size();
+        };
+
+        for (size_t i = 0; i < game.moves.size(); ++i) {
+            Move move = game.moves[i];
+            if (board.colorToMove() == Color::White || i == 0) {
+                std::string number = std::to_string(board.fullMoves());
+                number += board.colorToMove() == Color::White ? "." : "...";
+                writeToken(number);
+            }
+            MoveList moves = generateAllMoves(board);
+            ASSERT(moves.contains(move));
+            writeToken(board.moveToSAN(move, moves));
+            board.makeMove(move);
+        }
+        writeToken(pgnResultMarker(game.result));
+        out << "\n\n";
+    }
+
+    std::vector<std::string_view> splitPGNGames(std::string_view input, size_t count) {
+        std::vector<std::string_view> parts;
+        size_t start = 0;
+        for (size_t i = 1; i <= count && start < input.size(); ++i) {
+            size_t end = input.size();
+            if (i < count) {
+                // find the first tag line which does not directly follow another tag line
+                size_t search = std::max(start, input.size() / count * i);
+                while (true) {
+                    size_t lineStart = input.find("\n[", search);
+                    if (lineStart == std::string_view::npos) {
+                        break;
+                    }
+                    ++lineStart;
+                    // a tag line at the very start has no line before it
+                    size_t previousLine = lineStart >= 2 ? input.rfind('\n', lineStart - 2) : std::string_view::npos;
+                    previousLine = previousLine == std::string_view::npos ? 0 : previousLine + 1;
+                    if (lineStart > start && input[previousLine] != '[') {
+                        end = lineStart;
+                        break;
+                    }
+                    search = lineStart;
+                }
+            }
+            parts.push_back(input.substr(start, end - start));
+            start = end;
+        }
+        return parts;
+    }
+
+    size_t readPGNParallel(std::string_view input, size_t threads,
+                           const std::function<void(const PGNGame&, size_t)>& func) {
+        ASSERT(threads > 0);
+        auto parts = splitPGNGames(input, threads);
+        if (parts.size() == 1) {
+            return PGNReader(input).forEachGame([&func](const PGNGame& game) {
+                func(game, 0);
+            });
+        }
+
+        std::atomic<size_t> totalGames = 0;
+        std::vector<std::thread> workers;
+        workers.reserve(parts.size());
+        for (size_t i = 0; i < parts.size(); ++i) {
+            workers.emplace_back([&, i] {
+                size_t offset = static_cast<size_t>(parts[i].data() - input.data());
+                size_t games = PGNReader(parts[i], offset).forEachGame([&func, i](const PGNGame& game) {
+                    func(game, i);
+                });
+                totalGames.fetch_add(games, std::memory_order_relaxed);
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        return totalGames.load();
+    }
+
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "Board.h"
+#include "Move.h"
+#include "players/Game.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace Chess {
+
+    enum class PGNError : uint8_t {
+        None = 0,
+        InvalidTag,
+        InvalidFEN,
+        UnterminatedComment,
+        InvalidMove,
+    };
+
+    [[nodiscard]] std::string_view describePGNError(PGNError error);
+
+    struct PGNTag {
+        std::string_view name;
+        // raw text between the quotes, escaped quotes and backslashes are kept as is
+        std::string_view value;
+    };
+
+    // A game as read by PGNReader. The tags are views into the input and together with the
+    // board and moves are only valid until the reader moves on to the next game.
+    struct PGNGame {
+        std::vector<PGNTag> tags;
+        std::vector<Move> moves;
+        // position after the last move, or the last valid move if there is an error
+        Board board = Board::emptyBoard();
+        // from the game termination marker, '*' or a missing marker is InProgress
+        GameResult::Final result = GameResult::Final::InProgress;
+
+        // byte offset of the start of the game in the (whole) input
+        size_t offset = 0;
+
+        PGNError error = PGNError::None;
+        size_t errorOffset = 0;
+
+        [[nodiscard]] std::optional<std::string_view> tag(std::string_view name) const;
+
+        // The FEN tag if present otherwise the standard start position
+        [[nodiscard]] std::string_view startFEN() const;
+    };
+
+    // Reads games one by one from PGN text (export or import format) without copying the input.
+    // Comments, variations, NAGs, move numbers and move annotations ('!', '?') are skipped and
+    // every move is replayed on the board. Games with an error are still returned (with error
+    // set) and reading continues with the next game.
+    class PGNReader {
+    public:
+        // baseOffset is added to all reported offsets, useful when reading a part of a larger input
+        explicit PGNReader(std::string_view input, size_t baseOffset = 0);
+
+        // Returns false when there are no more games
+        bool next();
+
+        [[nodiscard]] const PGNGame& game() const {
+            return m_game;
+        }
+
+        template<typename F>
+        size_t forEachGame(F&& func) {
+            size_t games = 0;
+            while (next()) {
+                func(static_cast<const PGNGame&>(m_game));
+                ++games;
+            }
+            return games;
+        }
+
+    private:
+        void skipWhitespace();
+        void skipLine();
+        bool skipComment();
+        bool skipVariation();
+
+        void readTags();
+        void readMoveText();
+
+        [[nodiscard]] bool atEnd() const {
+            return m_position >= m_input.size();
+        }
+
+        void setError(PGNError error, size_t position);
+
+        std::string_view m_input;
+        size_t m_position = 0;
+        size_t m_baseOffset = 0;
+        PGNGame m_game;
+    };
+
+    // "1-0", "0-1", "1/2-1/2" or "*"
+    [[nodiscard]] std::string_view pgnResultMarker(GameResult::Final result);
+
+    // Writes the game in export format: tags, a blank line and the move text (in lines of at
+    // most 80 characters) ending with the result. The moves must all be legal from startFEN().
+    void writePGN(std::ostream& out, const PGNGame& game);
+
+    // Splits the input in at most count parts which all start at the first tag of a game.
+    // Does not look into comments so a comment with a line starting with '[' may be split.
+    [[nodiscard]] std::vector<std::string_view> splitPGNGames(std::string_view input, size_t count);
+
+    // Reads all games with a reader per part on separate threads. The func is called concurrently
+    // with every game and the index of the thread which read it, returns the amount of games.
+    size_t readPGNParallel(std::string_view input, size_t threads,
+                           const std::function<void(const PGNGame&, size_t)>& func);
+
+}
@@ -0,0 +1,114 @@
+#include "PackedBoard.h"
+#include "Board.h"
+#include "BitBoard.h"
+#include <limits>
+
+namespace Chess {
+
+    constexpr static size_t occupancyOffset = 0;
+    constexpr static size_t piecesOffset = 8;
+    constexpr static size_t flagsOffset = 24;
+    constexpr static size_t enPassantOffset = 25;
+    constexpr static size_t clockOffset = 26;
+    constexpr static size_t fullMovesOffset = 28;
+
+    constexpr static uint8_t blackNibble = 0b1000;
+    constexpr static uint8_t typeMask = 0b0111;
+
+    template<typename T>
+    static void writeLE(std::array<uint8_t, PackedBoard::size>& bytes, size_t offset, T value) {
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            bytes[offset + i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+    }
+
+    template<typename T>
+    static T readLE(const std::array<uint8_t, PackedBoard::size>& bytes, size_t offset) {
+        T value = 0;
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            value |= static_cast<T>(static_cast<T>(bytes[offset + i]) << (8 * i));
+        }
+        return value;
+    }
+
+    // Piece::IntType has the color as 0b01 or 0b10 in bits 4-5 and the type in bits 0-2
+    static_assert(static_cast<uint8_t>(Color::White) == 0b010000 && static_cast<uint8_t>(Color::Black) == 0b100000);
+
+    std::optional<PackedBoard> Board::pack() const {
+        if (BB::countBits(piecesBB) > PackedBoard::maxPieces
+            || m_halfMovesSinceCaptureOrPawn > std::numeric_limits<uint16_t>::max()) {
+            return std::nullopt;
+        }
+
+        PackedBoard packed;
+        writeLE<uint64_t>(packed.bytes, occupancyOffset, piecesBB);
+
+        BitBoard occupied = piecesBB;
+        for (uint32_t i = 0; occupied != 0; ++i) {
+            Piece::IntType value = m_pieces[BB::popLsb(occupied)];
+            auto nibble = static_cast<uint8_t>((value & typeMask) | ((value >> 2) & blackNibble));
+            packed.bytes[piecesOffset + i / 2] |= static_cast<uint8_t>(nibble << ((i & 1) * 4));
+        }
+
+        packed.bytes[flagsOffset] = static_cast<uint8_t>((m_nextTurnColor == Color::Black)
+                                                         | (static_cast<uint8_t>(m_castlingRights) << 1));
+        packed.bytes[enPassantOffset] = m_enPassant.value_or(PackedBoard::noEnPassant);
+        writeLE<uint16_t>(packed.bytes, clockOffset, static_cast<uint16_t>(m_halfMovesSinceCaptureOrPawn));
+        writeLE<uint32_t>(packed.bytes, fullMovesOffset, fullMoves());
+        return packed;
+    }
+
+    bool Board::unpack(const PackedBoard& packed) {
+        clearForParsing();
+
+        auto occupancy = readLE<uint64_t>(packed.bytes, occupancyOffset);
+        if (BB::countBits(occupancy) > PackedBoard::maxPieces) {
+            return false;
+        }
+        for (uint32_t i = 0; occupancy != 0; ++i) {
+            BoardIndex index = BB::popLsb(occupancy);
+            auto nibble = static_cast<uint8_t>((packed.bytes[piecesOffset + i / 2] >> ((i & 1) * 4)) & 0xf);
+            auto type = static_cast<uint8_t>(nibble & typeMask);
+            if (type == static_cast<uint8_t>(Piece::Type::None) || type > static_cast<uint8_t>(Piece::Type::Knight)) {
+                return false;
+            }
+            auto value = static_cast<Piece::IntType>(type | (static_cast<uint8_t>(Color::White) << (nibble >> 3)));
+            setPiece(index, Piece::fromInt(value));
+        }
+
+        uint8_t flags = packed.bytes[flagsOffset];
+        if (flags >> 5 != 0) {
+            return false;
+        }
+        m_nextTurnColor = (flags & 1) ? Color::Black : Color::White;
+        m_castlingRights = static_cast<CastlingRight>(flags >> 1);
+        if (!castlingPiecesPresent()) {
+            return false;
+        }
+
+        if (uint8_t enPassant = packed.bytes[enPassantOffset]; enPassant != PackedBoard::noEnPassant) {
+            if (enPassant >= size * size) {
+                return false;
+            }
+            auto [col, row] = indexToColumnRow(enPassant);
+            Color lastMoveColor = opposite(m_nextTurnColor);
+            BoardIndex expectedRow = lastMoveColor == Color::White ? 2 : size - 1 - 2;
+            BoardIndex pawnRow = row + (lastMoveColor == Color::White ? 1 : -1);
+            if (row != expectedRow || pieceAt(col, row).has_value()
+                || pieceAt(col, pawnRow) != Piece{Piece::Type::Pawn, lastMoveColor}) {
+                return false;
+            }
+            m_enPassant = enPassant;
+        }
+
+        m_halfMovesSinceCaptureOrPawn = readLE<uint16_t>(packed.bytes, clockOffset);
+        auto fullMoves = readLE<uint32_t>(packed.bytes, fullMovesOffset);
+        if (fullMoves == 0 || fullMoves >= (std::numeric_limits<uint32_t>::max() / 2u - 3u)) {
+            return false;
+        }
+        m_halfMovesMade = (fullMoves - 1) * 2 + (m_nextTurnColor == Color::Black);
+        m_hash = computeHash();
+        return true;
+    }
+
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace Chess {
+
+    // A position in 32 bytes, all multi byte values little endian so it can be written to disk as is:
+    //   0-7    occupancy bitboard, bit i set if square i (a1 = 0, h8 = 63) has a piece
+    //   8-23   4 bits per occupied square in square order, low nibble first:
+    //          bit 3 set for black, bits 0-2 the Piece::Type
+    //   24     bit 0 set if black is to move, bits 1-4 the CastlingRight flags
+    //   25     en passant square index or noEnPassant
+    //   26-27  half moves since capture or pawn move
+    //   28-31  full move number
+    // Only the position is stored, the move history (and so repetitions) is not.
+    struct PackedBoard {
+        constexpr static size_t size = 32;
+        constexpr static size_t maxPieces = 32;
+        constexpr static uint8_t noEnPassant = 0xff;
+
+        std::array<uint8_t, size> bytes{};
+
+        bool operator==(const PackedBoard&) const = default;
+    };
+
+    static_assert(sizeof(PackedBoard) == PackedBoard::size);
+
+}
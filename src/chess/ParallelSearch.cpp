@@ -0,0 +1,159 @@
+#include "ParallelSearch.h"
+#include "../util/Assertions.h"
+#include "../util/Trace.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <utility>
+
+namespace Chess {
+
+    static SearchLimit threadLimit(SearchLimit limit, size_t threads) {
+        switch (limit.type) {
+            case SearchLimit::Nodes:
+                return SearchLimit::nodes(std::max<uint32_t>(limit.val / threads, 1u));
+            case SearchLimit::Depth:
+            case SearchLimit::MoveTime:
+                return limit;
+        }
+        return limit;
+    }
+
+    ParallelSearch::ParallelSearch(SearchLimit limit, size_t threads, size_t tableMegabytes)
+        : m_table(tableMegabytes),
+          m_depthLimited(limit.type == SearchLimit::Depth) {
+        ASSERT(threads > 0);
+        for (size_t i = 0; i < threads; ++i) {
+            m_searches.push_back(std::make_unique<Search>(threadLimit(limit, threads), m_table));
+            m_searches.back()->setDepthSkew(i % 2);
+        }
+    }
+
+    void ParallelSearch::stop() {
+        m_stopped.store(true);
+        for (auto& search : m_searches) {
+            search->stop();
+        }
+    }
+
+    void ParallelSearch::clearStop() {
+        m_stopped.store(false);
+        for (auto& search : m_searches) {
+            search->clearStop();
+        }
+    }
+
+    void ParallelSearch::setNetwork(const NNUE::Network* network) {
+        for (auto& search : m_searches) {
+            search->setNetwork(network);
+        }
+    }
+
+    void ParallelSearch::setMultiPV(size_t lines) {
+        m_multiPV = lines;
+        m_searches.front()->setMultiPV(lines);
+    }
+
+    SearchResult ParallelSearch::run(const Board& board, const Search::IterationCallback& onIteration) {
+        TRACE_SCOPE("ParallelSearch::run");
+        m_table.newSearch();
+        // only the helpers are stopped by the previous run, a stop which arrives in between is
+        // passed on again by the check
+        for (size_t i = 1; i < m_searches.size(); ++i) {
+            m_searches[i]->clearStop();
+        }
+        if (m_stopped.load()) {
+            stop();
+        }
+        std::vector<SearchResult> results(m_searches.size());
+
+        std::vector<std::thread> helpers;
+        for (size_t i = 1; i < m_searches.size(); ++i) {
+            helpers.emplace_back([&, i] {
+                results[i] = m_searches[i]->run(board);
+            });
+        }
+
+        results[0] = m_searches[0]->run(board, onIteration);
+
+        // helpers stop at the same depth, stopping them early would only leave fewer complete votes
+        if (!m_depthLimited) {
+            for (size_t i = 1; i < m_searches.size(); ++i) {
+                m_searches[i]->stop();
+            }
+        }
+        for (auto& helper : helpers) {
+            helper.join();
+        }
+
+        SearchResult selected = selectBestThread(results);
+        // a vote only picks one move, the ranking of the lines comes from the main search
+        if (m_multiPV > 1) {
+            uint64_t nodes = selected.nodes;
+            selected = std::move(results[0]);
+            selected.nodes = nodes;
+        }
+        return selected;
+    }
+
+    SearchResult selectBestThread(const std::vector<SearchResult>& results) {
+        ASSERT(!results.empty());
+        uint64_t totalNodes = 0;
+        Score minScore = infiniteScore;
+        for (const SearchResult& result : results) {
+            totalNodes += result.nodes;
+            if (result.depth > 0) {
+                minScore = std::min(minScore, result.score);
+            }
+        }
+
+        std::vector<std::pair<Move, int64_t>> votes;
+        auto findVotes = [&votes](Move move) {
+            return std::find_if(votes.begin(), votes.end(), [move](const auto& vote) {
+                return vote.first == move;
+            });
+        };
+        for (const SearchResult& result : results) {
+            if (result.depth == 0) {
+                continue;
+            }
+            int64_t vote = int64_t(result.score - minScore + 14) * result.depth;
+            if (auto it = findVotes(result.bestMove); it != votes.end()) {
+                it->second += vote;
+            } else {
+                votes.emplace_back(result.bestMove, vote);
+            }
+        }
+        auto votesFor = [&](Move move) -> int64_t {
+            auto it = findVotes(move);
+            return it == votes.end() ? 0 : it->second;
+        };
+
+        auto isWinning = [](const SearchResult& result) {
+            return result.depth > 0 && isMateScore(result.score) && result.score > 0;
+        };
+
+        const SearchResult* best = &results[0];
+        for (const SearchResult& result : results) {
+            if (result.depth == 0) {
+                continue;
+            }
+            if (isWinning(*best)) {
+                // the fastest mate
+                if (result.score > best->score) {
+                    best = &result;
+                }
+            } else if (isWinning(result) || best->depth == 0
+                       || votesFor(result.bestMove) > votesFor(best->bestMove)
+                       || (result.bestMove == best->bestMove && result.depth > best->depth)) {
+                best = &result;
+            }
+        }
+
+        SearchResult selected = *best;
+        selected.nodes = totalNodes;
+        selected.elapsed = results[0].elapsed;
+        return selected;
+    }
+
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Search.h"
+#include "TranspositionTable.h"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace Chess {
+
+    // Lazy SMP: every thread runs its own Search on its own copy of the board and they only share
+    // the transposition table, so threads mostly profit from each others results through it. Half
+    // of the helper threads search one ply deeper to spread the threads over neighbouring depths.
+    // The calling thread runs the main search, when it finishes all helpers are stopped and the
+    // final move is voted on by all threads weighted by their depth and score. With a depth limit
+    // the helpers search to the same depth and are waited for instead, so no result is deeper
+    // than the limit.
+    class ParallelSearch {
+    public:
+        // A node limit is split evenly over the threads, with 1 thread this is exactly Search
+        ParallelSearch(SearchLimit limit, size_t threads, size_t tableMegabytes = Search::defaultTableSize);
+
+        // Nodes of the result are the total of all threads, onIteration is only called for the
+        // iterations of the main search (with only its nodes)
+        [[nodiscard]] SearchResult run(const Board& board, const Search::IterationCallback& onIteration = {});
+
+        // May be called from another thread, stops all threads. Like Search::stop it lasts until
+        // clearStop.
+        void stop();
+
+        // Not while run is running
+        void clearStop();
+
+        // For all threads, see Search::setNetwork
+        void setNetwork(const NNUE::Network* network);
+
+        // Only the main search searches multiple lines and its ranking is the result, helpers keep
+        // searching the best line to fill the table (see Search::setMultiPV)
+        void setMultiPV(size_t lines);
+
+        [[nodiscard]] size_t threads() const {
+            return m_searches.size();
+        }
+
+    private:
+        TranspositionTable m_table;
+        // the first is the main search
+        std::vector<std::unique_ptr<Search>> m_searches;
+        size_t m_multiPV = 1;
+        bool m_depthLimited = false;
+        std::atomic<bool> m_stopped = false;
+    };
+
+    // The result the threads of a parallel search agree on: every thread votes for its best move
+    // with its depth times how much better its score is than the worst one. Mates are preferred
+    // over any vote. Results must not be empty and the nodes of all are added up.
+    [[nodiscard]] SearchResult selectBestThread(const std::vector<SearchResult>& results);
+
+}
@@ -0,0 +1,131 @@
+#include "PawnStructure.h"
+#include "BitBoard.h"
+#include <algorithm>
+#include <bit>
+
+namespace Chess {
+
+    namespace {
+        BitBoard northFill(BitBoard bb) {
+            bb |= bb << 8u;
+            bb |= bb << 16u;
+            return bb | (bb << 32u);
+        }
+
+        BitBoard southFill(BitBoard bb) {
+            bb |= bb >> 8u;
+            bb |= bb >> 16u;
+            return bb | (bb >> 32u);
+        }
+
+        // The squares themselves and everything in front of them as seen from color
+        template<Color color>
+        BitBoard frontFill(BitBoard bb) {
+            return color == Color::White ? northFill(bb) : southFill(bb);
+        }
+
+        template<Color color>
+        BitBoard forward(BitBoard bb) {
+            return color == Color::White ? bb << 8u : bb >> 8u;
+        }
+
+        BitBoard adjacentFiles(BitBoard bb) {
+            return BB::shift<BB::Left>(bb) | BB::shift<BB::Right>(bb);
+        }
+
+        template<Color color>
+        PST::TaperedScore structureFor(BitBoard own, BitBoard their) {
+            constexpr Color opponent = opposite(color);
+            BitBoard files = northFill(own) | southFill(own);
+
+            // every pawn with another one behind it counts, so three on a file count twice
+            BitBoard doubled = own & frontFill<color>(forward<color>(own));
+            BitBoard isolated = own & ~adjacentFiles(files);
+
+            // squares their pawns still pass or attack on the way to promotion
+            BitBoard theirFront = frontFill<opponent>(forward<opponent>(their));
+            BitBoard passed = own & ~(theirFront | adjacentFiles(theirFront));
+
+            // cannot be defended by a pawn on a neighbouring file (they are all ahead) and cannot
+            // advance safely, isolated pawns are already counted as such
+            BitBoard theirAttacks = adjacentFiles(forward<opponent>(their));
+            BitBoard backward = own & adjacentFiles(files) & ~frontFill<color>(adjacentFiles(own))
+                              & forward<opponent>(theirAttacks);
+
+            PST::TaperedScore score = PawnTerms::doubled * BB::countBits(doubled)
+                                    + PawnTerms::isolated * BB::countBits(isolated)
+                                    + PawnTerms::backward * BB::countBits(backward);
+            while (passed) {
+                BoardIndex row = BB::popLsb(passed) / Board::size;
+                score += PawnTerms::passed[color == Color::White ? row : Board::size - 1 - row];
+            }
+            return score;
+        }
+    }
+
+    PST::TaperedScore pawnStructureScore(BitBoard whitePawns, BitBoard blackPawns) {
+        return structureFor<Color::White>(whitePawns, blackPawns) - structureFor<Color::Black>(blackPawns, whitePawns);
+    }
+
+    PST::TaperedScore pawnShieldScore(Color color, BoardIndex kingSquare, BitBoard ownPawns) {
+        BoardIndex row = kingSquare / Board::size;
+        if (row != Board::homeRow(color) && row != Board::pawnHomeRow(color)) {
+            return {};
+        }
+        // a king in the corner is shielded by the same files as one next to it
+        BoardIndex col = std::clamp<BoardIndex>(kingSquare % Board::size, 1, Board::size - 2);
+        BitBoard files = (BB::col0 << (col - 1u)) | (BB::col0 << col) | (BB::col0 << (col + 1u));
+        BitBoard near = BB::row0 << (Board::size * (row + Board::pawnDirection(color)));
+        BitBoard far = BB::row0 << (Board::size * (row + 2 * Board::pawnDirection(color)));
+        return PawnTerms::shieldNear * BB::countBits(ownPawns & files & near)
+             + PawnTerms::shieldFar * BB::countBits(ownPawns & files & far);
+    }
+
+    static BoardIndex kingIndex(const Board& board, Color color) {
+        auto [col, row] = board.kingSquare(color);
+        return col + Board::size * row;
+    }
+
+    PST::TaperedScore pawnScore(const Board& board) {
+        BitBoard white = board.pawnBitboard(Color::White);
+        BitBoard black = board.pawnBitboard(Color::Black);
+        return pawnStructureScore(white, black)
+             + pawnShieldScore(Color::White, kingIndex(board, Color::White), white)
+             - pawnShieldScore(Color::Black, kingIndex(board, Color::Black), black);
+    }
+
+    PawnHashTable::PawnHashTable(size_t entries)
+        : m_entries(std::bit_ceil(std::max<size_t>(entries, 1))),
+          m_mask(m_entries.size() - 1) {
+    }
+
+    PST::TaperedScore PawnHashTable::probe(const Board& board) {
+        Entry& entry = m_entries[board.pawnHash() & m_mask];
+        if (entry.key != board.pawnHash()) {
+            entry = Entry{};
+            entry.key = board.pawnHash();
+            entry.structure = pawnStructureScore(board.pawnBitboard(Color::White), board.pawnBitboard(Color::Black));
+        }
+
+        PST::TaperedScore score = entry.structure;
+        for (Color color : {Color::White, Color::Black}) {
+            size_t side = color == Color::Black;
+            BoardIndex king = kingIndex(board, color);
+            if (entry.kingSquares[side] != king) {
+                entry.kingSquares[side] = king;
+                entry.shields[side] = pawnShieldScore(color, king, board.pawnBitboard(color));
+            }
+            if (color == Color::White) {
+                score += entry.shields[side];
+            } else {
+                score -= entry.shields[side];
+            }
+        }
+        return score;
+    }
+
+    void PawnHashTable::clear() {
+        std::fill(m_entries.begin(), m_entries.end(), Entry{});
+    }
+
+}
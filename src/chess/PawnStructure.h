@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Board.h"
+#include "PieceSquareTables.h"
+#include "Types.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Chess {
+
+    namespace PawnTerms {
+        // Per pawn, in centipawns for the side owning the pawns
+        constexpr PST::TaperedScore doubled = {-10, -25};
+        constexpr PST::TaperedScore isolated = {-8, -15};
+        constexpr PST::TaperedScore backward = {-8, -12};
+        // Indexed by the row of the pawn as seen from its own side
+        constexpr std::array<PST::TaperedScore, 8> passed = {{
+                {0, 0}, {0, 10}, {5, 15}, {10, 25}, {20, 45}, {40, 80}, {70, 130}, {0, 0}}};
+        // Own pawns on the three files around a king still on its first two rows, one or two rows
+        // ahead of it
+        constexpr PST::TaperedScore shieldNear = {15, 0};
+        constexpr PST::TaperedScore shieldFar = {7, 0};
+    }
+
+    // Doubled, isolated, backward and passed pawns of both sides from the point of view of white,
+    // computed with fills over the pawn bitboards so it only depends on the pawns (Board::pawnHash)
+    [[nodiscard]] PST::TaperedScore pawnStructureScore(BitBoard whitePawns, BitBoard blackPawns);
+
+    // Pawn shield of the king of color on kingSquare, for that color
+    [[nodiscard]] PST::TaperedScore pawnShieldScore(Color color, BoardIndex kingSquare, BitBoard ownPawns);
+
+    // Structure plus both shields from the point of view of white, without any caching
+    [[nodiscard]] PST::TaperedScore pawnScore(const Board& board);
+
+    // Direct mapped cache of pawnScore keyed by Board::pawnHash, so the structure is only recomputed
+    // after a pawn moved. The shields also depend on the kings, every entry keeps them for the king
+    // squares it last saw. Not thread safe, every searching thread has its own table.
+    class PawnHashTable {
+    public:
+        constexpr static size_t defaultEntries = 1u << 14u;
+
+        // rounded up to a power of two
+        explicit PawnHashTable(size_t entries = defaultEntries);
+
+        // Same as pawnScore(board)
+        [[nodiscard]] PST::TaperedScore probe(const Board& board);
+
+        void clear();
+
+    private:
+        struct Entry {
+            // an empty entry is the entry of no pawns (key 0) with no shields yet
+            uint64_t key = 0;
+            PST::TaperedScore structure{};
+            std::array<BoardIndex, 2> kingSquares = {noSquare, noSquare};
+            std::array<PST::TaperedScore, 2> shields{};
+        };
+
+        constexpr static BoardIndex noSquare = 64;
+
+        std::vector<Entry> m_entries;
+        size_t m_mask;
+    };
+
+}
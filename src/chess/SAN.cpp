@@ -1,6 +1,8 @@
 #include "Board.h"
+#include "SANList.h"
 #include "Types.h"
 #include "../util/Assertions.h"
+#include "BitBoard.h"
 #include "Move.h"
 #include "MoveGen.h"
 #include "Piece.h"
@@ -48,11 +50,8 @@ namespace Chess {
             return std::nullopt;
         }
 
-        if (!std::islower(vw[0]) || !std::isdigit(vw[1])) {
-            return std::nullopt;
-        }
-
-        if (vw[0] > 'h' || vw[1] == '9' || vw[1] == '0') {
+        // plain comparisons since std::islower is undefined for negative chars in untrusted input
+        if (vw[0] < 'a' || vw[0] > 'h' || vw[1] < '1' || vw[1] > '8') {
             return std::nullopt;
         }
 
@@ -114,224 +113,321 @@ namespace Chess {
         return sanPieceChar[static_cast<uint8_t>(tp)];
     }
 
-    std::string Board::moveToSAN(Move mv, const MoveList& list) const {
-        ASSERT(list.contains(mv));
+    size_t Board::writeSAN(char* out, Move mv, BitBoard sameDestination) const {
         ASSERT(pieceAt(mv.fromPosition).has_value());
+        char* head = out;
 
         if (mv.flag == Move::Flag::Castling) {
             auto [toCol, toRow] = mv.colRowToPosition();
             ASSERT(toRow == homeRow(colorToMove()));
-            if (toCol > kingCol) {
+            *head++ = 'O';
+            *head++ = '-';
+            *head++ = 'O';
+            if (toCol < kingCol) {
+                ASSERT(toCol == queenSideRookCol);
+                *head++ = '-';
+                *head++ = 'O';
+            } else {
                 ASSERT(toCol == kingSideRookCol);
-                return "O-O";
             }
-            ASSERT(toCol == queenSideRookCol);
-            return "O-O-O";
+            return head - out;
         }
 
-
         Piece tp = *pieceAt(mv.fromPosition);
-        std::string destination = indexToSAN(mv.toPosition);
+        auto [fromCol, fromRow] = mv.colRowFromPosition();
+        auto [toCol, toRow] = mv.colRowToPosition();
 
         bool capturing = pieceAt(mv.toPosition).has_value();
         ASSERT(!capturing || pieceAt(mv.toPosition)->color() != colorToMove());
 
         if (tp.type() == Piece::Type::Pawn) {
-            if (mv.isPromotion()) {
-                destination.push_back('=');
-                destination.push_back(Piece{mv.promotedType(), Color::White}.toFEN());
-            }
-
             if (capturing || mv.flag == Move::Flag::EnPassant) {
                 ASSERT(capturing || mv.toPosition == m_enPassant);
-                auto [fromCol, fromRow] = mv.colRowFromPosition();
+                *head++ = colToLetter(fromCol);
+                *head++ = 'x';
+            }
+            *head++ = colToLetter(toCol);
+            *head++ = rowToNumber(toRow);
 
-                return colToLetter(fromCol) + ('x' + destination);
+            if (mv.isPromotion()) {
+                *head++ = '=';
+                *head++ = Piece{mv.promotedType(), Color::White}.toFEN();
             }
-            return destination;
+            return head - out;
         }
 
-        if (capturing) {
-            destination.insert(0, "x");
+        *head++ = typeChar(tp.type());
+
+        if (tp.type() != Piece::Type::King) {
+            // other pieces of same type which could move there as well
+            BitBoard others = sameDestination & pieceBitBoard(tp) & ~BB::squareBoard(mv.fromPosition);
+            if (others) {
+                bool colAmbiguous = (others & (BB::col0 << fromCol)) != 0;
+                bool rowAmbiguous = (others & (BB::row0 << (fromRow * size))) != 0;
+                if (colAmbiguous && rowAmbiguous) {
+                    *head++ = colToLetter(fromCol);
+                    *head++ = rowToNumber(fromRow);
+                } else if (colAmbiguous) {
+                    *head++ = rowToNumber(fromRow);
+                } else {
+                    *head++ = colToLetter(fromCol);
+                }
+            }
         }
 
-        if (tp.type() == Piece::Type::King) {
-            return typeChar(tp.type()) + destination;
+        if (capturing) {
+            *head++ = 'x';
         }
+        *head++ = colToLetter(toCol);
+        *head++ = rowToNumber(toRow);
+
+        return head - out;
+    }
 
-        // determine location(s) of pieces of same type which could move there as well
+    std::string Board::moveToSAN(Move mv, const MoveList& list) const {
+        ASSERT(list.contains(mv));
 
-        bool multiple = false;
-        bool colAmbiguous = false;
-        bool rowAmbiguous = false;
+        BitBoard sameDestination = 0;
+        list.forEachMove([&sameDestination, toPos = mv.toPosition](const Move& move) {
+            if (move.toPosition == toPos) {
+                sameDestination |= BB::squareBoard(move.fromPosition);
+            }
+        });
 
-        auto [fromCol, fromRow] = mv.colRowFromPosition();
+        std::array<char, SANList::maxSANLength> buffer{};
+        return std::string(buffer.data(), writeSAN(buffer.data(), mv, sameDestination));
+    }
 
-        list.forEachFilteredMove(
-                [toPos = mv.toPosition, fromPos = mv.fromPosition](const Move& move) {
-                    return move.toPosition == toPos && move.fromPosition != fromPos;
-                },
-                 [&, fromCol = fromCol, fromRow = fromRow](const Move& move) {
-                         ASSERT(pieceAt(move.fromPosition).has_value() && pieceAt(move.fromPosition)->color() == colorToMove());
-                         if (pieceAt(move.fromPosition) == tp) {
-                             // ambiguity possible
-                             multiple = true;
-                             ASSERT(move.fromPosition != mv.fromPosition);
-                             auto [fromC, fromR] = move.colRowFromPosition();
-
-                             if (fromC == fromCol) {
-                                 colAmbiguous = true;
-                             }
-                             if (fromR == fromRow) {
-                                 rowAmbiguous = true;
-                             }
-                         }
-                     });
-
-        std::string disambiguation = "";
-
-        if (multiple) {
-            if (colAmbiguous && rowAmbiguous) {
-                disambiguation = indexToSAN(mv.fromPosition);
-            } else if (colAmbiguous && !rowAmbiguous) {
-                disambiguation = rowToNumber(fromRow);
-            } else {
-                disambiguation = colToLetter(fromCol);
+    SANList Board::movesToSAN(const MoveList& list, bool withCheckSuffix) const {
+        SANList result;
+
+        // for every square all squares from which a legal move goes there
+        std::array<BitBoard, size * size> sources{};
+        list.forEachMove([&sources](const Move& move) {
+            sources[move.toPosition] |= BB::squareBoard(move.fromPosition);
+        });
+
+        list.forEachMove([&](const Move& move) {
+            char* out = result.m_chars.data() + result.m_size * SANList::maxSANLength;
+            size_t length = writeSAN(out, move, sources[move.toPosition]);
+
+            if (withCheckSuffix) {
+                moveExcursion(move, [&](const Board& after) {
+                    auto [kingCol, kingRow] = after.kingSquare(after.colorToMove());
+                    if (after.attacked(kingCol, kingRow)) {
+                        out[length++] = generateAllMoves(after).size() == 0 ? '#' : '+';
+                    }
+                });
             }
-        }
 
+            ASSERT(length <= SANList::maxSANLength);
+            result.m_lengths[result.m_size] = static_cast<uint8_t>(length);
+            result.m_moves[result.m_size] = move;
+            ++result.m_size;
+        });
 
-        return typeChar(tp.type()) + disambiguation + destination;
+        return result;
     }
 
-    std::optional<Move> Board::parseSANMove(std::string_view sv) const {
-        return parseSANMove(sv, generateAllMoves(*this));
-    }
 
     std::optional<Move> Board::parseSANMove(std::string_view sv, const MoveList& moves) const {
-        ASSERT(sv.size() >= 2);
-        // do not want the check or checkmate data
-        ASSERT(sv.back() != '+' && sv.back() != '#');
-        Move::Flag flag = Move::Flag::None;
+        auto move = parseSANMove(sv);
+        if (!move.has_value() || !moves.contains(*move)) {
+            return std::nullopt;
+        }
+        return move;
+    }
+
+    std::optional<Move> Board::parseSANMove(std::string_view sv) const {
+        // check and mate markers are allowed but not verified
+        if (!sv.empty() && (sv.back() == '+' || sv.back() == '#')) {
+            sv.remove_suffix(1);
+        }
+        if (sv.size() < 2 || sv.size() > SANList::maxSANLength) {
+            return std::nullopt;
+        }
+
+        Color us = colorToMove();
 
         if (sv[0] == 'O') {
-            // must be castling
-            ASSERT(sv[1] == '-' && sv[2] == 'O');
-            BoardIndex home = Board::homeRow(colorToMove());
-            if (sv.size() == 3) {
-                return Move{kingCol, home, kingSideRookCol, home, Move::Flag::Castling};
-            } else {
-                ASSERT(sv.size() == 5);
-                ASSERT(sv[3] == '-' && sv[4] == 'O');
-                return Move{kingCol, home, queenSideRookCol, home, Move::Flag::Castling};
+            bool kingSide = sv == "O-O";
+            if (!kingSide && sv != "O-O-O") {
+                return std::nullopt;
+            }
+            CastlingRight required = us == Color::White
+                                         ? (kingSide ? CastlingRight::WhiteKingSide : CastlingRight::WhiteQueenSide)
+                                         : (kingSide ? CastlingRight::BlackKingSide : CastlingRight::BlackQueenSide);
+            BoardIndex home = homeRow(us);
+            BoardIndex rookCol = kingSide ? kingSideRookCol : queenSideRookCol;
+            if ((m_castlingRights & required) == CastlingRight::NoCastling
+                || pieceAt(kingCol, home) != Piece{Piece::Type::King, us}
+                || pieceAt(rookCol, home) != Piece{Piece::Type::Rook, us}
+                || (BB::between(columnRowToIndex(kingCol, home), columnRowToIndex(rookCol, home)) & piecesBB)) {
+                return std::nullopt;
             }
+            Move castle{kingCol, home, rookCol, home, Move::Flag::Castling};
+            if (!isLegal(castle)) {
+                return std::nullopt;
+            }
+            return castle;
         }
 
+        Move::Flag flag = Move::Flag::None;
         if (sv[sv.size() - 2] == '=') {
-            ASSERT(sv.size() >= 4);
-            // it is a promotion
-            Piece::Type tp = parseTypeChar(sv[sv.size() - 1]);
-            flag = Move::promotionFromType(tp);
+            Piece::Type promoted = parseTypeChar(sv.back());
+            if (promoted == Piece::Type::Pawn || promoted == Piece::Type::King) {
+                return std::nullopt;
+            }
+            flag = Move::promotionFromType(promoted);
             sv.remove_suffix(2);
+            if (sv.size() < 2) {
+                return std::nullopt;
+            }
         }
 
-        // TODO: should these be ifs? or have some "fast" path which may return some move on invalid input
         auto optDest = SANToColRow(sv.substr(sv.size() - 2, 2));
         if (!optDest.has_value()) {
             return std::nullopt;
         }
         auto [toCol, toRow] = optDest.value();
         BoardIndex destination = columnRowToIndex(toCol, toRow);
+        BitBoard destinationBB = BB::squareBoard(destination);
         sv.remove_suffix(2);
 
+        // can never capture our own pieces or a king
+        if (destinationBB & (colorBitboard(us) | typeBitboard(Piece::Type::King))) {
+            return std::nullopt;
+        }
+
         bool capturing = !sv.empty() && sv.back() == 'x';
         if (capturing) {
             sv.remove_suffix(1);
         }
 
-        Piece::Type tp = sv.empty() ? Piece::Type::Pawn : parseTypeChar(sv.front());
-        if (tp != Piece::Type::Pawn) {
+        Piece::Type tp = Piece::Type::Pawn;
+        if (!sv.empty() && sv.front() >= 'A' && sv.front() <= 'Z') {
+            tp = parseTypeChar(sv.front());
+            if (tp == Piece::Type::Pawn) {
+                return std::nullopt;
+            }
             sv.remove_prefix(1);
-            ASSERT(flag == Move::Flag::None);
         }
 
+        // squares the moving piece may come from according to the disambiguation
+        BitBoard fromMask = ~BitBoard(0);
         if (sv.size() == 2) {
-            // fully disambiguated
-            ASSERT(tp != Piece::Type::Pawn);
             auto from = SANToIndex(sv);
-            ASSERT(from.has_value());
-            Move move{from.value(), destination};
-            ASSERT(moves.contains(move));
-            return move;
-        }
-
-        BoardIndex fromCol = -1;
-        BoardIndex fromRow = -1;
-        if (!sv.empty()) {
+            if (!from.has_value()) {
+                return std::nullopt;
+            }
+            fromMask = BB::squareBoard(*from);
+        } else if (sv.size() == 1) {
             char c = sv.front();
-            if (std::isdigit(c)) {
-                fromRow = c - firstRow;
+            if (c >= firstCol && c <= finalCol) {
+                fromMask = BB::col0 << letterToCol(c);
+            } else if (c >= firstRow && c < firstRow + size) {
+                fromMask = BB::row0 << ((c - firstRow) * size);
             } else {
-                ASSERT(std::islower(c));
-                fromCol = letterToCol(c);
+                return std::nullopt;
             }
+        } else if (!sv.empty()) {
+            return std::nullopt;
         }
 
-        Color us = colorToMove();
-
         if (tp == Piece::Type::Pawn) {
-            Move mv;
-            if (capturing || destination == m_enPassant) {
-                ASSERT(fromCol < size);
-                BoardIndex row = toRow - pawnDirection(colorToMove());
+            if ((toRow == pawnPromotionRow(us)) != (flag != Move::Flag::None)) {
+                return std::nullopt;
+            }
+
+            BitBoard pawns = pieceBitBoard(Piece{Piece::Type::Pawn, us});
+            BoardIndex fromRow = toRow - pawnDirection(us);
+            if (fromRow >= size) {
+                return std::nullopt;
+            }
 
-                if (destination == m_enPassant) {
-                    ASSERT(!pieceAt(destination).has_value());
-                    ASSERT(flag == Move::Flag::None);
+            Move mv;
+            if (capturing) {
+                // only the column of departure is allowed and it determines the pawn
+                if (sv.size() != 1 || sv.front() < firstCol || sv.front() > finalCol) {
+                    return std::nullopt;
+                }
+                BitBoard from = BB::pawnAttackBB(opposite(us), destination) & pawns & fromMask;
+                if (!from) {
+                    return std::nullopt;
+                }
+                if (!(destinationBB & piecesBB)) {
+                    if (destination != m_enPassant) {
+                        return std::nullopt;
+                    }
                     flag = Move::Flag::EnPassant;
                 }
-
-                mv = Move{columnRowToIndex(fromCol, row), destination, flag};
+                mv = Move{BB::popLsb(from), destination, flag};
             } else {
-                ASSERT(sv.empty());
-                Piece pawn{Piece::Type::Pawn, us};
-
-                BoardOffset pawnDir = pawnDirection(us);
-                if (pieceAt(toCol, toRow - pawnDir) == pawn) {
-                    mv = Move(toCol, toRow - pawnDir, toCol, toRow, flag);
+                if (!sv.empty() || (destinationBB & piecesBB)) {
+                    return std::nullopt;
+                }
+                if (pawns & BB::squareBoard(columnRowToIndex(toCol, fromRow))) {
+                    mv = Move{toCol, fromRow, toCol, toRow, flag};
                 } else {
-                    // must be double push so cannot be promotion or e.p.
-                    ASSERT(flag == Move::Flag::None);
-                    ASSERT(pieceAt(toCol, toRow - pawnDir - pawnDir) == pawn);
-                    mv = Move(toCol, toRow - pawnDir - pawnDir, toCol, toRow, Move::Flag::DoublePushPawn);
+                    // must be a double push from the home row over an empty square
+                    BoardIndex homeRow = fromRow - pawnDirection(us);
+                    if (homeRow != pawnHomeRow(us) || pieceAt(toCol, fromRow).has_value()
+                        || !(pawns & BB::squareBoard(columnRowToIndex(toCol, homeRow)))) {
+                        return std::nullopt;
+                    }
+                    mv = Move{toCol, homeRow, toCol, toRow, Move::Flag::DoublePushPawn};
                 }
             }
-            ASSERT(moves.contains(mv));
+
+            if (!isLegal(mv)) {
+                return std::nullopt;
+            }
             return mv;
         }
 
-        bool foundSingleMove = false;
-        Move mv;
-
-        moves.forEachFilteredMove([&foundSingleMove, destination](const Move& move) {
-            return !foundSingleMove && move.toPosition == destination;
-        },
-                                  [&](const Move& move) {
-                                      ASSERT(pieceAt(move.fromPosition).has_value() && pieceAt(move.fromPosition)->color() == us);
-                                      auto [fromC, fromR] = move.colRowFromPosition();
-                                      if ((fromCol < size && fromC != fromCol)
-                                          || (fromRow < size && fromR != fromRow)) {
-                                          return;
-                                      }
-                                      if (pieceAt(move.fromPosition)->type() == tp) {
-                                          foundSingleMove = true;
-                                          mv = move;
-                                      }
-                                  });
-        if (!foundSingleMove) {
+        // the capture marker is not required to match for pieces, only pawns need it to find the source
+        if (flag != Move::Flag::None) {
             return std::nullopt;
         }
-        return mv;
+
+        BitBoard reachable = 0;
+        switch (tp) {
+            case Piece::Type::King:
+                reachable = BB::pieceAttacksBB<Piece::Type::King>(destination);
+                break;
+            case Piece::Type::Knight:
+                reachable = BB::pieceAttacksBB<Piece::Type::Knight>(destination);
+                break;
+            case Piece::Type::Bishop:
+                reachable = BB::generateSliders<Piece::Type::Bishop>(destination, piecesBB);
+                break;
+            case Piece::Type::Rook:
+                reachable = BB::generateSliders<Piece::Type::Rook>(destination, piecesBB);
+                break;
+            case Piece::Type::Queen:
+                reachable = BB::generateSliders<Piece::Type::Bishop>(destination, piecesBB)
+                          | BB::generateSliders<Piece::Type::Rook>(destination, piecesBB);
+                break;
+            case Piece::Type::Pawn:
+                ASSERT_NOT_REACHED();
+            case Piece::Type::None:
+                return std::nullopt;
+        }
+
+        BitBoard candidates = reachable & pieceBitBoard(Piece{tp, us}) & fromMask;
+        std::optional<Move> found;
+        while (candidates) {
+            Move mv{BB::popLsb(candidates), destination};
+            if (!isLegal(mv)) {
+                continue;
+            }
+            if (found.has_value()) {
+                // ambiguous, not enough disambiguation given
+                return std::nullopt;
+            }
+            found = mv;
+        }
+        return found;
     }
 
 }
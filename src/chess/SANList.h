@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Move.h"
+#include "MoveGen.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace Chess {
+
+    // SAN of all moves in a MoveList (in the same order), see Board::movesToSAN.
+    // Every SAN is stored in a fixed size slot of one flat buffer so creating it never allocates.
+    class SANList {
+    public:
+        // Longest possible SAN is something like "Qa1xb2+" or "exd8=Q#"
+        constexpr static size_t maxSANLength = 8;
+
+        [[nodiscard]] size_t size() const {
+            return m_size;
+        }
+
+        // The views point into this list, so they cannot be taken from a temporary one
+        [[nodiscard]] std::string_view operator[](size_t index) const& {
+            return {m_chars.data() + index * maxSANLength, m_lengths[index]};
+        }
+
+        std::string_view operator[](size_t index) const&& = delete;
+
+        [[nodiscard]] Move move(size_t index) const {
+            return m_moves[index];
+        }
+
+        [[nodiscard]] std::optional<std::string_view> find(Move mv) const& {
+            for (size_t i = 0; i < m_size; ++i) {
+                if (m_moves[i] == mv) {
+                    return (*this)[i];
+                }
+            }
+            return std::nullopt;
+        }
+
+        std::optional<std::string_view> find(Move mv) const&& = delete;
+
+        template<typename Func>
+        void forEach(Func f) const {
+            for (size_t i = 0; i < m_size; ++i) {
+                f(m_moves[i], (*this)[i]);
+            }
+        }
+
+    private:
+        friend class Board;
+
+        std::array<char, MoveList::maxMoves * maxSANLength> m_chars;
+        std::array<uint8_t, MoveList::maxMoves> m_lengths;
+        std::array<Move, MoveList::maxMoves> m_moves;
+        size_t m_size = 0;
+    };
+
+}
@@ -0,0 +1,399 @@
+#include "Search.h"
+#include "../util/Assertions.h"
+#include "../util/Trace.h"
+#include "MoveGen.h"
+#include <algorithm>
+
+namespace Chess {
+
+    std::string SearchLimit::toString() const {
+        std::string base;
+        switch (type) {
+            case Nodes:
+                base = "nodes";
+                break;
+            case MoveTime:
+                base = "movetime";
+                break;
+            case Depth:
+                base = "depth";
+                break;
+        }
+        return base + ' ' + std::to_string(val);
+    }
+
+    SearchLimit SearchLimit::nodes(uint32_t nodes) {
+        return {LimitType::Nodes, nodes};
+    }
+
+    SearchLimit SearchLimit::moveTime(uint32_t time) {
+        return {LimitType::MoveTime, time};
+    }
+
+    SearchLimit SearchLimit::depth(uint32_t depth) {
+        return {LimitType::Depth, depth};
+    }
+
+    SearchLimit::SearchLimit(LimitType tp, uint32_t val) : type(tp), val(val) {
+    }
+
+    uint64_t SearchResult::nodesPerSecond() const {
+        auto ns = static_cast<uint64_t>(elapsed.count());
+        if (ns == 0) {
+            return 0;
+        }
+        return static_cast<uint64_t>(static_cast<double>(nodes) * 1e9 / static_cast<double>(ns));
+    }
+
+    static_assert(maxSearchPly <= OrderingTables::maxPly, "Killers are needed for every ply");
+
+    // A capture which cannot bring the score back to alpha even with this much positional gain on top
+    // of the captured material is not searched in the quiescence search
+    constexpr static Score deltaMargin = 200;
+
+    // Mate scores are stored relative to the position instead of the root so they stay correct
+    // when the position is reached at another ply
+    static Score scoreToTable(Score score, uint32_t ply) {
+        if (isMateScore(score)) {
+            return score > 0 ? score + Score(ply) : score - Score(ply);
+        }
+        return score;
+    }
+
+    static Score scoreFromTable(Score score, uint32_t ply) {
+        if (isMateScore(score)) {
+            return score > 0 ? score - Score(ply) : score + Score(ply);
+        }
+        return score;
+    }
+
+    Search::Search(SearchLimit limit)
+        : m_limit(limit),
+          m_ownTable(std::make_unique<TranspositionTable>(defaultTableSize)),
+          m_table(m_ownTable.get()) {
+    }
+
+    Search::Search(SearchLimit limit, TranspositionTable& table) : m_limit(limit), m_table(&table) {
+    }
+
+    void Search::stop() {
+        m_stopRequested.store(true);
+        m_stopped.store(true);
+    }
+
+    void Search::clearStop() {
+        m_stopRequested.store(false);
+    }
+
+    void Search::setDepthSkew(uint32_t plies) {
+        m_depthSkew = plies;
+    }
+
+    void Search::setNetwork(const NNUE::Network* network) {
+        m_network = network;
+    }
+
+    void Search::setMultiPV(size_t lines) {
+        ASSERT(lines > 0);
+        m_multiPV = std::max<size_t>(lines, 1);
+    }
+
+    bool Search::isExcludedAtRoot(Move move) const {
+        return std::find(m_excludedRootMoves.begin(), m_excludedRootMoves.end(), move) != m_excludedRootMoves.end();
+    }
+
+    bool Search::shouldStop() {
+        if (m_stopped.load(std::memory_order_relaxed)) {
+            return true;
+        }
+        // the clock is only read every so often since it costs about as much as a node
+        if ((m_limit.type == SearchLimit::Nodes && m_nodes >= m_limit.val)
+            || (m_limit.type == SearchLimit::MoveTime && (m_nodes & 1023u) == 0
+                && std::chrono::steady_clock::now() >= m_deadline)) {
+            m_stopped.store(true, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    SearchResult Search::run(const Board& root, const IterationCallback& onIteration) {
+        TRACE_SCOPE("Search::run");
+        auto start = std::chrono::steady_clock::now();
+        m_deadline = start + std::chrono::milliseconds(m_limit.val);
+        // a stop in between these sets m_stopped after the reset or is seen by the check
+        m_stopped.store(false);
+        if (m_stopRequested.load()) {
+            m_stopped.store(true);
+        }
+        m_nodes = 0;
+        m_ordering.newSearch();
+        if (m_ownTable) {
+            m_ownTable->newSearch();
+        }
+
+        Board board = root;
+        if (m_network != nullptr) {
+            board.setNetwork(m_network);
+        }
+        MoveList rootMoves = generateAllMoves(board);
+        ASSERT(rootMoves.size() > 0);
+
+        SearchResult result;
+        result.bestMove = rootMoves[0];
+        result.pv = {rootMoves[0]};
+        result.lines = {{rootMoves[0], 0, 0, result.pv}};
+
+        uint32_t maxDepth = maxSearchPly - 1;
+        if (m_limit.type == SearchLimit::Depth) {
+            maxDepth = std::clamp(m_limit.val, 1u, maxDepth);
+        }
+
+        size_t lineCount = std::min(m_multiPV, rootMoves.size());
+        // of the last completed iteration
+        std::vector<SearchLine> previousLines;
+        std::vector<SearchLine> lines;
+        for (uint32_t depth = std::min(1 + m_depthSkew, maxDepth); depth <= maxDepth; ++depth) {
+            lines.clear();
+            m_excludedRootMoves.clear();
+            for (size_t line = 0; line < lineCount; ++line) {
+                // every line starts from the best line of the previous iteration not taken yet
+                auto previous = std::find_if(previousLines.begin(), previousLines.end(), [this](const SearchLine& l) {
+                    return !isExcludedAtRoot(l.move);
+                });
+                m_previousPV = previous != previousLines.end() ? previous->pv : std::vector<Move>{};
+                m_followPV = true;
+
+                Score score = negamax(board, depth, 0, -infiniteScore, infiniteScore);
+                if (m_stopped.load(std::memory_order_relaxed)) {
+                    break;
+                }
+                std::vector<Move> pv(m_pv[0].begin(), m_pv[0].begin() + m_pvLength[0]);
+                ASSERT(!pv.empty() && !isExcludedAtRoot(pv.front()));
+                m_excludedRootMoves.push_back(pv.front());
+                lines.push_back({pv.front(), score, depth, std::move(pv)});
+            }
+            if (m_stopped.load(std::memory_order_relaxed)) {
+                break;
+            }
+
+            // later lines are searched without the better moves, but may still come out higher
+            // when the search is unstable
+            std::stable_sort(lines.begin(), lines.end(), [](const SearchLine& lhs, const SearchLine& rhs) {
+                return lhs.score > rhs.score;
+            });
+            result.score = lines.front().score;
+            result.depth = depth;
+            result.pv = lines.front().pv;
+            result.bestMove = lines.front().move;
+            result.lines = lines;
+            result.nodes = m_nodes;
+            result.elapsed = std::chrono::steady_clock::now() - start;
+            previousLines = lines;
+
+            if (onIteration) {
+                onIteration(result);
+            }
+
+            // a deeper search cannot find anything better than a mate already within reach
+            if (std::all_of(lines.begin(), lines.end(), [depth](const SearchLine& line) {
+                    return isMateScore(line.score) && mateScore - std::abs(line.score) <= Score(depth);
+                })) {
+                break;
+            }
+        }
+
+        result.nodes = m_nodes;
+        result.elapsed = std::chrono::steady_clock::now() - start;
+        return result;
+    }
+
+    Score Search::negamax(Board& board, uint32_t depth, uint32_t ply, Score alpha, Score beta) {
+        m_pvLength[ply] = ply;
+        if (ply > 0 && (board.isDrawn() || board.positionRepeated() > 0)) {
+            return 0;
+        }
+        if (depth == 0) {
+            return quiescence(board, ply, alpha, beta, true);
+        }
+
+        ++m_nodes;
+        if (shouldStop()) {
+            return 0;
+        }
+        if (ply >= maxSearchPly - 1) {
+            return evaluate(board, m_pawnTable);
+        }
+
+        // the principal variation is never cut short by the table, so only null windows use its scores
+        bool pvNode = beta - alpha > 1;
+        std::optional<TTEntry> entry = m_table->probe(board.hash());
+        if (entry.has_value() && !pvNode && ply > 0 && entry->depth >= depth) {
+            Score score = scoreFromTable(entry->score, ply);
+            if (entry->bound == Bound::Exact
+                || (entry->bound == Bound::Lower && score >= beta)
+                || (entry->bound == Bound::Upper && score <= alpha)) {
+                return score;
+            }
+        }
+
+        MoveList moves = generateAllMoves(board);
+        if (moves.size() == 0) {
+            return moves.isCheckMate() ? -mateScore + Score(ply) : 0;
+        }
+
+        // the previous principal variation goes before the transposition table
+        Move firstMove = entry.has_value() ? entry->move : Move{};
+        if (m_followPV) {
+            if (ply < m_previousPV.size() && moves.contains(m_previousPV[ply])) {
+                firstMove = m_previousPV[ply];
+            } else {
+                m_followPV = false;
+            }
+        }
+        Move previous = ply > 0 ? m_playedMoves[ply - 1] : Move{};
+        MovePicker picker(board, moves, firstMove, m_ordering, ply, previous);
+
+        Score originalAlpha = alpha;
+        Score best = -infiniteScore;
+        Move bestMove;
+        std::array<Move, MoveList::maxMoves> triedQuiets;
+        size_t triedQuietCount = 0;
+        size_t searched = 0;
+        while (auto picked = picker.next()) {
+            Move move = *picked;
+            if (ply == 0 && isExcludedAtRoot(move)) {
+                continue;
+            }
+            bool quiet = isQuietMove(board, move);
+            m_playedMoves[ply] = move;
+            board.makeMove(move);
+            m_table->prefetch(board.hash());
+            Score score;
+            if (searched++ == 0) {
+                score = -negamax(board, depth - 1, ply + 1, -beta, -alpha);
+            } else {
+                score = -negamax(board, depth - 1, ply + 1, -alpha - 1, -alpha);
+                if (score > alpha && score < beta && !m_stopped.load(std::memory_order_relaxed)) {
+                    score = -negamax(board, depth - 1, ply + 1, -beta, -alpha);
+                }
+            }
+            board.undoMove();
+            // only the first move at every ply can still be on the previous principal variation
+            m_followPV = false;
+
+            if (m_stopped.load(std::memory_order_relaxed)) {
+                return 0;
+            }
+
+            if (score > best) {
+                best = score;
+                bestMove = move;
+                if (score > alpha) {
+                    alpha = score;
+                    m_pv[ply][ply] = move;
+                    for (uint32_t next = ply + 1; next < m_pvLength[ply + 1]; ++next) {
+                        m_pv[ply][next] = m_pv[ply + 1][next];
+                    }
+                    m_pvLength[ply] = std::max(m_pvLength[ply + 1], ply + 1);
+                    if (alpha >= beta) {
+                        if (quiet) {
+                            m_ordering.updateOnCutoff(board.colorToMove(), ply, depth, move, previous,
+                                                      triedQuiets.data(), triedQuietCount);
+                        }
+                        break;
+                    }
+                }
+            }
+            if (quiet) {
+                triedQuiets[triedQuietCount++] = move;
+            }
+        }
+
+        Bound bound = best >= beta ? Bound::Lower : best > originalAlpha ? Bound::Exact : Bound::Upper;
+        // an upper bound has no best move, all of them were too low. The root without the moves of
+        // earlier lines is not the real position, so it is not stored.
+        if (ply > 0 || m_excludedRootMoves.empty()) {
+            m_table->store(board.hash(), bound == Bound::Upper ? Move{} : bestMove, scoreToTable(best, ply), depth, bound);
+        }
+        return best;
+    }
+
+    Score Search::quiescence(Board& board, uint32_t ply, Score alpha, Score beta, bool withChecks) {
+        m_pvLength[ply] = ply;
+        ++m_nodes;
+
+        if (shouldStop()) {
+            return 0;
+        }
+        if (ply >= maxSearchPly - 1) {
+            return evaluate(board, m_pawnTable);
+        }
+
+        auto [kingCol, kingRow] = board.kingSquare(board.colorToMove());
+        bool inCheck = board.attacked(kingCol, kingRow);
+
+        // not capturing is always possible except in check, so the static evaluation is a lower bound
+        Score standPat = -infiniteScore;
+        Score best = -infiniteScore;
+        if (!inCheck) {
+            standPat = evaluate(board, m_pawnTable);
+            if (standPat >= beta) {
+                return standPat;
+            }
+            alpha = std::max(alpha, standPat);
+            best = standPat;
+        }
+
+        MoveList moves = generateMoves(board, withChecks ? GenerationMode::CapturesAndChecks : GenerationMode::Captures);
+        if (moves.size() == 0 && inCheck) {
+            return -mateScore + Score(ply);
+        }
+
+        Move previous = ply > 0 ? m_playedMoves[ply - 1] : Move{};
+        MovePicker picker(board, moves, Move{}, m_ordering, ply, previous);
+        while (auto picked = picker.next()) {
+            Move move = *picked;
+            if (!inCheck) {
+                if (move.isPromotion() && move.promotedType() != Piece::Type::Queen) {
+                    continue;
+                }
+                auto captured = board.pieceAt(move.colRowToPosition());
+                Score gain = move.flag == Move::Flag::EnPassant ? pieceValue(Piece::Type::Pawn)
+                             : captured.has_value()              ? pieceValue(captured->type())
+                                                                 : 0;
+                if (move.isPromotion()) {
+                    gain += pieceValue(Piece::Type::Queen) - pieceValue(Piece::Type::Pawn);
+                }
+                // delta pruning, quiet checks win no material so are never pruned by it
+                if (gain > 0 && standPat + gain + deltaMargin <= alpha) {
+                    continue;
+                }
+                if (!board.seeGE(move, 0)) {
+                    continue;
+                }
+            }
+
+            m_playedMoves[ply] = move;
+            board.makeMove(move);
+            Score score = -quiescence(board, ply + 1, -beta, -alpha, false);
+            board.undoMove();
+
+            if (m_stopped.load(std::memory_order_relaxed)) {
+                return 0;
+            }
+
+            if (score > best) {
+                best = score;
+                if (score > alpha) {
+                    alpha = score;
+                    if (alpha >= beta) {
+                        break;
+                    }
+                }
+            }
+        }
+
+        return best;
+    }
+
+}
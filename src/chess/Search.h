@@ -0,0 +1,160 @@
+#pragma once
+
+#include "Board.h"
+#include "Evaluation.h"
+#include "Move.h"
+#include "MoveOrdering.h"
+#include "TranspositionTable.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Chess {
+
+    // The same kinds of limits as Stockfish::SearchLimit so the native search can stand in for it
+    struct SearchLimit {
+        enum LimitType {
+            Nodes,
+            MoveTime,
+            Depth
+        } type;
+        uint32_t val = 0;
+
+        [[nodiscard]] std::string toString() const;
+
+        static SearchLimit nodes(uint32_t nodes);
+
+        // in milliseconds
+        static SearchLimit moveTime(uint32_t time);
+
+        static SearchLimit depth(uint32_t depth);
+
+    private:
+        SearchLimit(LimitType tp, uint32_t val);
+    };
+
+    constexpr uint32_t maxSearchPly = 64;
+    constexpr Score mateScore = 32000;
+    constexpr Score infiniteScore = mateScore + 1;
+
+    // Mate found by the search for either side, mate in n plies scores mateScore - n
+    [[nodiscard]] constexpr bool isMateScore(Score score) {
+        return score >= mateScore - Score(maxSearchPly) || score <= -mateScore + Score(maxSearchPly);
+    }
+
+    // One root move with its own principal variation, see Search::setMultiPV
+    struct SearchLine {
+        Move move;
+        // from the point of view of the side to move at the root
+        Score score = 0;
+        uint32_t depth = 0;
+        // starting with move
+        std::vector<Move> pv;
+    };
+
+    struct SearchResult {
+        Move bestMove;
+        // from the point of view of the side to move at the root
+        Score score = 0;
+        // last completed iteration
+        uint32_t depth = 0;
+        uint64_t nodes = 0;
+        std::chrono::nanoseconds elapsed{0};
+        // principal variation starting with bestMove
+        std::vector<Move> pv;
+        // best first, one per multi PV line (fewer if there are not as many legal moves), the first
+        // is bestMove with its score and pv
+        std::vector<SearchLine> lines;
+
+        [[nodiscard]] uint64_t nodesPerSecond() const;
+    };
+
+    // Negamax alpha-beta search with principal variation search (null windows for all but the
+    // first move) and iterative deepening. Every iteration first follows the principal variation of
+    // the previous one, elsewhere the move from the transposition table is searched first and the
+    // other moves are ordered by MovePicker. Leaves continue with a quiescence search: the side to
+    // move may stand pat on the static evaluation or capture, skipping captures which lose material
+    // (Board::seeGE) or cannot reach alpha (delta pruning), and its first ply also tries quiet
+    // checks. Results only come from completed iterations, except that the first legal move is
+    // returned if not even depth 1 completes. With multi PV every iteration searches the root once
+    // per line, each time without the moves of the lines before it.
+    class Search {
+    public:
+        constexpr static size_t defaultTableSize = 16;
+
+        // With its own transposition table of defaultTableSize megabytes, kept between runs
+        explicit Search(SearchLimit limit);
+
+        // The table must outlive the search, it can be shared with searches on other threads. Only
+        // an own table is aged by run, for a shared one the owner calls newSearch between searches.
+        Search(SearchLimit limit, TranspositionTable& table);
+
+        using IterationCallback = std::function<void(const SearchResult&)>;
+
+        // The board must have a legal move, onIteration is called after every completed iteration
+        [[nodiscard]] SearchResult run(const Board& board, const IterationCallback& onIteration = {});
+
+        // May be called from another thread, a running search returns its last completed iteration.
+        // The stop lasts until clearStop, so one which arrives before run starts is not lost and run
+        // returns right away.
+        void stop();
+
+        // Lets run search again after stop, not while it is running
+        void clearStop();
+
+        // Every iteration searches this many plies deeper than its number (up to the depth limit), so
+        // threads of a parallel search are spread over neighbouring depths
+        void setDepthSkew(uint32_t plies);
+
+        // Evaluates with network instead of the piece square tables (nullptr keeps whatever the board
+        // has), the network must outlive the search
+        void setNetwork(const NNUE::Network* network);
+
+        // Searches the best lines moves instead of just the best one (see SearchResult::lines), the
+        // transposition table and move ordering tables are shared by all of them
+        void setMultiPV(size_t lines);
+
+    private:
+        Score negamax(Board& board, uint32_t depth, uint32_t ply, Score alpha, Score beta);
+
+        // Only captures and promotions (and quiet checks if withChecks) until the position is quiet,
+        // or every evasion when in check
+        Score quiescence(Board& board, uint32_t ply, Score alpha, Score beta, bool withChecks);
+
+        [[nodiscard]] bool shouldStop();
+
+        [[nodiscard]] bool isExcludedAtRoot(Move move) const;
+
+        SearchLimit m_limit;
+        uint32_t m_depthSkew = 0;
+        size_t m_multiPV = 1;
+        const NNUE::Network* m_network = nullptr;
+        std::unique_ptr<TranspositionTable> m_ownTable;
+        TranspositionTable* m_table;
+        // by stop, m_stopped is also set by the limits and only lasts for one run
+        std::atomic<bool> m_stopRequested = false;
+        std::atomic<bool> m_stopped = false;
+        uint64_t m_nodes = 0;
+        std::chrono::steady_clock::time_point m_deadline;
+
+        // triangular table, the best line found from ply is m_pv[ply][ply, m_pvLength[ply])
+        std::array<std::array<Move, maxSearchPly>, maxSearchPly> m_pv{};
+        std::array<uint32_t, maxSearchPly> m_pvLength{};
+        std::vector<Move> m_previousPV;
+        bool m_followPV = false;
+        // root moves of the lines already searched in this iteration
+        std::vector<Move> m_excludedRootMoves;
+
+        OrderingTables m_ordering;
+        // per search so threads of a parallel search never share it
+        PawnHashTable m_pawnTable;
+        // the move made at every ply, for the counter move table
+        std::array<Move, maxSearchPly> m_playedMoves{};
+    };
+
+}
@@ -0,0 +1,142 @@
+#include "Board.h"
+#include "../util/Assertions.h"
+#include "BitBoard.h"
+#include "Evaluation.h"
+#include <algorithm>
+#include <array>
+
+namespace Chess {
+
+    constexpr static std::array<Piece::Type, 6> leastValuableFirst = {
+            Piece::Type::Pawn, Piece::Type::Knight, Piece::Type::Bishop,
+            Piece::Type::Rook, Piece::Type::Queen, Piece::Type::King};
+
+    // Never really taken, just more than anything it could capture
+    constexpr static int32_t kingExchangeValue = 2 * pieceValue(Piece::Type::Queen) + 1;
+
+    static int32_t exchangeValue(Piece::Type type) {
+        return type == Piece::Type::King ? kingExchangeValue : pieceValue(type);
+    }
+
+    std::optional<Piece::Type> Board::popLeastValuable(BitBoard attackers, Color color, BitBoard& occupied) const {
+        attackers &= colorBitboard(color);
+        if (!attackers) {
+            return std::nullopt;
+        }
+        for (Piece::Type type : leastValuableFirst) {
+            if (BitBoard ofType = attackers & typeBitboard(type)) {
+                occupied ^= BB::squareBoard(BB::popLsb(ofType));
+                return type;
+            }
+        }
+        ASSERT_NOT_REACHED();
+        return std::nullopt;
+    }
+
+    BitBoard Board::revealedAttackers(BoardIndex square, BitBoard occupied, Piece::Type removed) const {
+        BitBoard revealed = 0;
+        if (removed == Piece::Type::Pawn || removed == Piece::Type::Bishop || removed == Piece::Type::Queen) {
+            revealed |= BB::generateSliders<Piece::Type::Bishop>(square, occupied)
+                        & typeBitboards(Piece::Type::Bishop, Piece::Type::Queen);
+        }
+        if (removed == Piece::Type::Rook || removed == Piece::Type::Queen) {
+            revealed |= BB::generateSliders<Piece::Type::Rook>(square, occupied)
+                        & typeBitboards(Piece::Type::Rook, Piece::Type::Queen);
+        }
+        return revealed & occupied;
+    }
+
+    int32_t Board::see(Move mv) const {
+        if (mv.flag == Move::Flag::Castling) {
+            return 0;
+        }
+        BitBoard occupied = 0;
+        int32_t onSquare = 0;
+        // the gain of every capture for the side making it, if the exchange went on until then
+        std::array<int32_t, 34> gain{};
+        gain[0] = startExchange(mv, occupied, onSquare);
+
+        BoardIndex to = mv.toPosition;
+        Color side = opposite(pieceAt(mv.fromPosition)->color());
+        BitBoard attackers = attacksOn(to, occupied) & occupied;
+        size_t depth = 0;
+        while (auto type = popLeastValuable(attackers, side, occupied)) {
+            attackers = (attackers | revealedAttackers(to, occupied, *type)) & occupied;
+            if (*type == Piece::Type::King && (attackers & colorBitboard(opposite(side)))) {
+                // the square is still defended so the king cannot take
+                break;
+            }
+            ++depth;
+            ASSERT(depth < gain.size());
+            gain[depth] = onSquare - gain[depth - 1];
+            onSquare = exchangeValue(*type);
+            side = opposite(side);
+        }
+
+        // every side only captures if that is better than stopping
+        for (; depth > 0; --depth) {
+            gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
+        }
+        return gain[0];
+    }
+
+    bool Board::seeGE(Move mv, int32_t threshold) const {
+        if (mv.flag == Move::Flag::Castling) {
+            return threshold <= 0;
+        }
+        BitBoard occupied = 0;
+        int32_t onSquare = 0;
+        // what the side to move still has to win to reach the threshold, with alternating signs
+        int32_t swap = startExchange(mv, occupied, onSquare) - threshold;
+        if (swap < 0) {
+            return false;
+        }
+        swap = onSquare - swap;
+        if (swap <= 0) {
+            return true;
+        }
+
+        BoardIndex to = mv.toPosition;
+        Color side = pieceAt(mv.fromPosition)->color();
+        BitBoard attackers = attacksOn(to, occupied) & occupied;
+        // whether the mover reaches the threshold if the exchange stops now
+        bool result = true;
+        while (true) {
+            side = opposite(side);
+            auto type = popLeastValuable(attackers, side, occupied);
+            if (!type.has_value()) {
+                break;
+            }
+            attackers = (attackers | revealedAttackers(to, occupied, *type)) & occupied;
+            if (*type == Piece::Type::King) {
+                return (attackers & colorBitboard(opposite(side))) ? result : !result;
+            }
+            result = !result;
+            swap = exchangeValue(*type) - swap;
+            if (swap < static_cast<int32_t>(result)) {
+                break;
+            }
+        }
+        return result;
+    }
+
+    int32_t Board::startExchange(Move mv, BitBoard& occupied, int32_t& onSquare) const {
+        ASSERT(pieceAt(mv.fromPosition).has_value());
+        occupied = piecesBB ^ BB::squareBoard(mv.fromPosition);
+        onSquare = exchangeValue(pieceAt(mv.fromPosition)->type());
+
+        int32_t captured = 0;
+        if (mv.flag == Move::Flag::EnPassant) {
+            captured = pieceValue(Piece::Type::Pawn);
+            occupied ^= BB::squareBoard(columnRowToIndex(mv.toPosition % size, mv.fromPosition / size));
+        } else if (auto piece = pieceAt(mv.toPosition); piece.has_value()) {
+            captured = pieceValue(piece->type());
+        }
+        if (mv.isPromotion()) {
+            captured += pieceValue(mv.promotedType()) - pieceValue(Piece::Type::Pawn);
+            onSquare = pieceValue(mv.promotedType());
+        }
+        return captured;
+    }
+
+}
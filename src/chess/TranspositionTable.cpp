@@ -0,0 +1,201 @@
+#include "TranspositionTable.h"
+#include "../util/Assertions.h"
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+namespace Chess {
+
+    // Layout of the data word, the other word is the key xor'ed with it
+    //   bits  0-14 move (to, from and flag like the Move bit fields)
+    //   bits 16-31 score as int16
+    //   bits 32-39 depth
+    //   bits 40-41 bound
+    //   bits 42-47 age of the search which stored it
+    constexpr static uint64_t ageMask = 63;
+    constexpr static size_t hugePageSize = 2 * 1024 * 1024;
+
+    static uint64_t packMove(Move move) {
+        return static_cast<uint64_t>(move.toPosition) | (static_cast<uint64_t>(move.fromPosition) << 6u)
+               | (static_cast<uint64_t>(move.flag) << 12u);
+    }
+
+    static Move unpackMove(uint64_t data) {
+        return Move{static_cast<BoardIndex>((data >> 6u) & 63u), static_cast<BoardIndex>(data & 63u),
+                    static_cast<Move::Flag>((data >> 12u) & 7u)};
+    }
+
+    static uint64_t packData(Move move, Score score, uint32_t depth, Bound bound, uint8_t age) {
+        return packMove(move) | (static_cast<uint64_t>(static_cast<uint16_t>(score)) << 16u)
+               | (static_cast<uint64_t>(depth) << 32u) | (static_cast<uint64_t>(bound) << 40u)
+               | (static_cast<uint64_t>(age & ageMask) << 42u);
+    }
+
+    static Bound dataBound(uint64_t data) {
+        return static_cast<Bound>((data >> 40u) & 3u);
+    }
+
+    static uint32_t dataDepth(uint64_t data) {
+        return (data >> 32u) & 0xffu;
+    }
+
+    static uint8_t dataAge(uint64_t data) {
+        return (data >> 42u) & ageMask;
+    }
+
+    TranspositionTable::TranspositionTable(size_t megabytes) {
+        resize(megabytes);
+    }
+
+    TranspositionTable::~TranspositionTable() {
+        deallocate();
+    }
+
+    void TranspositionTable::deallocate() {
+#ifdef _WIN32
+        _aligned_free(m_buckets);
+#else
+        std::free(m_buckets);
+#endif
+        m_buckets = nullptr;
+        m_bucketCount = 0;
+    }
+
+    void TranspositionTable::resize(size_t megabytes) {
+        deallocate();
+
+        size_t buckets = 1;
+        while (buckets * 2 * sizeof(Bucket) <= megabytes * 1024 * 1024) {
+            buckets *= 2;
+        }
+
+        // a smaller table is still usable so halve until the allocation succeeds
+        for (; m_buckets == nullptr && buckets > 0; buckets /= 2) {
+            size_t bytes = buckets * sizeof(Bucket);
+#ifdef _WIN32
+            m_buckets = static_cast<Bucket*>(_aligned_malloc(bytes, sizeof(Bucket)));
+#else
+            // aligning to a huge page lets the kernel back the whole table with them
+            size_t alignment = bytes >= hugePageSize ? hugePageSize : sizeof(Bucket);
+            m_buckets = static_cast<Bucket*>(std::aligned_alloc(alignment, bytes));
+#ifdef MADV_HUGEPAGE
+            if (m_buckets != nullptr && alignment == hugePageSize) {
+                madvise(m_buckets, bytes, MADV_HUGEPAGE);
+            }
+#endif
+#endif
+            m_bucketCount = buckets;
+        }
+        ASSERT(m_buckets != nullptr);
+
+        std::uninitialized_value_construct_n(m_buckets, m_bucketCount);
+        m_age = 0;
+    }
+
+    size_t TranspositionTable::sizeInBytes() const {
+        return m_bucketCount * sizeof(Bucket);
+    }
+
+    void TranspositionTable::clear() {
+        for (size_t i = 0; i < m_bucketCount; ++i) {
+            for (Entry& entry : m_buckets[i].entries) {
+                entry.check.store(0, std::memory_order_relaxed);
+                entry.data.store(0, std::memory_order_relaxed);
+            }
+        }
+        m_age = 0;
+    }
+
+    void TranspositionTable::newSearch() {
+        m_age = (m_age + 1) & ageMask;
+    }
+
+    TranspositionTable::Bucket& TranspositionTable::bucketFor(uint64_t key) const {
+        // the amount of buckets is a power of two, the key check uses all bits anyway
+        return m_buckets[key & (m_bucketCount - 1)];
+    }
+
+    std::optional<TTEntry> TranspositionTable::probe(uint64_t key) const {
+        for (const Entry& entry : bucketFor(key).entries) {
+            uint64_t data = entry.data.load(std::memory_order_relaxed);
+            if ((entry.check.load(std::memory_order_relaxed) ^ data) != key || dataBound(data) == Bound::None) {
+                continue;
+            }
+            return TTEntry{unpackMove(data), static_cast<int16_t>((data >> 16u) & 0xffffu), dataDepth(data),
+                           dataBound(data)};
+        }
+        return std::nullopt;
+    }
+
+    void TranspositionTable::store(uint64_t key, Move move, Score score, uint32_t depth, Bound bound) {
+        ASSERT(bound != Bound::None);
+        ASSERT(score >= std::numeric_limits<int16_t>::min() && score <= std::numeric_limits<int16_t>::max());
+        depth = std::min(depth, maxDepth);
+
+        Entry* replace = nullptr;
+        int32_t replaceValue = std::numeric_limits<int32_t>::max();
+        for (Entry& entry : bucketFor(key).entries) {
+            uint64_t data = entry.data.load(std::memory_order_relaxed);
+            if (dataBound(data) == Bound::None) {
+                replace = &entry;
+                break;
+            }
+            if ((entry.check.load(std::memory_order_relaxed) ^ data) == key) {
+                // a deeper result of this search is worth more than a shallow bound
+                if (bound != Bound::Exact && dataAge(data) == m_age && dataDepth(data) > depth + 2) {
+                    return;
+                }
+                if (move == Move{}) {
+                    move = unpackMove(data);
+                }
+                replace = &entry;
+                break;
+            }
+            // 8 plies of depth are worth as much as being from the previous search
+            int32_t ageDistance = (m_age - dataAge(data)) & ageMask;
+            int32_t value = static_cast<int32_t>(dataDepth(data)) - 8 * ageDistance;
+            if (value < replaceValue) {
+                replaceValue = value;
+                replace = &entry;
+            }
+        }
+        ASSERT(replace != nullptr);
+
+        uint64_t data = packData(move, score, depth, bound, m_age);
+        replace->data.store(data, std::memory_order_relaxed);
+        replace->check.store(key ^ data, std::memory_order_relaxed);
+    }
+
+    void TranspositionTable::prefetch(uint64_t key) const {
+        [[maybe_unused]] const Bucket* bucket = &bucketFor(key);
+#if defined(__GNUC__)
+        __builtin_prefetch(bucket);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        _mm_prefetch(reinterpret_cast<const char*>(bucket), _MM_HINT_T0);
+#endif
+    }
+
+    uint32_t TranspositionTable::hashfull() const {
+        size_t buckets = std::min<size_t>(m_bucketCount, 1000 / entriesPerBucket);
+        uint32_t used = 0;
+        for (size_t i = 0; i < buckets; ++i) {
+            for (const Entry& entry : m_buckets[i].entries) {
+                uint64_t data = entry.data.load(std::memory_order_relaxed);
+                used += dataBound(data) != Bound::None && dataAge(data) == m_age;
+            }
+        }
+        return static_cast<uint32_t>(used * 1000 / (buckets * entriesPerBucket));
+    }
+
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Evaluation.h"
+#include "Move.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace Chess {
+
+    // Which side of the window the stored score is known to be on
+    enum class Bound : uint8_t {
+        None = 0,
+        // the score is at most the stored one (no move raised alpha)
+        Upper = 1,
+        // the score is at least the stored one (beta cutoff)
+        Lower = 2,
+        Exact = Upper | Lower,
+    };
+
+    struct TTEntry {
+        // Move{} if no move was stored
+        Move move;
+        Score score = 0;
+        uint32_t depth = 0;
+        Bound bound = Bound::None;
+    };
+
+    // Hash table from Board::hash() to search results which may be shared by any amount of threads
+    // without locking. Every 64 byte bucket holds 4 entries of two 64 bit words: the data and the
+    // key xor'ed with the data. A torn write (two threads storing the same entry at the same time)
+    // then fails the key check on probing instead of returning data from another position.
+    // Entries of older searches (see newSearch) and shallower entries are replaced first.
+    class TranspositionTable {
+    public:
+        constexpr static size_t entriesPerBucket = 4;
+        constexpr static uint32_t maxDepth = 255;
+
+        // in megabytes, rounded down to a power of two amount of buckets
+        explicit TranspositionTable(size_t megabytes);
+
+        ~TranspositionTable();
+
+        TranspositionTable(const TranspositionTable&) = delete;
+        TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+        // Reallocates and clears the table, must not be used by any other thread meanwhile
+        void resize(size_t megabytes);
+
+        [[nodiscard]] size_t sizeInBytes() const;
+
+        void clear();
+
+        // Marks all current entries as old, call before starting a (new) search
+        void newSearch();
+
+        [[nodiscard]] std::optional<TTEntry> probe(uint64_t key) const;
+
+        // Depth is clamped to maxDepth and score must fit in 16 bits
+        void store(uint64_t key, Move move, Score score, uint32_t depth, Bound bound);
+
+        // Starts loading the bucket of key into the cache
+        void prefetch(uint64_t key) const;
+
+        // Per mille of the entries in the first 1000 used by the current search, like UCI hashfull
+        [[nodiscard]] uint32_t hashfull() const;
+
+    private:
+        struct Entry {
+            std::atomic<uint64_t> check;
+            std::atomic<uint64_t> data;
+        };
+
+        struct alignas(64) Bucket {
+            std::array<Entry, entriesPerBucket> entries;
+        };
+        static_assert(sizeof(Bucket) == 64, "A bucket must fill exactly one cache line");
+
+        [[nodiscard]] Bucket& bucketFor(uint64_t key) const;
+
+        void deallocate();
+
+        Bucket* m_buckets = nullptr;
+        size_t m_bucketCount = 0;
+        uint8_t m_age = 0;
+    };
+
+}
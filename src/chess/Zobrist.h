@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Types.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace Chess::Zobrist {
+
+    // Random keys for every part of a position, the hash of a position is the xor of the keys of
+    // all its pieces, the castling rights, the en passant file and the side to move (if black).
+    // Generated at compile time so hashes are the same across runs and platforms.
+    struct Keys {
+        // [color index][type index][square]
+        std::array<std::array<std::array<uint64_t, 64>, 6>, 2> pieces{};
+        // indexed by the CastlingRight value, the xor of the keys of its bits so no rights is 0
+        std::array<uint64_t, 16> castling{};
+        std::array<uint64_t, 8> enPassantFile{};
+        uint64_t blackToMove = 0;
+    };
+
+    namespace detail {
+        constexpr uint64_t splitMix64(uint64_t& state) {
+            uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+            z = (z ^ (z >> 30u)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27u)) * 0x94d049bb133111ebull;
+            return z ^ (z >> 31u);
+        }
+
+        constexpr Keys generateKeys() {
+            Keys keys;
+            uint64_t state = 0x2545f4914f6cdd1dull;
+            for (auto& color : keys.pieces) {
+                for (auto& type : color) {
+                    for (uint64_t& key : type) {
+                        key = splitMix64(state);
+                    }
+                }
+            }
+            for (size_t bit = 1; bit < keys.castling.size(); bit <<= 1u) {
+                uint64_t key = splitMix64(state);
+                for (size_t rights = 0; rights < keys.castling.size(); ++rights) {
+                    if (rights & bit) {
+                        keys.castling[rights] ^= key;
+                    }
+                }
+            }
+            for (uint64_t& key : keys.enPassantFile) {
+                key = splitMix64(state);
+            }
+            keys.blackToMove = splitMix64(state);
+            return keys;
+        }
+    }
+
+    inline constexpr Keys keys = detail::generateKeys();
+
+}
@@ -1,5 +1,6 @@
 #include "Game.h"
 #include "../../util/Assertions.h"
+#include "../../util/Trace.h"
 #include "../MoveGen.h"
 #include <sstream>
 
@@ -8,40 +9,42 @@ namespace Chess {
     GameResult playGame(const Player* whitePlayer, const Player* blackPlayer) {
         ASSERT(whitePlayer);
         ASSERT(blackPlayer);
+        TRACE_SCOPE("playGame");
         Board board = Board::standardBoard();
         auto whiteState = whitePlayer->startGame(Color::White);
         auto blackState = blackPlayer->startGame(Color::White);
 
-        std::ostringstream pgn;
+        GameResult result;
 
         MoveList list = generateAllMoves(board);
 
         while (list.size() && !board.isDrawn()) {
             Color toMove = board.colorToMove();
             Move mv;
-            if (toMove == Color::White) {
-                mv = whiteState->pickMove(board, list);
-            } else {
-                mv = blackState->pickMove(board, list);
+            {
+                TRACE_SCOPE("pickMove");
+                if (toMove == Color::White) {
+                    mv = whiteState->pickMove(board, list);
+                } else {
+                    mv = blackState->pickMove(board, list);
+                }
             }
 
             ASSERT(list.contains(mv));
             ASSERT(mv.fromPosition != mv.toPosition);
 
-            if (board.colorToMove() == Chess::Color::White) {
-                pgn << board.fullMoves() << ". ";
-            }
-            pgn << board.moveToSAN(mv, list) << " ";
-
+            result.moves.push_back(mv);
             board.makeMove(mv);
-            whiteState->movePlayed(mv, board);
-            blackState->movePlayed(mv, board);
+            {
+                TRACE_SCOPE("movePlayed");
+                whiteState->movePlayed(mv, board);
+                blackState->movePlayed(mv, board);
+            }
 
+            TRACE_SCOPE("generateAllMoves");
             list = generateAllMoves(board);
         }
 
-        GameResult result;
-        result.pgn = pgn.str();
         Color toMove = board.colorToMove();
 
         if (list.size() > 0) {
@@ -78,6 +81,26 @@ namespace Chess {
         return playGame(white.get(), black.get());
     }
 
+    std::string GameResult::pgn() const {
+        TRACE_SCOPE("PGN");
+        Board board = Board::standardBoard();
+        if (!startFEN.empty()) {
+            [[maybe_unused]] auto parsed = board.parseFEN(startFEN);
+            ASSERT(parsed);
+        }
+
+        std::ostringstream pgn;
+        for (Move mv : moves) {
+            MoveList list = generateAllMoves(board);
+            if (board.colorToMove() == Chess::Color::White) {
+                pgn << board.fullMoves() << ". ";
+            }
+            pgn << board.moveToSAN(mv, list) << " ";
+            board.makeMove(mv);
+        }
+        return pgn.str();
+    }
+
     std::string GameResult::stringifyResult() const {
         switch (specificRes) {
             case SpecificResult::InProgress:
@@ -2,6 +2,8 @@
 
 #include "Player.h"
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace Chess {
 
@@ -27,7 +29,12 @@ namespace Chess {
             BlackNoIrreversibleMoveMade = WhiteNoIrreversibleMoveMade + BlackResult,
         } specificRes;
 
-        std::string pgn;
+        // Empty for the standard start position
+        std::string startFEN;
+        std::vector<Move> moves;
+
+        // Move text like "1. e4 e5 2. Nf3 ", only built when called since it needs SAN for every move
+        [[nodiscard]] std::string pgn() const;
 
         [[nodiscard]] Final final() const;
 
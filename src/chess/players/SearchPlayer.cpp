@@ -0,0 +1,54 @@
+#include "SearchPlayer.h"
+#include "../../util/Assertions.h"
+#include "../../util/Trace.h"
+#include "../MoveGen.h"
+
+namespace Chess {
+
+    std::unique_ptr<PlayerGameState> SearchPlayer::startGame(Color) const {
+        return std::make_unique<SearchGame>(m_limit, m_threads);
+    }
+
+    std::string SearchPlayer::name() const {
+        if (m_threads > 1) {
+            return "Search " + m_limit.toString() + " threads " + std::to_string(m_threads);
+        }
+        return "Search " + m_limit.toString();
+    }
+
+    bool SearchPlayer::isDeterministic() const {
+        return m_limit.type != SearchLimit::MoveTime && m_threads == 1;
+    }
+
+    Move SearchPlayer::SearchGame::pickMove(const Board& board, [[maybe_unused]] const MoveList& list) {
+        TRACE_SCOPE("SearchGame::pickMove");
+        m_lastResult = m_search.run(board);
+        ASSERT(list.contains(m_lastResult.bestMove));
+        return m_lastResult.bestMove;
+    }
+
+    SearchPlayer::SearchGame::SearchGame(SearchLimit limit, size_t threads) : m_search(limit, threads) {
+    }
+
+    SearchPlayer::SearchPlayer(SearchLimit limit, size_t threads) : m_limit(limit), m_threads(threads) {
+        ASSERT(threads > 0);
+    }
+
+    std::unique_ptr<Player> searchPlayer(SearchLimit limit, size_t threads) {
+        return std::make_unique<SearchPlayer>(limit, threads);
+    }
+
+    std::vector<Explainer::ExplainedMove> explainLines(const Board& board, const SearchResult& result) {
+        std::vector<Explainer::ExplainedMove> explained;
+        for (const SearchLine& line : result.lines) {
+            std::string comment = "depth " + std::to_string(line.depth) + ":";
+            Board position = board;
+            for (Move move : line.pv) {
+                comment += ' ' + position.moveToSAN(move);
+                position.makeMove(move);
+            }
+            explained.push_back({line.move, line.score, std::move(comment)});
+        }
+        return explained;
+    }
+}// namespace Chess
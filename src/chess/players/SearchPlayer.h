@@ -0,0 +1,44 @@
+#pragma once
+
+#include "../ParallelSearch.h"
+#include "../Search.h"
+#include "Player.h"
+
+namespace Chess {
+
+    // Plays the best move found by the native Search, an in process alternative to StockfishPlayer.
+    // With more than one thread the search is a ParallelSearch and no longer deterministic.
+    class SearchPlayer : public Player {
+    public:
+        std::unique_ptr<PlayerGameState> startGame(Color color) const override;
+        std::string name() const override;
+        bool isDeterministic() const override;
+
+        struct SearchGame : public PlayerGameState {
+            Move pickMove(const Board& board, const MoveList& list) override;
+
+            SearchGame(SearchLimit limit, size_t threads);
+
+            // Result of the search for the last picked move
+            [[nodiscard]] const SearchResult& lastResult() const {
+                return m_lastResult;
+            }
+
+        private:
+            ParallelSearch m_search;
+            SearchResult m_lastResult;
+        };
+
+        explicit SearchPlayer(SearchLimit limit, size_t threads = 1);
+
+    private:
+        SearchLimit m_limit;
+        size_t m_threads;
+    };
+
+    std::unique_ptr<Player> searchPlayer(SearchLimit limit, size_t threads = 1);
+
+    // The lines of a search of board best first for Explainer::outputMoveListRanking, commented with
+    // their depth and principal variation in SAN
+    [[nodiscard]] std::vector<Explainer::ExplainedMove> explainLines(const Board& board, const SearchResult& result);
+}// namespace Chess
@@ -1,10 +1,14 @@
 #include "Stockfish.h"
+#include <algorithm>
+#include <charconv>
 #include <iostream>
 
 #include "../../util/Assertions.h"
 #include "../../util/Process.h"
 #include "../../util/StringUtil.h"
+#include "../../util/Trace.h"
 #include "../Board.h"
+#include "../Search.h"
 
 //#define STOCKFISH_DEBUG
 #ifdef STOCKFISH_DEBUG
@@ -50,16 +54,16 @@ namespace Chess {
                                                                                               type(tp) {
     }
 
-    Stockfish::MoveResult Stockfish::bestMove(const Board& board) const {
+    template<typename F>
+    std::string Stockfish::search(const Board& board, F&& onInfo) const {
         WRITE_LINE("position fen " + board.toFEN() + "\n" + m_limitedGo);
         m_proc->writeTo("position fen " + board.toFEN() + "\n" + m_limitedGo);
         std::string line;
 
-        std::string lastInfo;
         while (m_proc->readLine(line)) {
             READ_LINE(line);
-            if (line.find("seldepth") != std::string::npos) {
-                lastInfo = line;
+            if (line.starts_with("info")) {
+                onInfo(line);
             } else if (line.find("bestmove") != std::string::npos) {
                 break;
             }
@@ -68,21 +72,117 @@ namespace Chess {
         ASSERT(line.find("bestmove") != std::string::npos);
         ASSERT(line.back() == '\n');
         line.pop_back();
+        return line;
+    }
 
-        auto parts = util::split(line, " ");
-        ASSERT(parts.size() >= 2);
-        auto bestMove = parts[1];
+    Stockfish::MoveResult Stockfish::bestMove(const Board& board) const {
+        TRACE_SCOPE("Stockfish::bestMove");
+        std::optional<Line> lastInfo;
+        std::string line = search(board, [&lastInfo](std::string_view info) {
+            if (auto parsed = parseInfo(info); parsed.has_value()) {
+                lastInfo = std::move(parsed);
+            }
+        });
 
-        // TODO: extract score
-        //        std::cout << "Got move: " << bestMove << " and score: \n" << lastInfo;
+        util::Tokenizer tokens(line, ' ');
+        [[maybe_unused]] auto command = tokens.next();
+        auto bestMove = tokens.next();
+        ASSERT(command == "bestmove" && bestMove.has_value());
 
         std::cout << "Bestmove line: " << line << '\n';
 
         return {
-                std::string(bestMove),
+                std::string(bestMove.value_or("")),
+                lastInfo.has_value() ? lastInfo->score : 0,
         };
     }
 
+    std::vector<Stockfish::Line> Stockfish::analyse(const Board& board, uint32_t lines) const {
+        TRACE_SCOPE("Stockfish::analyse");
+        WRITE_LINE("setoption name MultiPV value " + std::to_string(lines) + "\n");
+        m_proc->writeTo("setoption name MultiPV value " + std::to_string(lines) + "\n");
+
+        // the last info of every line is from the deepest iteration that finished it
+        std::vector<Line> ranked;
+        search(board, [&ranked](std::string_view info) {
+            auto parsed = parseInfo(info);
+            if (!parsed.has_value()) {
+                return;
+            }
+            if (ranked.size() < parsed->rank) {
+                ranked.resize(parsed->rank);
+            }
+            ranked[parsed->rank - 1] = std::move(*parsed);
+        });
+
+        WRITE_LINE("setoption name MultiPV value 1\n");
+        m_proc->writeTo("setoption name MultiPV value 1\n");
+
+        // a line could only be missing if the limit stopped the search before reaching it
+        ranked.erase(std::remove_if(ranked.begin(), ranked.end(), [](const Line& line) {
+                         return line.pv.empty();
+                     }),
+                     ranked.end());
+        return ranked;
+    }
+
+    template<typename T>
+    static bool parseNumber(std::optional<std::string_view> token, T& value) {
+        if (!token.has_value()) {
+            return false;
+        }
+        auto [ptr, ec] = std::from_chars(token->data(), token->data() + token->size(), value);
+        return ec == std::errc() && ptr == token->data() + token->size();
+    }
+
+    std::optional<Stockfish::Line> Stockfish::parseInfo(std::string_view text) {
+        util::Tokenizer tokens(text);
+        if (tokens.next() != "info") {
+            return std::nullopt;
+        }
+
+        Line line;
+        bool hasDepth = false;
+        bool hasScore = false;
+        while (auto token = tokens.next()) {
+            if (token == "depth") {
+                hasDepth = parseNumber(tokens.next(), line.depth);
+            } else if (token == "multipv") {
+                if (!parseNumber(tokens.next(), line.rank) || line.rank == 0) {
+                    return std::nullopt;
+                }
+            } else if (token == "score") {
+                auto kind = tokens.next();
+                int32_t value = 0;
+                if (!parseNumber(tokens.next(), value)) {
+                    return std::nullopt;
+                }
+                if (kind == "cp") {
+                    line.score = value;
+                } else if (kind == "mate") {
+                    // in moves, mated in 0 moves means already mated
+                    line.score = value > 0 ? mateScore - (2 * value - 1) : -mateScore - 2 * value;
+                } else {
+                    return std::nullopt;
+                }
+                hasScore = true;
+            } else if (token == "lowerbound" || token == "upperbound") {
+                return std::nullopt;
+            } else if (token == "pv") {
+                // always the last part of the line
+                while (auto move = tokens.next()) {
+                    line.pv.emplace_back(*move);
+                }
+            }
+        }
+
+        if (!hasDepth || !hasScore || line.pv.empty()) {
+            return std::nullopt;
+        }
+        line.move = line.pv.front();
+        return line;
+    }
+
     static std::string g_stockfish_location{};
 
     void setStockfishLocation(std::string s) {
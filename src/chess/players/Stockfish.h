@@ -3,7 +3,10 @@
 #include "../Move.h"
 #include "../Types.h"
 #include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace util {
     class SubProcess;
@@ -36,16 +39,42 @@ namespace Chess {
 
         struct MoveResult {
             std::string bestMove;
-            int32_t score;
+            // centipawns or a mate score like the native search (see mateScore) for the side to
+            // move, 0 if Stockfish sent no score
+            int32_t score = 0;
         };
 
         MoveResult bestMove(const Board& board) const;
 
+        // One line of "info" output, moves in UCI notation
+        struct Line {
+            // 1 for the best line, see analyse
+            uint32_t rank = 1;
+            std::string move;
+            // like MoveResult::score
+            int32_t score = 0;
+            uint32_t depth = 0;
+            // starting with move
+            std::vector<std::string> pv;
+        };
+
+        // The best lines moves (fewer if there are not as many legal moves) best first, each from
+        // the deepest iteration Stockfish finished for it within the limit
+        [[nodiscard]] std::vector<Line> analyse(const Board& board, uint32_t lines) const;
+
+        // nullopt for info lines without a depth, exact score and pv (for example bound only updates)
+        [[nodiscard]] static std::optional<Line> parseInfo(std::string_view line);
+
         explicit Stockfish(SearchLimit limit, int difficulty = 20);
 
         ~Stockfish();
 
     private:
+        // Sends the position and the go command, calls onInfo for every info line until the bestmove
+        // line which is returned (without newline)
+        template<typename F>
+        std::string search(const Board& board, F&& onInfo) const;
+
         std::string m_limitedGo;
         std::unique_ptr<util::SubProcess> m_proc;
     };
@@ -1,5 +1,6 @@
 #include "StockfishPlayer.h"
 #include "../../util/Assertions.h"
+#include "../../util/Trace.h"
 #include "../MoveGen.h"
 #include <iostream>
 
@@ -19,6 +20,7 @@ namespace Chess {
 
 
     Move StockfishPlayer::StockfishGame::pickMove(const Board& board, const MoveList& list) {
+        TRACE_SCOPE("StockfishGame::pickMove");
         auto result = stockfish.bestMove(board);
         Move mv;
         list.hasMove([&mv, &bestMove = result.bestMove](const Move& move) {
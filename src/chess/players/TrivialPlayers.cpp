@@ -6,15 +6,7 @@ namespace Chess {
     Move moveAtIndex(const MoveList& list, size_t index) {
         ASSERT(list.size() > 0);
         ASSERT(index < list.size());
-        Move mv;
-
-        list.forEachMove([&, i = 0u](const Move& move) mutable {
-            if (index == i) {
-                mv = move;
-            }
-            ++i;
-        });
-
+        Move mv = list[index];
         ASSERT(mv.fromPosition != mv.toPosition);
         return mv;
     }
@@ -1,7 +1,9 @@
 #pragma once
 
+#include "../../util/Assertions.h"
 #include "../../util/RandomUtil.h"
 #include "../MoveGen.h"
+#include "../SANList.h"
 #include "Player.h"
 #include <cstdint>
 #include <functional>
@@ -127,13 +129,27 @@ namespace Chess {
     };
 
     template<bool Ascending = true>
-    class PGNAlphabeticallyPlayer : public RankingPlayer<std::string, Ordering<Ascending>> {
+    class PGNAlphabeticallyPlayer : public StatelessPlayer {
     public:
         std::string name() const override {
             return std::string("PGN") + (Ascending ? "AFirst" : "ZFirst");
         }
-        std::string rankMove(Move mv, const Board& board) override {
-            return board.moveToSAN(mv);
+
+        bool isDeterministic() const override {
+            return true;
+        }
+
+        // Not a RankingPlayer since rendering all SAN at once is much cheaper than per move
+        Move pickMove(const Board& board, const MoveList& list) final {
+            ASSERT(list.size() > 0);
+            SANList sans = board.movesToSAN(list);
+            size_t best = 0;
+            for (size_t i = 1; i < sans.size(); ++i) {
+                if (Ordering<Ascending>{}(sans[i], sans[best])) {
+                    best = i;
+                }
+            }
+            return sans.move(best);
         }
     };
 
@@ -1,8 +1,10 @@
 #include "chess/Move.h"
 #include "chess/Piece.h"
 #include <chess/Board.h>
+#include <chess/HotPathCounters.h>
 #include <chess/MoveGen.h>
 #include <chess/players/Game.h>
+#include <chess/players/SearchPlayer.h>
 #include <chess/players/Stockfish.h>
 #include <chess/players/TrivialPlayers.h>
 #include <cstddef>
@@ -12,6 +14,7 @@
 #include <sstream>
 #include <string>
 #include <util/RandomUtil.h>
+#include <util/Trace.h>
 #include <chess/players/StockfishPlayer.h>
 
 std::optional<std::string> envVar(const std::string& name) {
@@ -24,6 +27,11 @@ std::optional<std::string> envVar(const std::string& name) {
 
 int main(int argc, char** argv) {
     bool hasStockfish = false;
+    std::optional<std::string> traceFile;
+
+    if (Chess::Counters::enabled()) {
+        Chess::Counters::dumpAtExit();
+    }
 
     {
         auto stockfishLoc = envVar("STOCKFISH_PATH");
@@ -43,10 +51,31 @@ int main(int argc, char** argv) {
                 }
                 Chess::setStockfishLocation(argv[i]);
                 hasStockfish = true;
+            } else if (argv[i] == std::string("--trace")) {
+                i++;
+                if (i >= argc) {
+                    std::cout << "Trace argument missing value\n";
+                    return 1;
+                }
+                traceFile = argv[i];
             }
         }
     }
 
+    if (traceFile.has_value()) {
+        util::Trace::start();
+    }
+
+    auto writeTrace = [&traceFile] {
+        if (!traceFile.has_value()) {
+            return;
+        }
+        util::Trace::stop();
+        if (!util::Trace::writeChromeTrace(*traceFile)) {
+            std::cout << "Failed to write trace to " << *traceFile << '\n';
+        }
+    };
+
     int status = 0;
 
 //    auto rand = Chess::randomPlayer();
@@ -66,6 +95,7 @@ int main(int argc, char** argv) {
             Chess::alphabetically(true),
             Chess::alphabetically(false),
             Chess::randomPlayer(),
+            Chess::searchPlayer(Chess::SearchLimit::depth(4)),
     };
 //
 //    for (const auto& white : players) {
@@ -76,7 +106,7 @@ int main(int argc, char** argv) {
 //                          << (res.final() == Chess::GameResult::Final::BlackWin ? "Black" : "White")
 //                          << " won\n"
 //                          << white->name() << " vs " << black->name() << "\n"
-//                          << "PGN: " << res.pgn << '\n';
+//                          << "PGN: " << res.pgn() << '\n';
 //            }
 //        }
 //    }
@@ -85,7 +115,7 @@ int main(int argc, char** argv) {
         auto result = Chess::playGame(white, black);
         std::cout << white->name() << " vs " << black->name() << "\n"
                   << result.stringifyResult() << '\n'
-                  << "PGN: " << result.pgn << "\n\n";
+                  << "PGN: " << result.pgn() << "\n\n";
         return result;
     };
 
@@ -97,8 +127,10 @@ int main(int argc, char** argv) {
             playGame(white, stockfishGood);
         }
 
+        writeTrace();
         return 0;
     }
 
+    writeTrace();
     return status;
 }
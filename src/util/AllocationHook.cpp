@@ -0,0 +1,131 @@
+// Replaces the global operator new/delete to count allocations, see Allocations.h
+// This file must be compiled directly into an executable and never into the Actions library.
+
+#include "Allocations.h"
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+    [[noreturn]] void allocationFailed() {
+#ifdef __cpp_exceptions
+        throw std::bad_alloc();
+#else
+        std::abort();
+#endif
+    }
+
+    void* countedAllocate(std::size_t size) {
+        util::Allocations::recordAllocation(size);
+        void* ptr = std::malloc(size == 0 ? 1 : size);
+        if (ptr == nullptr) {
+            allocationFailed();
+        }
+        return ptr;
+    }
+
+    void* countedAlignedAllocate(std::size_t size, std::align_val_t alignment) {
+        util::Allocations::recordAllocation(size);
+        auto align = static_cast<std::size_t>(alignment);
+        // aligned_alloc requires a size which is a multiple of the alignment
+        std::size_t rounded = (size + align - 1) / align * align;
+#ifdef _MSC_VER
+        void* ptr = _aligned_malloc(rounded == 0 ? align : rounded, align);
+#else
+        void* ptr = std::aligned_alloc(align, rounded == 0 ? align : rounded);
+#endif
+        if (ptr == nullptr) {
+            allocationFailed();
+        }
+        return ptr;
+    }
+
+    void countedFree(void* ptr) noexcept {
+        if (ptr != nullptr) {
+            util::Allocations::recordDeallocation();
+            std::free(ptr);
+        }
+    }
+
+    void countedAlignedFree(void* ptr) noexcept {
+        if (ptr != nullptr) {
+            util::Allocations::recordDeallocation();
+#ifdef _MSC_VER
+            _aligned_free(ptr);
+#else
+            std::free(ptr);
+#endif
+        }
+    }
+
+    [[maybe_unused]] const bool hookInstalled = [] {
+        util::Allocations::markHookInstalled();
+        return true;
+    }();
+}
+
+void* operator new(std::size_t size) {
+    return countedAllocate(size);
+}
+
+void* operator new[](std::size_t size) {
+    return countedAllocate(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    util::Allocations::recordAllocation(size);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    util::Allocations::recordAllocation(size);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return countedAlignedAllocate(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return countedAlignedAllocate(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept {
+    countedFree(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    countedFree(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    countedFree(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    countedFree(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    countedFree(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    countedFree(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+    countedAlignedFree(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept {
+    countedAlignedFree(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {
+    countedAlignedFree(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept {
+    countedAlignedFree(ptr);
+}
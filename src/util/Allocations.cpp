@@ -0,0 +1,50 @@
+#include "Allocations.h"
+
+namespace util::Allocations {
+
+    static bool s_hookInstalled = false;
+
+    // Plain constant initialized values so using them from within operator new is always safe
+    static thread_local Stats t_stats{};
+
+    bool countingEnabled() {
+        return s_hookInstalled;
+    }
+
+    Stats current() {
+        return t_stats;
+    }
+
+    void markHookInstalled() {
+        s_hookInstalled = true;
+    }
+
+    void recordAllocation(size_t bytes) {
+        ++t_stats.allocations;
+        t_stats.bytes += bytes;
+    }
+
+    void recordDeallocation() {
+        ++t_stats.deallocations;
+    }
+
+    Counter::Counter() : m_start(current()) {
+    }
+
+    Stats Counter::stats() const {
+        return current() - m_start;
+    }
+
+    uint64_t Counter::allocations() const {
+        return stats().allocations;
+    }
+
+    uint64_t Counter::bytes() const {
+        return stats().bytes;
+    }
+
+    void Counter::reset() {
+        m_start = current();
+    }
+
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace util::Allocations {
+
+    // Counting only happens when AllocationHook.cpp is linked into the executable
+    // (see the WITH_ALLOCATION_COUNTING cmake option), otherwise all counts stay 0.
+    // All counts are per thread.
+
+    struct Stats {
+        uint64_t allocations = 0;
+        uint64_t deallocations = 0;
+        uint64_t bytes = 0;
+
+        Stats operator-(const Stats& rhs) const {
+            return {allocations - rhs.allocations,
+                    deallocations - rhs.deallocations,
+                    bytes - rhs.bytes};
+        }
+    };
+
+    [[nodiscard]] bool countingEnabled();
+
+    [[nodiscard]] Stats current();
+
+    class Counter {
+    public:
+        Counter();
+
+        [[nodiscard]] Stats stats() const;
+
+        [[nodiscard]] uint64_t allocations() const;
+
+        [[nodiscard]] uint64_t bytes() const;
+
+        void reset();
+
+    private:
+        Stats m_start;
+    };
+
+    // Only meant to be called from the operator new/delete replacements
+    void markHookInstalled();
+
+    void recordAllocation(size_t bytes);
+
+    void recordDeallocation();
+
+}
@@ -0,0 +1,112 @@
+#include "MappedFile.h"
+#include <cstdio>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace util {
+
+    std::optional<MappedFile> MappedFile::open(const std::string& path) {
+        MappedFile file;
+#ifdef _WIN32
+        HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                    FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (handle == INVALID_HANDLE_VALUE) {
+            std::fprintf(stderr, "CreateFile failed: %lu\n", GetLastError());
+            return std::nullopt;
+        }
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(handle, &size)) {
+            std::fprintf(stderr, "GetFileSizeEx failed: %lu\n", GetLastError());
+            CloseHandle(handle);
+            return std::nullopt;
+        }
+        file.m_size = static_cast<size_t>(size.QuadPart);
+        if (file.m_size > 0) {
+            HANDLE mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping == nullptr) {
+                std::fprintf(stderr, "CreateFileMapping failed: %lu\n", GetLastError());
+                CloseHandle(handle);
+                return std::nullopt;
+            }
+            file.m_data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            // the view keeps the mapping alive
+            CloseHandle(mapping);
+            if (file.m_data == nullptr) {
+                std::fprintf(stderr, "MapViewOfFile failed: %lu\n", GetLastError());
+                CloseHandle(handle);
+                return std::nullopt;
+            }
+        }
+        CloseHandle(handle);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            perror("open");
+            return std::nullopt;
+        }
+        struct stat info{};
+        if (fstat(fd, &info) < 0) {
+            perror("fstat");
+            close(fd);
+            return std::nullopt;
+        }
+        file.m_size = static_cast<size_t>(info.st_size);
+        // mapping an empty file fails so just leave it empty
+        if (file.m_size > 0) {
+            void* data = mmap(nullptr, file.m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                perror("mmap");
+                close(fd);
+                return std::nullopt;
+            }
+            // only a hint so failure does not matter
+            madvise(data, file.m_size, MADV_SEQUENTIAL);
+            file.m_data = static_cast<const char*>(data);
+        }
+        // the mapping stays valid after closing
+        close(fd);
+#endif
+        return file;
+    }
+
+    void MappedFile::unmap() {
+        if (m_data == nullptr) {
+            return;
+        }
+#ifdef _WIN32
+        UnmapViewOfFile(m_data);
+#else
+        munmap(const_cast<char*>(m_data), m_size);
+#endif
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    MappedFile::~MappedFile() {
+        unmap();
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+        : m_data(std::exchange(other.m_data, nullptr)),
+          m_size(std::exchange(other.m_size, 0)) {
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+        }
+        return *this;
+    }
+
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace util {
+
+    // Read only memory mapping of a whole file, the contents stay valid as long as the object lives.
+    class MappedFile {
+    public:
+        // Returns nullopt (after printing the reason) if the file cannot be opened or mapped
+        static std::optional<MappedFile> open(const std::string& path);
+
+        ~MappedFile();
+
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        [[nodiscard]] std::string_view contents() const {
+            return {m_data, m_size};
+        }
+
+        [[nodiscard]] size_t size() const {
+            return m_size;
+        }
+
+    private:
+        MappedFile() = default;
+
+        void unmap();
+
+        const char* m_data = nullptr;
+        size_t m_size = 0;
+    };
+
+}
@@ -0,0 +1,156 @@
+#include "PerfCounters.h"
+
+#ifdef __linux__
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace util {
+
+#ifdef __linux__
+    struct CounterConfig {
+        uint32_t type;
+        uint64_t config;
+    };
+
+    constexpr static uint64_t cacheConfig(uint64_t cache, uint64_t op, uint64_t result) {
+        return cache | (op << 8u) | (result << 16u);
+    }
+
+    constexpr static std::array<CounterConfig, PerfCounters::CounterCount> counterConfigs = {{
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            {PERF_TYPE_HW_CACHE, cacheConfig(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    }};
+
+    static int openCounter(const CounterConfig& counter) {
+        perf_event_attr attr{};
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = counter.type;
+        attr.config = counter.config;
+        attr.disabled = 1;
+        // user space only, this is allowed with the default perf_event_paranoid
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        long fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+        return fd < 0 ? -1 : static_cast<int>(fd);
+    }
+#endif
+
+    PerfCounters::PerfCounters() {
+        m_fds.fill(-1);
+#ifdef __linux__
+        for (int i = 0; i < CounterCount; ++i) {
+            m_fds[i] = openCounter(counterConfigs[i]);
+        }
+#endif
+    }
+
+    PerfCounters::~PerfCounters() {
+#ifdef __linux__
+        for (int fd : m_fds) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    bool PerfCounters::available() const {
+        for (int i = 0; i < CounterCount; ++i) {
+            if (available(static_cast<Counter>(i))) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool PerfCounters::available(Counter c) const {
+        return m_fds[c] >= 0;
+    }
+
+    void PerfCounters::start() {
+#ifdef __linux__
+        for (int fd : m_fds) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    PerfCounters::Values PerfCounters::stop() {
+        Values values{};
+#ifdef __linux__
+        for (int fd : m_fds) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            }
+        }
+
+        for (int i = 0; i < CounterCount; ++i) {
+            if (m_fds[i] < 0) {
+                continue;
+            }
+            struct {
+                uint64_t value;
+                uint64_t timeEnabled;
+                uint64_t timeRunning;
+            } result{};
+
+            if (read(m_fds[i], &result, sizeof(result)) != sizeof(result) || result.timeRunning == 0) {
+                continue;
+            }
+
+            // counters might have been multiplexed so scale up to the full time enabled
+            values.counts[i] = result.timeRunning == result.timeEnabled
+                                       ? result.value
+                                       : static_cast<uint64_t>(static_cast<double>(result.value) * result.timeEnabled / result.timeRunning);
+            values.valid[i] = true;
+        }
+#endif
+        return values;
+    }
+
+    std::string_view PerfCounters::name(Counter c) {
+        switch (c) {
+            case Cycles:
+                return "cycles";
+            case Instructions:
+                return "instructions";
+            case BranchMisses:
+                return "branch misses";
+            case L1DMisses:
+                return "L1d misses";
+            case LLCMisses:
+                return "LLC misses";
+            case CounterCount:
+                break;
+        }
+        return "unknown";
+    }
+
+    double PerfCounters::Values::perUnit(Counter c, uint64_t units) const {
+        if (!valid[c] || units == 0) {
+            return 0.0;
+        }
+        return static_cast<double>(counts[c]) / static_cast<double>(units);
+    }
+
+    double PerfCounters::Values::instructionsPerCycle() const {
+        if (!valid[Cycles] || !valid[Instructions] || counts[Cycles] == 0) {
+            return 0.0;
+        }
+        return static_cast<double>(counts[Instructions]) / static_cast<double>(counts[Cycles]);
+    }
+
+}
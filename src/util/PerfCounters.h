@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace util {
+
+    // Thin wrapper around hardware performance counters (perf_event_open on Linux).
+    // Every counter is opened separately so a missing one (common in VMs and containers)
+    // only disables that counter, on other platforms nothing is ever available.
+    class PerfCounters {
+    public:
+        enum Counter {
+            Cycles = 0,
+            Instructions,
+            BranchMisses,
+            L1DMisses,
+            LLCMisses,
+            CounterCount
+        };
+
+        struct Values {
+            std::array<uint64_t, CounterCount> counts{};
+            std::array<bool, CounterCount> valid{};
+
+            [[nodiscard]] bool has(Counter c) const {
+                return valid[c];
+            }
+
+            [[nodiscard]] double perUnit(Counter c, uint64_t units) const;
+
+            [[nodiscard]] double instructionsPerCycle() const;
+        };
+
+        PerfCounters();
+
+        ~PerfCounters();
+
+        PerfCounters(const PerfCounters&) = delete;
+        PerfCounters& operator=(const PerfCounters&) = delete;
+
+        [[nodiscard]] bool available() const;
+
+        [[nodiscard]] bool available(Counter c) const;
+
+        void start();
+
+        Values stop();
+
+        static std::string_view name(Counter c);
+
+    private:
+        std::array<int, CounterCount> m_fds;
+    };
+
+}
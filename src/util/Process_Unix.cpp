@@ -6,6 +6,7 @@
 
 #include "Assertions.h"
 #include "StringUtil.h"
+#include "Trace.h"
 #include <csignal>
 #include <cstdlib>
 #include <fcntl.h>
@@ -27,6 +28,7 @@ namespace util {
     }
 
     bool SubProcess::writeTo(std::string_view str) const {
+        TRACE_SCOPE("SubProcess::writeTo");
         if (!running) {
             return false;
         }
@@ -63,6 +65,7 @@ namespace util {
     }
 
     bool SubProcess::readLine(std::string& line) const {
+        TRACE_SCOPE("SubProcess::readLine");
         if (!running) {
             return false;
         }
@@ -1,5 +1,6 @@
 #include "Process.h"
 #include "Assertions.h"
+#include "Trace.h"
 
 #ifndef WINDOWS_PROCESS
 #error Only for windows process handling
@@ -33,6 +34,7 @@ namespace util {
     }
 
     bool SubProcess::writeTo(std::string_view str) const {
+        TRACE_SCOPE("SubProcess::writeTo");
         char const* head = str.data();
         DWORD toWrite = str.size();
 
@@ -50,6 +52,7 @@ namespace util {
     }
 
     bool SubProcess::readLine(std::string& line) const {
+        TRACE_SCOPE("SubProcess::readLine");
         while (!readLineFromBuffer(line)) {
             DWORD readBytes;
             if (!ReadFile(m_stdOut, readBuffer.data() + m_bufferLoc, readBuffer.size() - m_bufferLoc,
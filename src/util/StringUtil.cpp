@@ -1,9 +1,20 @@
 #include "StringUtil.h"
 #include <cstddef>
 #include <algorithm>
+#include <bit>
+#include <cstring>
 #include <iterator>
 #include <vector>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define STRING_SCAN_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define STRING_SCAN_SSE2 1
+#endif
+
 
 namespace util {
     std::vector<std::string_view> split(std::string_view vw, std::string_view separator) {
@@ -33,4 +44,61 @@ namespace util {
         return parts;
     }
 
+    size_t detail::findFirstOfScalar(std::string_view text, CharSet chars, size_t from) {
+        for (size_t i = from; i < text.size(); ++i) {
+            if (chars.contains(text[i])) {
+                return i;
+            }
+        }
+        return std::string_view::npos;
+    }
+
+    size_t findFirstOf(std::string_view text, CharSet chars, size_t from) {
+        if (from >= text.size()) {
+            return std::string_view::npos;
+        }
+        const char* data = text.data();
+        if (chars.isSingle()) {
+            const void* found = std::memchr(data + from, chars[0], text.size() - from);
+            return found == nullptr ? std::string_view::npos : static_cast<size_t>(static_cast<const char*>(found) - data);
+        }
+        size_t i = from;
+
+#ifdef STRING_SCAN_AVX2
+        if (i + 32 <= text.size()) {
+            const __m256i c0 = _mm256_set1_epi8(chars[0]);
+            const __m256i c1 = _mm256_set1_epi8(chars[1]);
+            const __m256i c2 = _mm256_set1_epi8(chars[2]);
+            const __m256i c3 = _mm256_set1_epi8(chars[3]);
+            for (; i + 32 <= text.size(); i += 32) {
+                __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                __m256i matches = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(block, c0), _mm256_cmpeq_epi8(block, c1)),
+                                                  _mm256_or_si256(_mm256_cmpeq_epi8(block, c2), _mm256_cmpeq_epi8(block, c3)));
+                if (auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(matches)); mask != 0) {
+                    return i + std::countr_zero(mask);
+                }
+            }
+        }
+#endif
+
+#ifdef STRING_SCAN_SSE2
+        if (i + 16 <= text.size()) {
+            const __m128i c0 = _mm_set1_epi8(chars[0]);
+            const __m128i c1 = _mm_set1_epi8(chars[1]);
+            const __m128i c2 = _mm_set1_epi8(chars[2]);
+            const __m128i c3 = _mm_set1_epi8(chars[3]);
+            for (; i + 16 <= text.size(); i += 16) {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                __m128i matches = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, c0), _mm_cmpeq_epi8(block, c1)),
+                                               _mm_or_si128(_mm_cmpeq_epi8(block, c2), _mm_cmpeq_epi8(block, c3)));
+                if (auto mask = static_cast<uint32_t>(_mm_movemask_epi8(matches)); mask != 0) {
+                    return i + std::countr_zero(mask);
+                }
+            }
+        }
+#endif
+
+        return detail::findFirstOfScalar(text, chars, i);
+    }
+
 }
@@ -1,4 +1,10 @@
 #pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
 #include <string_view>
 #include <vector>
 
@@ -6,4 +12,182 @@ namespace util {
 
     std::vector<std::string_view> split(std::string_view vw, std::string_view separator);
 
-}
\ No newline at end of file
+    // One to four characters to scan for. Unused slots repeat the first character so a scan always
+    // compares against all four without branching on the amount.
+    class CharSet {
+    public:
+        constexpr CharSet(char c) : m_chars{c, c, c, c} {
+        }
+
+        // Only the first four characters are used
+        constexpr explicit CharSet(std::string_view chars) {
+            for (size_t i = 0; i < m_chars.size(); ++i) {
+                m_chars[i] = i < chars.size() ? chars[i] : chars[0];
+            }
+        }
+
+        [[nodiscard]] constexpr bool contains(char c) const {
+            return c == m_chars[0] || c == m_chars[1] || c == m_chars[2] || c == m_chars[3];
+        }
+
+        [[nodiscard]] constexpr char operator[](size_t index) const {
+            return m_chars[index];
+        }
+
+        [[nodiscard]] constexpr bool isSingle() const {
+            return m_chars[0] == m_chars[1] && m_chars[0] == m_chars[2] && m_chars[0] == m_chars[3];
+        }
+
+    private:
+        std::array<char, 4> m_chars{};
+    };
+
+    inline constexpr CharSet whitespace{" \t\r\n"};
+
+    // Index of the first character at or after from which is in chars, npos if there is none.
+    // Scans 16 (SSE2) or 32 (AVX2, see WITH_AVX2) bytes at a time where available, a single
+    // character uses memchr which the C library already vectorizes.
+    [[nodiscard]] size_t findFirstOf(std::string_view text, CharSet chars, size_t from = 0);
+
+    namespace detail {
+        // The fallback of findFirstOf, one character at a time
+        [[nodiscard]] size_t findFirstOfScalar(std::string_view text, CharSet chars, size_t from);
+    }
+
+    // Input iterator over the views returned by Scanner::next() until it returns nullopt
+    template<typename Scanner>
+    class ScanIterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view*;
+        using reference = const std::string_view&;
+
+        ScanIterator() = default;
+
+        explicit ScanIterator(Scanner* scanner) : m_scanner(scanner) {
+            ++*this;
+        }
+
+        reference operator*() const {
+            return m_current;
+        }
+
+        pointer operator->() const {
+            return &m_current;
+        }
+
+        ScanIterator& operator++() {
+            if (auto value = m_scanner->next(); value.has_value()) {
+                m_current = *value;
+            } else {
+                m_scanner = nullptr;
+            }
+            return *this;
+        }
+
+        void operator++(int) {
+            ++*this;
+        }
+
+        bool operator==(const ScanIterator& other) const {
+            return m_scanner == other.m_scanner;
+        }
+
+    private:
+        Scanner* m_scanner = nullptr;
+        std::string_view m_current;
+    };
+
+    // Splits text on any of the delimiters without allocating, runs of delimiters do not give empty
+    // tokens. The tokens are views into the text.
+    class Tokenizer {
+    public:
+        explicit Tokenizer(std::string_view text, CharSet delimiters = whitespace)
+            : m_text(text),
+              m_delimiters(delimiters) {
+        }
+
+        [[nodiscard]] std::optional<std::string_view> next() {
+            while (m_position < m_text.size() && m_delimiters.contains(m_text[m_position])) {
+                ++m_position;
+            }
+            if (m_position >= m_text.size()) {
+                return std::nullopt;
+            }
+            size_t start = m_position;
+            // most tokens are short, only scan wide once a token is longer than a single block
+            size_t shortEnd = std::min(m_text.size(), start + shortToken);
+            while (m_position < shortEnd && !m_delimiters.contains(m_text[m_position])) {
+                ++m_position;
+            }
+            if (m_position == shortEnd && shortEnd < m_text.size()) {
+                m_position = std::min(findFirstOf(m_text, m_delimiters, shortEnd), m_text.size());
+            }
+            return m_text.substr(start, m_position - start);
+        }
+
+        // Offset in the text just past the last returned token
+        [[nodiscard]] size_t position() const {
+            return m_position;
+        }
+
+        [[nodiscard]] ScanIterator<Tokenizer> begin() {
+            return ScanIterator<Tokenizer>(this);
+        }
+
+        [[nodiscard]] ScanIterator<Tokenizer> end() {
+            return {};
+        }
+
+    private:
+        constexpr static size_t shortToken = 16;
+
+        std::string_view m_text;
+        CharSet m_delimiters;
+        size_t m_position = 0;
+    };
+
+    // Every line of the text without the '\n' and a '\r' before it, empty lines included. A last
+    // line without a newline is returned as well.
+    class LineScanner {
+    public:
+        explicit LineScanner(std::string_view text) : m_text(text) {
+        }
+
+        [[nodiscard]] std::optional<std::string_view> next() {
+            if (m_position >= m_text.size()) {
+                return std::nullopt;
+            }
+            m_lineStart = m_position;
+            size_t end = findFirstOf(m_text, '\n', m_position);
+            end = end == std::string_view::npos ? m_text.size() : end;
+            m_position = end + 1;
+            std::string_view line = m_text.substr(m_lineStart, end - m_lineStart);
+            if (!line.empty() && line.back() == '\r') {
+                line.remove_suffix(1);
+            }
+            return line;
+        }
+
+        // Offset in the text of the start of the last returned line
+        [[nodiscard]] size_t lineStart() const {
+            return m_lineStart;
+        }
+
+        [[nodiscard]] ScanIterator<LineScanner> begin() {
+            return ScanIterator<LineScanner>(this);
+        }
+
+        [[nodiscard]] ScanIterator<LineScanner> end() {
+            return {};
+        }
+
+    private:
+        std::string_view m_text;
+        size_t m_position = 0;
+        size_t m_lineStart = 0;
+    };
+
+}
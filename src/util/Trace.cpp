@@ -0,0 +1,198 @@
+#include "Trace.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+
+namespace util::Trace {
+
+    namespace Detail {
+        std::atomic<bool> g_enabled = false;
+    }
+
+    namespace {
+        using Clock = std::chrono::steady_clock;
+
+        struct ThreadBuffer {
+            // only contended while collecting the events
+            std::mutex lock;
+            std::vector<Event> ring;
+            size_t next = 0;
+            bool wrapped = false;
+            bool inUse = false;
+
+            void reset(size_t capacity) {
+                ring.clear();
+                ring.resize(capacity);
+                next = 0;
+                wrapped = false;
+            }
+
+            void append(std::vector<Event>& out) {
+                std::lock_guard guard(lock);
+                if (wrapped) {
+                    out.insert(out.end(), ring.begin() + static_cast<std::ptrdiff_t>(next), ring.end());
+                }
+                out.insert(out.end(), ring.begin(), ring.begin() + static_cast<std::ptrdiff_t>(next));
+            }
+        };
+
+        struct Registry {
+            std::mutex lock;
+            // Buffers are never freed, when a thread exits its buffer (and events) are kept and
+            // handed to the next thread which starts tracing.
+            std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+            size_t capacity = DefaultEventsPerThread;
+            uint32_t nextThreadId = 1;
+        };
+
+        std::atomic<Clock::rep> g_originTicks = 0;
+
+        Registry& registry() {
+            // leaked to stay valid for threads exiting during static destruction
+            static auto* reg = new Registry();
+            return *reg;
+        }
+
+        struct ThreadState {
+            ThreadBuffer* buffer = nullptr;
+            uint32_t threadId = 0;
+
+            ~ThreadState() {
+                if (buffer != nullptr) {
+                    std::lock_guard guard(registry().lock);
+                    buffer->inUse = false;
+                }
+            }
+
+            ThreadBuffer& acquire() {
+                if (buffer != nullptr) {
+                    return *buffer;
+                }
+
+                auto& reg = registry();
+                std::lock_guard guard(reg.lock);
+                threadId = reg.nextThreadId++;
+                auto freeBuffer = std::find_if(reg.buffers.begin(), reg.buffers.end(), [](const auto& b) {
+                    return !b->inUse;
+                });
+                if (freeBuffer != reg.buffers.end()) {
+                    buffer = freeBuffer->get();
+                } else {
+                    buffer = reg.buffers.emplace_back(std::make_unique<ThreadBuffer>()).get();
+                    buffer->reset(reg.capacity);
+                }
+                buffer->inUse = true;
+                return *buffer;
+            }
+        };
+
+        thread_local ThreadState t_state;
+
+        void record(const char* name, char phase) {
+            auto now = Clock::now();
+            ThreadBuffer& buffer = t_state.acquire();
+            Clock::time_point origin{Clock::duration{g_originTicks.load(std::memory_order_relaxed)}};
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - origin).count();
+
+            std::lock_guard guard(buffer.lock);
+            if (buffer.ring.empty()) {
+                return;
+            }
+            buffer.ring[buffer.next] = Event{name, static_cast<uint64_t>(std::max<int64_t>(ns, 0)), t_state.threadId, phase};
+            if (++buffer.next == buffer.ring.size()) {
+                buffer.next = 0;
+                buffer.wrapped = true;
+            }
+        }
+
+        void writeJSONString(std::ostream& out, const char* str) {
+            out << '"';
+            for (; *str != '\0'; ++str) {
+                char c = *str;
+                if (c == '"' || c == '\\') {
+                    out << '\\' << c;
+                } else if (static_cast<unsigned char>(c) < 0x20) {
+                    out << ' ';
+                } else {
+                    out << c;
+                }
+            }
+            out << '"';
+        }
+    }
+
+    void start(size_t eventsPerThread) {
+        auto& reg = registry();
+        {
+            std::lock_guard guard(reg.lock);
+            reg.capacity = eventsPerThread;
+            for (auto& buffer : reg.buffers) {
+                std::lock_guard bufferGuard(buffer->lock);
+                buffer->reset(eventsPerThread);
+            }
+            g_originTicks.store(Clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+        }
+        Detail::g_enabled.store(true, std::memory_order_relaxed);
+    }
+
+    void stop() {
+        Detail::g_enabled.store(false, std::memory_order_relaxed);
+    }
+
+    void begin(const char* name) {
+        record(name, 'B');
+    }
+
+    void end(const char* name) {
+        record(name, 'E');
+    }
+
+    std::vector<Event> events() {
+        auto& reg = registry();
+        std::vector<Event> result;
+        {
+            std::lock_guard guard(reg.lock);
+            for (auto& buffer : reg.buffers) {
+                buffer->append(result);
+            }
+        }
+        std::stable_sort(result.begin(), result.end(), [](const Event& lhs, const Event& rhs) {
+            return lhs.timestampNs < rhs.timestampNs;
+        });
+        return result;
+    }
+
+    void writeChromeTrace(std::ostream& out) {
+        auto allEvents = events();
+
+        out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        bool first = true;
+        for (const Event& event : allEvents) {
+            if (!first) {
+                out << ',';
+            }
+            first = false;
+            out << "\n{\"name\":";
+            writeJSONString(out, event.name);
+            // timestamps are in microseconds
+            out << ",\"ph\":\"" << event.phase << "\",\"ts\":" << (event.timestampNs / 1000) << '.'
+                << std::setw(3) << std::setfill('0') << (event.timestampNs % 1000) << std::setfill(' ')
+                << ",\"pid\":1,\"tid\":" << event.threadId << '}';
+        }
+        out << "\n]}\n";
+    }
+
+    bool writeChromeTrace(const std::string& path) {
+        std::ofstream file(path);
+        if (!file) {
+            return false;
+        }
+        writeChromeTrace(file);
+        return static_cast<bool>(file);
+    }
+
+}
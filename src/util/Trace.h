@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace util::Trace {
+
+    // Scoped begin/end events which can be written as Chrome trace JSON (chrome://tracing, perfetto).
+    // Tracing is off until start() is called, a disabled TRACE_SCOPE is a single relaxed load.
+    // Every thread records into its own ring buffer so when it fills up the oldest events are dropped.
+    // Event names are not copied and must be string literals (or otherwise outlive the trace).
+
+    constexpr size_t DefaultEventsPerThread = 1u << 16u;
+
+    struct Event {
+        const char* name;
+        uint64_t timestampNs;
+        uint32_t threadId;
+        char phase; // 'B' or 'E' like in the Chrome trace format
+    };
+
+    namespace Detail {
+        extern std::atomic<bool> g_enabled;
+    }
+
+    [[nodiscard]] inline bool enabled() {
+        return Detail::g_enabled.load(std::memory_order_relaxed);
+    }
+
+    // Clears all previously recorded events
+    void start(size_t eventsPerThread = DefaultEventsPerThread);
+
+    void stop();
+
+    void begin(const char* name);
+
+    void end(const char* name);
+
+    // All recorded events ordered by time, should only be called when no thread is tracing
+    [[nodiscard]] std::vector<Event> events();
+
+    void writeChromeTrace(std::ostream& out);
+
+    bool writeChromeTrace(const std::string& path);
+
+    class Scope {
+    public:
+        explicit Scope(const char* name) : m_name(enabled() ? name : nullptr) {
+            if (m_name != nullptr) {
+                begin(m_name);
+            }
+        }
+
+        ~Scope() {
+            if (m_name != nullptr) {
+                end(m_name);
+            }
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* m_name;
+    };
+
+}
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+#define TRACE_SCOPE(name) util::Trace::Scope TRACE_CONCAT(traceScope, __LINE__)(name)
@@ -1,9 +1,29 @@
+#include <array>
 #include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <chess/BitBoard.h>
+#include <chess/Evaluation.h>
+#include <chess/GameEncoding.h>
 #include <chess/MoveGen.h>
+#include <chess/NNUE.h>
+#include <chess/NNUEKernels.h>
+#include <chess/PackedBoard.h>
+#include <chess/ParallelSearch.h>
+#include <chess/PGN.h>
+#include <chess/SANList.h>
+#include <chess/Search.h>
+#include <chess/TranspositionTable.h>
 #include <chess/players/Game.h>
 #include <chess/players/TrivialPlayers.h>
+#include <iomanip>
 #include <iostream>
+#include <random>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <util/Allocations.h>
+#include <util/PerfCounters.h>
+#include <util/StringUtil.h>
 
 #define BENCHMARK_TAGS "[.][chess][benchmark]"
 
@@ -51,6 +71,38 @@ TEST_CASE("Board FEN parsing", "[fen]" BENCHMARK_TAGS) {
     TEST_FEN("1k6/1r6/2K1B3/8/8/R7/8/8 w - - 105 150", "15");
     TEST_FEN("1b6/8/1nk5/K7/8/8/8/8 b - - 47 150", "16");
 
+    {
+        constexpr auto fen = "1b1qr1k1/rp1n2p1/2p1p1bp/p2p1p2/P1PP1P2/1Q2P2P/1P1N2P1/2RRBBK1 w - - 0 19";
+        Board reused = Board::emptyBoard();
+        REQUIRE(reused.parseFEN(fen));
+
+        BENCHMARK("Parsing FEN into existing board") {
+            return reused.parseFEN(fen);
+        };
+
+        BENCHMARK("Parsing invalid FEN into existing board") {
+            return reused.parseFEN("1b1qr1k1/rp1n2p1/2p1p1bp/p2p1p2/P1PP1P2/1Q2P2P/1P1N2P1/2RRBBK1 w - - 0 0");
+        };
+
+        std::array<char, Board::maxFENLength> buffer{};
+        BENCHMARK("Writing FEN to string") {
+            return reused.toFEN();
+        };
+
+        BENCHMARK("Writing FEN to buffer") {
+            return reused.toFEN(buffer.data());
+        };
+
+        PackedBoard packed = *reused.pack();
+        BENCHMARK("Packing board") {
+            return reused.pack();
+        };
+
+        BENCHMARK("Unpacking into existing board") {
+            return reused.unpack(packed);
+        };
+    }
+
 
 }
 #undef TEST_FEN
@@ -105,6 +157,22 @@ TEST_CASE("MoveGen benchmarks", "[movegen]" BENCHMARK_TAGS) {
     TEST_FEN("1n1r1b1r/P1P1P1P1/2BNq1k1/7R/3Q4/1P1N2K1/P1PBP3/5R2 w - - 15 45", "Legal pos many moves");
 
     TEST_FEN("RNBQKBNR/PPPPPPPP/8/8/8/8/pppppppp/rnbqkbnr w - - 0 1", "Inverted start pos");
+
+    {
+        Board kiwipete = Board::fromFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1").extract();
+
+        BENCHMARK("All moves from Kiwipete") {
+            return generateAllMoves(kiwipete);
+        };
+
+        BENCHMARK("Captures from Kiwipete") {
+            return generateMoves(kiwipete, GenerationMode::Captures);
+        };
+
+        BENCHMARK("Captures and checks from Kiwipete") {
+            return generateMoves(kiwipete, GenerationMode::CapturesAndChecks);
+        };
+    }
 }
 #undef TEST_FEN
 
@@ -123,6 +191,34 @@ TEST_CASE("SAN moves benchmarks", "[san]" BENCHMARK_TAGS) {
                 ++i;                                                 \
                 REQUIRE(move == b.parseSANMove(pgns[i - 1], moves)); \
             });                                                      \
+        };                                                           \
+                                                                     \
+        BENCHMARK("Bulk PGN from FEN " note) {                       \
+            auto moves = generateAllMoves(b);                        \
+            return b.movesToSAN(moves).size();                       \
+        };                                                           \
+                                                                     \
+        BENCHMARK("Bulk PGN with checks from FEN " note) {           \
+            auto moves = generateAllMoves(b);                        \
+            return b.movesToSAN(moves, true).size();                 \
+        };                                                           \
+                                                                     \
+        SANList sans = b.movesToSAN(generateAllMoves(b));            \
+        BENCHMARK("Parse all SAN with move list " note) {            \
+            auto moves = generateAllMoves(b);                        \
+            size_t parsed = 0;                                       \
+            for (size_t j = 0; j < sans.size(); ++j) {               \
+                parsed += b.parseSANMove(sans[j], moves).has_value(); \
+            }                                                        \
+            return parsed;                                           \
+        };                                                           \
+                                                                     \
+        BENCHMARK("Parse all SAN directly " note) {                  \
+            size_t parsed = 0;                                       \
+            for (size_t j = 0; j < sans.size(); ++j) {               \
+                parsed += b.parseSANMove(sans[j]).has_value();       \
+            }                                                        \
+            return parsed;                                           \
         };                                                           \
     }
 
@@ -148,6 +244,112 @@ TEST_CASE("SAN moves benchmarks", "[san]" BENCHMARK_TAGS) {
 }
 #undef TEST_FEN
 
+TEST_CASE("PGN reading benchmarks", "[pgn]" BENCHMARK_TAGS) {
+    // long games from simple players, many more plies per game than real databases
+    std::string pgn;
+    size_t gameCount = 0;
+    for (int i = 0; i < 8; ++i) {
+        auto white = indexPlayer(i);
+        auto black = alphabetically(i % 2 == 0);
+        GameResult result = playGame(white, black);
+        pgn += "[Event \"Benchmark\"]\n[Round \"" + std::to_string(i) + "\"]\n\n" + result.pgn() + "*\n\n";
+        ++gameCount;
+    }
+
+    size_t plies = 0;
+    PGNReader(pgn).forEachGame([&plies](const PGNGame& game) {
+        REQUIRE(game.error == PGNError::None);
+        plies += game.moves.size();
+    });
+    INFO("Games " << gameCount << " plies " << plies << " bytes " << pgn.size());
+
+    BENCHMARK("Read all games") {
+        return PGNReader(pgn).forEachGame([](const PGNGame&) {});
+    };
+
+    BENCHMARK("Read all games in parallel") {
+        return readPGNParallel(pgn, std::max(1u, std::thread::hardware_concurrency()), [](const PGNGame&, size_t) {});
+    };
+
+    auto [archiveData, skipped] = pgnToArchive(pgn);
+    REQUIRE(skipped == 0);
+    auto archive = GameArchive::open(archiveData);
+    REQUIRE(archive.has_value());
+    INFO("Archive bytes " << archiveData.size());
+
+    BENCHMARK("Decode all games from archive") {
+        PGNGame game;
+        size_t decoded = 0;
+        for (size_t i = 0; i < archive->size(); ++i) {
+            decoded += archive->read(i, game) == GameDecodeError::None;
+        }
+        return decoded;
+    };
+
+    BENCHMARK("Encode all games") {
+        return pgnToArchive(pgn).first.size();
+    };
+}
+
+TEST_CASE("String scanning benchmarks", "[util][scan]" BENCHMARK_TAGS) {
+    std::string pgn;
+    for (int i = 0; i < 4; ++i) {
+        pgn += playGame(indexPlayer(i), alphabetically(i % 2 == 0)).pgn() + "*\n\n";
+    }
+    std::string infoLine = "info depth 24 seldepth 33 multipv 1 score cp 35 nodes 2183512 nps 1271200 "
+                           "hashfull 771 tbhits 0 time 1718 pv e2e4 e7e5 g1f3 b8c6 f1b5 a7a6 b5a4 g8f6";
+
+    BENCHMARK("Split PGN on spaces") {
+        return util::split(pgn, " ").size();
+    };
+
+    BENCHMARK("Tokenize PGN on spaces") {
+        size_t tokens = 0;
+        for ([[maybe_unused]] std::string_view token : util::Tokenizer(pgn, ' ')) {
+            ++tokens;
+        }
+        return tokens;
+    };
+
+    BENCHMARK("Split UCI info line") {
+        return util::split(infoLine, " ").size();
+    };
+
+    BENCHMARK("Tokenize UCI info line") {
+        size_t tokens = 0;
+        for ([[maybe_unused]] std::string_view token : util::Tokenizer(infoLine, ' ')) {
+            ++tokens;
+        }
+        return tokens;
+    };
+
+    BENCHMARK("Lines with string_view::find") {
+        size_t lines = 0;
+        for (size_t position = 0; position < pgn.size(); ++lines) {
+            size_t end = pgn.find('\n', position);
+            position = end == std::string::npos ? pgn.size() : end + 1;
+        }
+        return lines;
+    };
+
+    BENCHMARK("Lines with LineScanner") {
+        size_t lines = 0;
+        for ([[maybe_unused]] std::string_view line : util::LineScanner(pgn)) {
+            ++lines;
+        }
+        return lines;
+    };
+
+    // like skipping a long comment, the generated games have no braces at all
+    BENCHMARK("Scan whole PGN scalar") {
+        return util::detail::findFirstOfScalar(pgn, util::CharSet("{}"), 0);
+    };
+
+    BENCHMARK("Scan whole PGN") {
+        return util::findFirstOf(pgn, util::CharSet("{}"));
+    };
+}
+
 template<bool output = false>
 uint64_t countMoves(Board& board, int depth) {
     if (depth <= 0) {
@@ -378,6 +580,279 @@ TEST_CASE("Perft benchmarks", "[perft][moving]" BENCHMARK_TAGS) {
 
 }
 
+// Reversible moves only (no pawn moves, captures or castling) so that the full history stays relevant
+// for repetition detection, never visiting a position twice forces the maximal repetition scan.
+// Moves are picked randomly from the valid ones but with a fixed seed to always give the same sequence.
+std::vector<Move> reversibleSequence(Board board, size_t plies) {
+    std::vector<Move> sequence;
+    std::set<std::string> seen;
+
+    auto positionKey = [](const Board& b) {
+        std::string fen = b.toFEN();
+        // strip the clocks
+        fen.erase(fen.rfind(' '));
+        fen.erase(fen.rfind(' '));
+        return fen;
+    };
+
+    seen.insert(positionKey(board));
+    std::mt19937 rng(12345);
+
+    while (sequence.size() < plies) {
+        MoveList list = generateAllMoves(board);
+        std::vector<Move> candidates;
+        list.forEachMove([&](const Move& move) {
+            if (move.flag != Move::Flag::None
+                || board.pieceAt(move.colRowToPosition()).has_value()
+                || board.pieceAt(move.colRowFromPosition())->type() == Piece::Type::Pawn) {
+                return;
+            }
+            // avoid checks as these might slowly corner a king with only repeating moves left
+            bool unseen = board.moveExcursion(move, [&](const Board& after) {
+                auto [kingCol, kingRow] = after.kingSquare(after.colorToMove());
+                return !after.attacked(kingCol, kingRow) && seen.count(positionKey(after)) == 0;
+            });
+            if (unseen) {
+                candidates.push_back(move);
+            }
+        });
+        REQUIRE_FALSE(candidates.empty());
+        Move next = candidates[std::uniform_int_distribution<size_t>(0, candidates.size() - 1)(rng)];
+        board.makeMove(next);
+        seen.insert(positionKey(board));
+        sequence.push_back(next);
+    }
+
+    return sequence;
+}
+
+std::vector<Move> knightShuffle(size_t plies) {
+    std::array<Move, 4> cycle = {Move{"b1", "a3"}, Move{"g8", "h6"}, Move{"a3", "b1"}, Move{"h6", "g8"}};
+    std::vector<Move> sequence;
+    sequence.reserve(plies);
+    for (size_t i = 0; i < plies; ++i) {
+        sequence.push_back(cycle[i % cycle.size()]);
+    }
+    return sequence;
+}
+
+TEST_CASE("Search benchmarks", "[search]" BENCHMARK_TAGS) {
+    // cleared every run so all runs search the same tree, without allocating the table every time
+    TranspositionTable table(Search::defaultTableSize);
+    auto benchmarkSearch = [&](const std::string& name, const Board& board, uint32_t depth) {
+        table.clear();
+        SearchResult reference = Search(SearchLimit::depth(depth), table).run(board);
+        WARN(name << ": depth " << reference.depth << ", " << reference.nodes << " nodes, "
+                  << reference.nodesPerSecond() << " nodes/s, hashfull " << table.hashfull());
+
+        BENCHMARK("Search depth " + std::to_string(depth) + " from " + name) {
+            table.clear();
+            return Search(SearchLimit::depth(depth), table).run(board).nodes;
+        };
+    };
+
+    benchmarkSearch("start position", Board::standardBoard(), 4);
+    benchmarkSearch("Kiwipete position",
+                    Board::fromFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1").extract(), 3);
+    benchmarkSearch("middle game position",
+                    Board::fromFEN("1b1qr1k1/rp1n2p1/2p1p1bp/p2p1p2/P1PP1P2/1Q2P2P/1P1N2P1/2RRBBK1 w - - 0 19").extract(), 4);
+}
+
+TEST_CASE("Parallel search scaling", "[search][smp]" BENCHMARK_TAGS) {
+    Board board = Board::fromFEN("1b1qr1k1/rp1n2p1/2p1p1bp/p2p1p2/P1PP1P2/1Q2P2P/1P1N2P1/2RRBBK1 w - - 0 19").extract();
+    size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    uint64_t singleNPS = 0;
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        SearchResult timed = ParallelSearch(SearchLimit::moveTime(500), threads).run(board);
+        if (threads == 1) {
+            singleNPS = std::max<uint64_t>(timed.nodesPerSecond(), 1);
+        }
+        WARN(threads << " threads: " << timed.nodesPerSecond() << " nodes/s ("
+                     << std::fixed << std::setprecision(2)
+                     << static_cast<double>(timed.nodesPerSecond()) / static_cast<double>(singleNPS)
+                     << "x), depth " << timed.depth);
+
+        BENCHMARK("Parallel search to depth 5 with " + std::to_string(threads) + " threads") {
+            return ParallelSearch(SearchLimit::depth(5), threads).run(board).nodes;
+        };
+    }
+}
+
+TEST_CASE("Transposition table benchmarks", "[search][tt]" BENCHMARK_TAGS) {
+    std::mt19937_64 random(42);
+    std::vector<uint64_t> keys(4096);
+    for (uint64_t& key : keys) {
+        key = random();
+    }
+
+    for (size_t megabytes : {1, 64}) {
+        TranspositionTable table(megabytes);
+        for (uint64_t key : keys) {
+            table.store(key, Move{}, 0, 1, Bound::Exact);
+        }
+
+        BENCHMARK("Probing 4096 random keys in " + std::to_string(megabytes) + " MB") {
+            uint32_t found = 0;
+            for (uint64_t key : keys) {
+                found += table.probe(key).has_value();
+            }
+            return found;
+        };
+
+        BENCHMARK("Probing 4096 random keys in " + std::to_string(megabytes) + " MB, prefetched 8 ahead") {
+            uint32_t found = 0;
+            for (size_t i = 0; i < keys.size(); ++i) {
+                if (i + 8 < keys.size()) {
+                    table.prefetch(keys[i + 8]);
+                }
+                found += table.probe(keys[i]).has_value();
+            }
+            return found;
+        };
+
+        BENCHMARK("Storing 4096 random keys in " + std::to_string(megabytes) + " MB") {
+            for (uint64_t key : keys) {
+                table.store(key, Move{}, 1, 2, Bound::Lower);
+            }
+            return table.hashfull();
+        };
+    }
+}
+
+TEST_CASE("Evaluation benchmarks", "[search][eval]" BENCHMARK_TAGS) {
+    Board board = Board::fromFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1").extract();
+    MoveList moves = generateAllMoves(board);
+
+    BENCHMARK("Evaluate Kiwipete") {
+        return evaluate(board);
+    };
+
+    BENCHMARK("makeMove + evaluate + undoMove for all " + std::to_string(moves.size()) + " Kiwipete moves") {
+        Score total = 0;
+        moves.forEachMove([&](Move move) {
+            board.makeMove(move);
+            total += evaluate(board);
+            board.undoMove();
+        });
+        return total;
+    };
+
+    BENCHMARK("Kiwipete pawn structure and shields") {
+        return pawnScore(board);
+    };
+
+    PawnHashTable pawns;
+    BENCHMARK("Kiwipete pawn structure and shields from the pawn hash table") {
+        return pawns.probe(board);
+    };
+}
+
+TEST_CASE("Network evaluation benchmarks", "[search][eval][nnue]" BENCHMARK_TAGS) {
+    auto network = NNUE::Network::random(42);
+    Board board = Board::fromFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1").extract();
+    board.setNetwork(network.get());
+    MoveList moves = generateAllMoves(board);
+    WARN("Network kernels: " << NNUE::Kernels::instructionSet());
+
+    BENCHMARK("Evaluate Kiwipete with the network") {
+        return evaluate(board);
+    };
+
+    BENCHMARK("Evaluate Kiwipete with the network from scratch") {
+        return network->evaluateReference(board);
+    };
+
+    BENCHMARK("makeMove + evaluate + undoMove with the network for all " + std::to_string(moves.size())
+              + " Kiwipete moves") {
+        Score total = 0;
+        moves.forEachMove([&](Move move) {
+            board.makeMove(move);
+            total += evaluate(board);
+            board.undoMove();
+        });
+        return total;
+    };
+}
+
+TEST_CASE("Static exchange benchmarks", "[search][see]" BENCHMARK_TAGS) {
+    Board board = Board::fromFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1").extract();
+    MoveList moves = generateAllMoves(board);
+
+    BENCHMARK("Full static exchange of all " + std::to_string(moves.size()) + " Kiwipete moves") {
+        int32_t total = 0;
+        moves.forEachMove([&](Move move) {
+            total += board.see(move);
+        });
+        return total;
+    };
+
+    BENCHMARK("Static exchange threshold of all " + std::to_string(moves.size()) + " Kiwipete moves") {
+        uint32_t winning = 0;
+        moves.forEachMove([&](Move move) {
+            winning += board.seeGE(move, 0);
+        });
+        return winning;
+    };
+}
+
+TEST_CASE("History benchmarks", "[moving][history]" BENCHMARK_TAGS) {
+#ifdef LONG_BENCHMARKS
+    constexpr std::array<size_t, 6> historyLengths = {0, 16, 64, 256, 512, 1024};
+#else
+    constexpr std::array<size_t, 5> historyLengths = {0, 16, 64, 256, 512};
+#endif
+    constexpr size_t maxHistory = historyLengths.back();
+
+    auto benchmarkHistory = [&](const std::string& scenario, const Board& start, const std::vector<Move>& sequence) {
+        REQUIRE(sequence.size() > maxHistory);
+
+        Board board = start;
+        size_t played = 0;
+        for (size_t length : historyLengths) {
+            while (played < length) {
+                board.makeMove(sequence[played]);
+                ++played;
+            }
+            Move next = sequence[played];
+            REQUIRE(generateAllMoves(board).contains(next));
+
+            BENCHMARK("makeMove + undoMove after " + std::to_string(length) + " plies of " + scenario) {
+                board.makeMove(next);
+                board.undoMove();
+                return board.positionRepeated();
+            };
+
+            BENCHMARK("Copy board after " + std::to_string(length) + " plies of " + scenario) {
+                return Board(board);
+            };
+        }
+
+        BENCHMARK("Replay " + std::to_string(maxHistory) + " plies of " + scenario) {
+            Board replay = start;
+            for (size_t i = 0; i < maxHistory; ++i) {
+                replay.makeMove(sequence[i]);
+            }
+            return replay.positionRepeated();
+        };
+    };
+
+    {
+        Board start = Board::standardBoard();
+        benchmarkHistory("knight shuffles", start, knightShuffle(maxHistory + 1));
+    }
+
+    {
+        Board start = Board::fromFEN("r3k2r/8/8/8/8/8/8/R3K2R w - - 0 1").extract();
+        benchmarkHistory("non repeating rook and king moves", start, reversibleSequence(start, maxHistory + 1));
+    }
+
+    {
+        Board start = Board::fromFEN("1n2k1n1/8/8/8/8/8/8/1N2K1N1 w - - 0 1").extract();
+        benchmarkHistory("non repeating knight and king moves", start, reversibleSequence(start, maxHistory + 1));
+    }
+}
+
 TEST_CASE("Game benchmarks", "[moving][game]" BENCHMARK_TAGS) {
 
     std::vector<std::tuple<Board, MoveList, Move>> whiteMoves;
@@ -494,4 +969,215 @@ TEST_CASE("Game benchmarks", "[moving][game]" BENCHMARK_TAGS) {
 
     auto negating = Chess::indexOp();
     PLAY_MOVES(negating);
+
+    auto alphabeticalPlayer = Chess::alphabetically();
+    BENCHMARK("Full game without PGN") {
+        return playGame(alphabeticalPlayer, constIndex).moves.size();
+    };
+
+    BENCHMARK("Full game with PGN") {
+        return playGame(alphabeticalPlayer, constIndex).pgn().size();
+    };
+}
+
+template<typename Func>
+void measureCounters(util::PerfCounters& counters, const char* name, const char* unitName, Func&& func) {
+    counters.start();
+    uint64_t units = func();
+    auto values = counters.stop();
+
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2) << name << " (" << units << ' ' << unitName << ")";
+    for (int i = 0; i < util::PerfCounters::CounterCount; ++i) {
+        auto counter = static_cast<util::PerfCounters::Counter>(i);
+        if (values.has(counter)) {
+            out << "\n    " << util::PerfCounters::name(counter) << " per " << unitName << ": " << values.perUnit(counter, units);
+        }
+    }
+    if (values.has(util::PerfCounters::Cycles) && values.has(util::PerfCounters::Instructions)) {
+        out << "\n    IPC: " << values.instructionsPerCycle();
+    }
+    WARN(out.str());
+}
+
+TEST_CASE("Hardware counter benchmarks", "[perf]" BENCHMARK_TAGS) {
+    util::PerfCounters counters;
+    if (!counters.available()) {
+        WARN("Hardware performance counters are not available (no perf_event_open support or permission), skipping");
+        return;
+    }
+
+    constexpr int repetitions = 1000;
+
+    std::vector<Board> boards;
+    for (auto fen : {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+                     "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                     "R6R/3Q4/1Q4Q1/4Q3/2Q4Q/Q4Q2/pp1Q4/kBNN1KB1 w - - 0 1",
+                     "4Q2Q/4r3/6n1/1bbK1krn/RR1RRnRR/2qn1R1n/4n1nN/Q3Q3 w - - 1 2",
+                     "1n1r1b1r/P1P1P1P1/2BNq1k1/7R/3Q4/1P1N2K1/P1PBP3/5R2 w - - 15 45"}) {
+        auto eb = Board::fromFEN(fen);
+        REQUIRE(eb);
+        boards.push_back(eb.extract());
+    }
+
+    measureCounters(counters, "generateAllMoves", "move", [&] {
+        uint64_t generated = 0;
+        for (int i = 0; i < repetitions; ++i) {
+            for (const Board& board : boards) {
+                generated += generateAllMoves(board).size();
+            }
+        }
+        return generated;
+    });
+
+    std::vector<MoveList> moveLists;
+    for (const Board& board : boards) {
+        moveLists.push_back(generateAllMoves(board));
+    }
+
+    measureCounters(counters, "Board::makeMove + undoMove", "move", [&] {
+        uint64_t made = 0;
+        for (int i = 0; i < repetitions; ++i) {
+            for (size_t b = 0; b < boards.size(); ++b) {
+                moveLists[b].forEachMove([&](const Move& move) {
+                    boards[b].makeMove(move);
+                    boards[b].undoMove();
+                    ++made;
+                });
+            }
+        }
+        return made;
+    });
+
+    // use the actual occupancy of the boards to get realistic ray lengths
+    std::vector<BitBoard> occupancies;
+    for (const Board& board : boards) {
+        BitBoard occupied = 0;
+        for (BoardIndex col = 0; col < Board::size; ++col) {
+            for (BoardIndex row = 0; row < Board::size; ++row) {
+                if (board.pieceAt(col, row).has_value()) {
+                    occupied |= BB::squareBoard(col + row * Board::size);
+                }
+            }
+        }
+        occupancies.push_back(occupied);
+    }
+
+    measureCounters(counters, "BB::generateSliders", "call", [&] {
+        uint64_t calls = 0;
+        BitBoard sink = 0;
+        for (int i = 0; i < repetitions; ++i) {
+            for (BitBoard occupied : occupancies) {
+                for (BoardIndex square = 0; square < Board::size * Board::size; ++square) {
+                    sink ^= BB::generateSliders<Piece::Type::Bishop>(square, occupied);
+                    sink ^= BB::generateSliders<Piece::Type::Rook>(square, occupied);
+                    calls += 2;
+                }
+            }
+        }
+        REQUIRE(sink != 1);
+        return calls;
+    });
+
+    {
+        Board board = Board::standardBoard();
+        measureCounters(counters, "Perft(4) from start position", "node", [&] {
+            return countMoves(board, 4);
+        });
+    }
+
+    {
+        Board board = Board::fromFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1").extract();
+        measureCounters(counters, "Perft(3) from Kiwipete position", "node", [&] {
+            return countMoves(board, 3);
+        });
+    }
+}
+
+template<typename Func>
+void measureAllocations(const char* name, uint64_t operations, Func&& func) {
+    util::Allocations::Counter counter;
+    func();
+    auto stats = counter.stats();
+
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2) << name
+        << ": " << static_cast<double>(stats.allocations) / operations << " allocations and "
+        << static_cast<double>(stats.bytes) / operations << " bytes per operation";
+    WARN(out.str());
+}
+
+TEST_CASE("Allocation benchmarks", "[allocations]" BENCHMARK_TAGS) {
+    if (!util::Allocations::countingEnabled()) {
+        WARN("Allocation counting is not enabled (build with WITH_ALLOCATION_COUNTING), skipping");
+        return;
+    }
+
+    constexpr uint64_t repetitions = 100;
+    constexpr auto fen = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+    Board board = Board::fromFEN(fen).extract();
+
+    measureAllocations("Board::fromFEN", repetitions, [&] {
+        for (uint64_t i = 0; i < repetitions; ++i) {
+            [[maybe_unused]] auto eb = Board::fromFEN(fen);
+        }
+    });
+
+    measureAllocations("Board::fromFEN with error", repetitions, [&] {
+        for (uint64_t i = 0; i < repetitions; ++i) {
+            [[maybe_unused]] auto eb = Board::fromFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 0");
+        }
+    });
+
+    Board reused = Board::emptyBoard();
+    measureAllocations("Board::parseFEN into existing board", repetitions, [&] {
+        for (uint64_t i = 0; i < repetitions; ++i) {
+            [[maybe_unused]] auto result = reused.parseFEN(fen);
+        }
+    });
+
+    measureAllocations("Board::toFEN", repetitions, [&] {
+        for (uint64_t i = 0; i < repetitions; ++i) {
+            [[maybe_unused]] auto str = board.toFEN();
+        }
+    });
+
+    std::array<char, Board::maxFENLength> buffer{};
+    measureAllocations("Board::toFEN into buffer", repetitions, [&] {
+        for (uint64_t i = 0; i < repetitions; ++i) {
+            [[maybe_unused]] auto length = board.toFEN(buffer.data());
+        }
+    });
+
+    measureAllocations("generateAllMoves", repetitions, [&] {
+        for (uint64_t i = 0; i < repetitions; ++i) {
+            [[maybe_unused]] auto list = generateAllMoves(board);
+        }
+    });
+
+    MoveList list = generateAllMoves(board);
+
+    measureAllocations("Board::makeMove + undoMove", list.size() * repetitions, [&] {
+        for (uint64_t i = 0; i < repetitions; ++i) {
+            list.forEachMove([&](const Move& move) {
+                board.makeMove(move);
+                board.undoMove();
+            });
+        }
+    });
+
+    measureAllocations("Board::moveToSAN", list.size(), [&] {
+        list.forEachMove([&](const Move& move) {
+            [[maybe_unused]] auto san = board.moveToSAN(move, list);
+        });
+    });
+
+    {
+        auto white = Chess::indexPlayer(1);
+        auto black = Chess::indexPlayer(-1);
+        auto result = playGame(white, black);
+        measureAllocations("playGame (per game)", 1, [&] {
+            result = playGame(white, black);
+        });
+    }
 }
@@ -3,8 +3,13 @@
 #include <catch2/generators/catch_generators_range.hpp>
 #include <catch2/generators/catch_generators_random.hpp>
 #include <catch2/generators/catch_generators_adapters.hpp>
+#include <array>
 #include <chess/Board.h>
+#include <chess/MoveGen.h>
+#include <chess/PackedBoard.h>
 #include <set>
+#include <string_view>
+#include <vector>
 #include <algorithm>
 
 using namespace Chess;
@@ -53,6 +58,8 @@ TEST_CASE("Board", "[chess][base]") {
         } else {
             CHECK(b.countPieces(piece.color()) == 1);
             CHECK(b.countPieces(opposite(piece.color())) == 0);
+            CHECK(b.countPieces(piece) == 1);
+            CHECK(b.countPieces(Piece{piece.type(), opposite(piece.color())}) == 0);
         }
 
         // since we only add once piece it can never be a valid position!
@@ -752,6 +759,161 @@ TEST_CASE("Basic FEN output", "[chess][parsing][fen]") {
     }
 }
 
+TEST_CASE("FEN parsing into an existing board", "[chess][parsing][fen]") {
+    Board board = Board::standardBoard();
+
+    SECTION("Errors give the kind and offset") {
+        auto checkError = [&board](std::string_view fen, FENError error, uint32_t offset) {
+            CAPTURE(fen);
+            auto result = board.parseFEN(fen);
+            REQUIRE_FALSE(result);
+            CHECK(result.error == error);
+            CHECK(result.offset == offset);
+            CHECK_FALSE(result.message().empty());
+        };
+
+        checkError("", FENError::BoardTooShort, 0);
+        checkError("8/8/8/8/8/8/8/8", FENError::WrongFieldCount, 15);
+        checkError("8/8/8/8/8/8/8/8 w - - 0 1 ", FENError::WrongFieldCount, 25);
+        checkError("8/8/8/8/8/8/8/8 w - - 0 1 extra", FENError::WrongFieldCount, 25);
+        checkError("8/8/8/8/8/8/8/8/ w - - 0 1", FENError::TrailingRowSeparator, 15);
+        checkError("8/8/8/8/8/8/8/8p w - - 0 1", FENError::BoardTooLong, 15);
+        checkError("8/8/8/8/8/8/8p/8 w - - 0 1", FENError::MissingRowSeparator, 13);
+        checkError("8/8/8/8/8/8/8/7x w - - 0 1", FENError::UnknownPiece, 15);
+        checkError("8/8/8/8/8/8/8/7# w - - 0 1", FENError::InvalidBoardCharacter, 15);
+        checkError("8/8/8/8/8/8/8/44 w - - 0 1", FENError::ConsecutiveNumbers, 15);
+        checkError("08/8/8/8/8/8/8/8 w - - 0 1", FENError::ZeroSkip, 0);
+        checkError("p8/8/8/8/8/8/8/8 w - - 0 1", FENError::SkipTooLarge, 1);
+        checkError("8/8/8/8/8/8/8/8 x - - 0 1", FENError::InvalidTurn, 16);
+        checkError("8/8/8/8/8/8/8/8 w Kx - 0 1", FENError::InvalidCastling, 19);
+        checkError("8/8/8/8/8/8/8/8 w KQ - 0 1", FENError::CastlingPiecesMissing, 18);
+        checkError("8/8/8/8/8/8/8/8 w - a9 0 1", FENError::InvalidEnPassant, 20);
+        checkError("8/8/8/8/8/8/8/8 w - a3 0 1", FENError::EnPassantWrongRow, 20);
+        checkError("8/8/8/8/8/8/8/8 w - a6 0 1", FENError::EnPassantPawnMissing, 20);
+        checkError("8/8/p7/p7/8/8/8/8 w - a6 0 1", FENError::EnPassantSquareOccupied, 22);
+        checkError("8/8/8/8/8/8/8/8 w - - 01 1", FENError::InvalidHalfMoves, 22);
+        checkError("8/8/8/8/8/8/8/8 w - - 0 0", FENError::InvalidFullMoves, 24);
+        checkError("8/8/8/8/8/8/8/8 w - - 0 2222222221", FENError::TooManyFullMoves, 24);
+        checkError(std::string(Board::maxFENLength + 1, '8'), FENError::TooLong, Board::maxFENLength);
+    }
+
+    SECTION("Replaces all state of a played board") {
+        REQUIRE(board.makeMove(Move{"e2", "e4", Move::Flag::DoublePushPawn}));
+        constexpr auto fen = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b KQkq e3 0 3";
+
+        REQUIRE(board.parseFEN(fen));
+        CHECK(board == Board::fromFEN(fen).extract());
+        CHECK(board.toFEN() == fen);
+        CHECK_FALSE(board.undoMove());
+    }
+
+    SECTION("Writing into a buffer matches toFEN") {
+        std::string fen = GENERATE(as<std::string>{},
+                                   "8/8/8/8/8/8/8/8 w - - 0 1",
+                                   "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+                                   "1b1qr1k1/rp1n2p1/2p1p1bp/p2p1p2/P1PP1P2/1Q2P2P/1P1N2P1/2RRBBK1 w - - 0 19",
+                                   "rnbqkbnr/pppp1ppp/8/8/3Pp3/8/PPP1PPPP/RNBQKBNR b Kq d3 4294967295 2147483640");
+        REQUIRE(board.parseFEN(fen));
+
+        std::array<char, Board::maxFENLength> buffer{};
+        auto length = board.toFEN(buffer.data());
+        REQUIRE(length <= Board::maxFENLength);
+        CHECK(std::string_view(buffer.data(), length) == fen);
+        CHECK(board.toFEN() == fen);
+    }
+
+    SECTION("Parsing and writing do not allocate") {
+        constexpr auto fen = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+        std::array<char, Board::maxFENLength> buffer{};
+        FENParseResult result;
+        FENParseResult error;
+        size_t length = 0;
+        CHECK_NO_ALLOCATIONS({
+            result = board.parseFEN(fen);
+            error = board.parseFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 0");
+            length = board.toFEN(buffer.data());
+        });
+        CHECK(result);
+        CHECK_FALSE(error);
+        CHECK(length > 0);
+    }
+}
+
+TEST_CASE("Packed boards", "[chess][parsing][packed]") {
+    Board board = Board::emptyBoard();
+
+    SECTION("Round trips through toFEN") {
+        std::string fen = GENERATE(as<std::string>{},
+                                   "8/8/8/8/8/8/8/8 w - - 0 1",
+                                   "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+                                   "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b KQkq e3 0 3",
+                                   "rnbqkbnr/pppp1ppp/8/8/3Pp3/8/PPP1PPPP/RNBQKBNR b Kq d3 65535 2147483640",
+                                   "rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR w kq d6 12 40",
+                                   "1k6/1r6/2K1B3/8/8/R7/8/8 w - - 105 150");
+        REQUIRE(board.parseFEN(fen));
+
+        auto packed = board.pack();
+        REQUIRE(packed.has_value());
+        Board unpacked = Board::standardBoard();
+        REQUIRE(unpacked.makeMove(Move{"e2", "e4", Move::Flag::DoublePushPawn}));
+        REQUIRE(unpacked.unpack(*packed));
+        CHECK(unpacked.toFEN() == fen);
+        CHECK(unpacked == board);
+        CHECK_FALSE(unpacked.undoMove());
+    }
+
+    SECTION("Every position of a random game round trips") {
+        board = Board::standardBoard();
+        Board unpacked = Board::emptyBoard();
+        std::mt19937 random(37);
+        for (int ply = 0; ply < 200; ++ply) {
+            auto packed = board.pack();
+            REQUIRE(packed.has_value());
+            REQUIRE(unpacked.unpack(*packed));
+            REQUIRE(unpacked.toFEN() == board.toFEN());
+
+            MoveList moves = generateAllMoves(board);
+            if (moves.size() == 0) {
+                break;
+            }
+            board.makeMove(moves[random() % moves.size()]);
+        }
+    }
+
+    SECTION("Positions which do not fit are not packed") {
+        REQUIRE(board.parseFEN("qqqqqqqq/qqqqqqqq/8/8/8/8/QQQQQQQQ/QQQQQQQQ w - - 0 1"));
+        CHECK(board.pack().has_value());
+        REQUIRE(board.parseFEN("qqqqqqqq/qqqqqqqq/8/8/8/8/QQQQQQQQ/QQQQQQQQ w - - 65536 1"));
+        CHECK_FALSE(board.pack().has_value());
+        REQUIRE(board.parseFEN("qqqqqqqq/qqqqqqqq/8/8/8/q7/QQQQQQQQ/QQQQQQQQ w - - 0 1"));
+        CHECK_FALSE(board.pack().has_value());
+    }
+
+    SECTION("Invalid data is rejected") {
+        REQUIRE(board.parseFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b KQkq e3 0 3"));
+        auto packed = board.pack();
+        REQUIRE(packed.has_value());
+        Board unpacked = Board::emptyBoard();
+
+        auto rejects = [&](size_t index, uint8_t value) {
+            PackedBoard corrupt = *packed;
+            corrupt.bytes[index] = value;
+            return !unpacked.unpack(corrupt);
+        };
+        // a1 holds a rook, nibble 7 and 0 are not pieces
+        CHECK(rejects(8, static_cast<uint8_t>((packed->bytes[8] & 0xf0) | 0x7)));
+        CHECK(rejects(8, static_cast<uint8_t>(packed->bytes[8] & 0xf0)));
+        // unused flag bits, or castling without the king in place
+        CHECK(rejects(24, 0xff));
+        CHECK(rejects(24, static_cast<uint8_t>(packed->bytes[24] & ~1)));
+        // en passant square off the board or on the wrong row
+        CHECK(rejects(25, 64));
+        CHECK(rejects(25, 44));
+        CHECK(rejects(28, 0));
+        CHECK(unpacked.unpack(*packed));
+    }
+}
+
 TEST_CASE("Basic chess checks", "[chess][rules]") {
     using namespace Chess;
     STATIC_REQUIRE(Board::size == 8);
@@ -851,3 +1013,162 @@ TEST_CASE("Board equality", "[chess][base]") {
     }
 
 }
+
+TEST_CASE("Zobrist hashing", "[chess][base][hash]") {
+    auto parsedHash = [](const Board& board) {
+        return Board::fromFEN(board.toFEN()).extract().hash();
+    };
+
+    SECTION("Standard board hashes like its FEN") {
+        CHECK(Board::standardBoard().hash() == parsedHash(Board::standardBoard()));
+        CHECK(Board::standardBoard().hash() != Board::emptyBoard().hash());
+    }
+
+    SECTION("Moves keep the hash equal to one computed from scratch") {
+        auto fen = GENERATE(as<std::string_view>{},
+                            "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                            "rnbqkbnr/pppp1ppp/8/8/4p3/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+                            "8/2P3k1/8/8/8/8/3p2K1/8 w - - 0 1");
+        CAPTURE(fen);
+        Board board = Board::fromFEN(fen).extract();
+        // always taking the last move reaches promotions and castling in a few plies
+        for (size_t moveIndex : {0u, 1u, 2u}) {
+            std::vector<uint64_t> hashes;
+            for (int ply = 0; ply < 12; ++ply) {
+                MoveList moves = generateAllMoves(board);
+                if (moves.size() == 0) {
+                    break;
+                }
+                hashes.push_back(board.hash());
+                Move move = moves[moveIndex == 0 ? moves.size() - 1 : (moveIndex * 7 + ply) % moves.size()];
+                CAPTURE(board.toFEN(), move.toSANSquares());
+                board.makeMove(move);
+                REQUIRE(board.hash() == parsedHash(board));
+            }
+            while (!hashes.empty()) {
+                REQUIRE(board.undoMove());
+                CHECK(board.hash() == hashes.back());
+                hashes.pop_back();
+            }
+        }
+    }
+
+    SECTION("Transpositions have the same hash") {
+        Board first = Board::standardBoard();
+        Board second = Board::standardBoard();
+        for (auto [from, to] : {std::pair{"g1", "f3"}, {"g8", "f6"}, {"b1", "c3"}}) {
+            first.makeMove(Move{from, to});
+        }
+        for (auto [from, to] : {std::pair{"b1", "c3"}, {"g8", "f6"}, {"g1", "f3"}}) {
+            second.makeMove(Move{from, to});
+        }
+        CHECK(first.hash() == second.hash());
+
+        first.makeNullMove();
+        CHECK(first.hash() != second.hash());
+        first.undoNullMove();
+        CHECK(first.hash() == second.hash());
+    }
+
+    SECTION("Clocks are not part of the hash but castling and en passant are") {
+        auto hashOf = [](std::string_view fen) {
+            auto board = Board::fromFEN(fen);
+            REQUIRE(board);
+            return board.extract().hash();
+        };
+        uint64_t base = hashOf("rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR w KQkq - 0 2");
+        CHECK(base == hashOf("rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR w KQkq - 10 30"));
+        CHECK(base != hashOf("rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR w KQk - 0 2"));
+        CHECK(base != hashOf("rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR w KQkq e6 0 2"));
+        CHECK(base != hashOf("rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 2"));
+    }
+
+    SECTION("Parsing into and unpacking into a used board") {
+        Board board = Board::standardBoard();
+        board.makeMove(Move{"e2", "e4"});
+        Board expected = Board::fromFEN("4k3/8/8/8/8/8/8/R3K2R w KQ - 0 1").extract();
+        REQUIRE(board.parseFEN("4k3/8/8/8/8/8/8/R3K2R w KQ - 0 1"));
+        CHECK(board.hash() == expected.hash());
+
+        Board other = Board::standardBoard();
+        auto packed = expected.pack();
+        REQUIRE(packed.has_value());
+        REQUIRE(other.unpack(*packed));
+        CHECK(other.hash() == expected.hash());
+    }
+}
+
+TEST_CASE("Static exchange evaluation", "[chess][rules][see]") {
+    struct Exchange {
+        std::string_view fen;
+        Move move;
+        int32_t expected;
+    };
+    auto exchange = GENERATE(values<Exchange>({
+            // undefended pawn
+            {"1k1r4/1pp4p/p7/4p3/8/P5P1/1PP4P/2K1R3 w - - 0 1", Move{"e1", "e5"}, 100},
+            // a pawn defended by a pawn costs the queen
+            {"4k3/8/3p4/4p3/8/8/8/4QK2 w - - 0 1", Move{"e1", "e5"}, 100 - 900},
+            // the rook behind the first one keeps the exchange going (x-ray)
+            {"4k3/4r3/8/4p3/8/8/4R3/4R1K1 w - - 0 1", Move{"e2", "e5"}, 100},
+            {"4k3/4r3/8/4p3/8/8/4R3/6K1 w - - 0 1", Move{"e2", "e5"}, 100 - 500},
+            // the knight takes, then it is better to stop than to give up the rook
+            {"1k1r3q/1ppn3p/p4b2/4p3/8/P2N2P1/1PP1R1BP/2K1Q3 w - - 0 1", Move{"d3", "e5"}, 100 - 320},
+            // the king only recaptures when nothing defends the square anymore
+            {"3r1k2/8/8/8/8/8/3q4/3RK3 w - - 0 1", Move{"d1", "d2"}, 900},
+            {"3r1k2/8/8/8/1b6/8/3q4/3RK3 w - - 0 1", Move{"d1", "d2"}, 900 - 500},
+            // moving to an attacked square without capturing
+            {"4k3/8/8/3p4/8/8/8/2B1K3 w - - 0 1", Move{"c1", "e3"}, 0},
+            {"4k3/8/8/3p4/8/8/8/4KB2 w - - 0 1", Move{"f1", "c4"}, -330},
+            // en passant and a promotion by capture
+            {"4k3/8/8/3Pp3/8/8/8/4K3 w - e6 0 1", Move{"d5", "e6", Move::Flag::EnPassant}, 100},
+            {"1r2k3/P7/8/8/8/8/8/4K3 w - - 0 1", Move{"a7", "b8", Move::Flag::PromotionToQueen}, 500 + 800},
+            {"1r2k3/P7/8/8/8/8/8/4K3 w - - 0 1", Move{"a7", "a8", Move::Flag::PromotionToQueen}, 800 - 900},
+    }));
+    CAPTURE(exchange.fen, exchange.move.toSANSquares());
+
+    auto parsed = Board::fromFEN(exchange.fen);
+    REQUIRE(parsed);
+    Board board = parsed.extract();
+    REQUIRE(generateAllMoves(board).contains(exchange.move));
+
+    CHECK(board.see(exchange.move) == exchange.expected);
+    CHECK(board.seeGE(exchange.move, exchange.expected));
+    CHECK_FALSE(board.seeGE(exchange.move, exchange.expected + 1));
+    CHECK(board.seeGE(exchange.move, exchange.expected - 50));
+}
+
+TEST_CASE("Static exchange threshold agrees with the full evaluation", "[chess][rules][see]") {
+    auto fen = GENERATE(as<std::string_view>{},
+                        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+                        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+                        "1b1qr1k1/rp1n2p1/2p1p1bp/p2p1p2/P1PP1P2/1Q2P2P/1P1N2P1/2RRBBK1 w - - 0 19");
+    CAPTURE(fen);
+    Board board = Board::fromFEN(fen).extract();
+    generateAllMoves(board).forEachMove([&](Move move) {
+        CAPTURE(move.toSANSquares());
+        int32_t value = board.see(move);
+        CHECK(board.seeGE(move, value));
+        CHECK_FALSE(board.seeGE(move, value + 1));
+    });
+}
+
+TEST_CASE("Board queries do not allocate", "[chess][base][allocations]") {
+    Board board = Board::fromFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1").extract();
+
+    CHECK_NO_ALLOCATIONS({
+        for (BoardIndex col = 0; col < Board::size; ++col) {
+            for (BoardIndex row = 0; row < Board::size; ++row) {
+                [[maybe_unused]] auto piece = board.pieceAt(col, row);
+                [[maybe_unused]] bool attacked = board.attacked(col, row);
+            }
+        }
+    });
+
+    CHECK_NO_ALLOCATIONS({
+        [[maybe_unused]] auto white = board.countPieces(Color::White);
+        [[maybe_unused]] auto drawn = board.isDrawn();
+        [[maybe_unused]] auto king = board.kingSquare(Color::Black);
+    });
+}
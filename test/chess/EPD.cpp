@@ -0,0 +1,128 @@
+#include <catch2/catch_test_macros.hpp>
+#include <chess/EPD.h>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace Chess;
+
+TEST_CASE("EPD parsing", "[chess][epd]") {
+    EPDRecord record;
+
+    SECTION("Position and operations") {
+        std::string_view line = "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - "
+                                "bm Bb5 Bc4; id \"test; one\"; c0 \"a comment\"; D1 27; foo;\r";
+        auto result = parseEPD(line, record);
+        INFO(result.message());
+        REQUIRE(result);
+        CHECK(record.board.toFEN() == "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 0 1");
+
+        REQUIRE(record.operations.size() == 5);
+        CHECK(record.operations[0].code == EPDOpcode::BestMove);
+        CHECK(record.operations[0].operands == "Bb5 Bc4");
+        CHECK(record.operations[1].code == EPDOpcode::Id);
+        CHECK(record.operations[1].unquoted() == "test; one");
+        CHECK(record.operations[2].code == EPDOpcode::Comment);
+        CHECK(record.operations[2].opcodeNumber() == std::optional<uint32_t>(0));
+        CHECK(record.operations[3].code == EPDOpcode::PerftCount);
+        CHECK(record.operations[3].opcodeNumber() == std::optional<uint32_t>(1));
+        CHECK(record.operations[4].code == EPDOpcode::Unknown);
+        CHECK(record.operations[4].operands.empty());
+
+        auto bestMoves = record.moves("bm");
+        REQUIRE(bestMoves.has_value());
+        CHECK(*bestMoves == std::vector<Move>{Move{"f1", "b5"}, Move{"f1", "c4"}});
+        CHECK_FALSE(record.moves("am").has_value());
+        CHECK(record.find("id") == &record.operations[1]);
+        CHECK(record.find("c1") == nullptr);
+    }
+
+    SECTION("Clock operations fill the last FEN fields") {
+        REQUIRE(parseEPD("8/8/8/4k3/8/8/8/4K3 b - - hmvc 12; fmvn 40;", record));
+        CHECK(record.board.toFEN() == "8/8/8/4k3/8/8/8/4K3 b - - 12 40");
+    }
+
+    SECTION("Invalid lines") {
+        auto result = parseEPD("8/8/8/4k3/8/8/8/4K3 w -", record);
+        CHECK(result.error == EPDError::MissingFields);
+
+        result = parseEPD("8/8/8/4k3/8/8/8/4K3 w - - id \"open;", record);
+        CHECK(result.error == EPDError::UnterminatedString);
+        CHECK(result.offset == 26);
+
+        result = parseEPD("8/8/8/4k3/8/8/8/4K3 w - - D1 5", record);
+        CHECK(result.error == EPDError::MissingSemicolon);
+
+        result = parseEPD("8/8/8/4k3/8/8/8/4K3 w - - 1abc;", record);
+        CHECK(result.error == EPDError::InvalidOpcode);
+        CHECK(result.offset == 26);
+
+        result = parseEPD("8/8/8/4k3/8/8/8/4K3 w  Kq - id \"x\";", record);
+        CHECK(result.error == EPDError::InvalidPosition);
+        CHECK(result.fenResult.error == FENError::CastlingPiecesMissing);
+        CHECK(result.offset == 23);
+
+        result = parseEPD("8/8/8/4k3/8/8/8/4K3 w - - hmvc x;", record);
+        CHECK(result.error == EPDError::InvalidPosition);
+        CHECK(result.fenResult.error == FENError::InvalidHalfMoves);
+        CHECK(result.offset == 31);
+    }
+}
+
+TEST_CASE("EPD writing", "[chess][epd]") {
+    EPDRecord record;
+    REQUIRE(parseEPD("4k3/8/8/8/8/8/8/4K2R  w K -   id \"rook\" ;D1 7;", record));
+
+    std::ostringstream out;
+    writeEPD(out, record);
+    CHECK(out.str() == "4k3/8/8/8/8/8/8/4K2R w K - id \"rook\"; D1 7;");
+
+    std::ostringstream annotated;
+    writeEPD(annotated, record, {{"D1", "15"}, {"ce", "500"}});
+    CHECK(annotated.str() == "4k3/8/8/8/8/8/8/4K2R w K - id \"rook\"; D1 15; ce 500;");
+}
+
+TEST_CASE("EPD batch operations", "[chess][epd]") {
+    std::string input;
+    for (int i = 0; i < 20; ++i) {
+        input += "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - id \"" + std::to_string(i) + "\"; D1 20; D2 400; D3 8902;\n";
+        input += "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - D1 48; D2 2000;\n";
+        input += "\n";
+    }
+    input += "not an epd line\n";
+
+    SECTION("Perft check reports mismatches in order") {
+        for (size_t threads : {1, 3}) {
+            std::ostringstream out;
+            EPDBatchStats stats = processEPD(input, threads, checkPerft(3), out);
+            CHECK(stats.records == 41);
+            CHECK(stats.invalid == 1);
+            CHECK(stats.failed == 20);
+
+            std::istringstream lines(out.str());
+            std::string line;
+            size_t index = 0;
+            while (std::getline(lines, line)) {
+                if (index == 40) {
+                    CHECK(line == "not an epd line");
+                } else if (index % 2 == 0) {
+                    CHECK(line.find("id \"" + std::to_string(index / 2) + "\"") != std::string::npos);
+                    CHECK(line.find("c9") == std::string::npos);
+                } else {
+                    CHECK(line.ends_with("c9 \"D2 is 2039 not 2000\";"));
+                }
+                ++index;
+            }
+            CHECK(index == 41);
+        }
+    }
+
+    SECTION("Counting legal moves") {
+        std::ostringstream out;
+        EPDBatchStats stats = processEPD("8/8/8/4k3/8/8/8/4K3 w - - D1 0;\n", 2, countLegalMoves(), out);
+        CHECK(stats.records == 1);
+        CHECK(stats.failed == 0);
+        CHECK(out.str() == "8/8/8/4k3/8/8/8/4K3 w - - D1 5;\n");
+    }
+}
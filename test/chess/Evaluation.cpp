@@ -0,0 +1,212 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <cctype>
+#include <initializer_list>
+#include <chess/Evaluation.h>
+#include <chess/MoveGen.h>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace Chess;
+
+namespace {
+    // The same position with the colors swapped: ranks reversed, piece colors, side to move,
+    // castling rights and en passant square flipped
+    std::string mirrorFEN(std::string_view fen) {
+        std::istringstream in{std::string(fen)};
+        std::string pieces, toMove, castling, enPassant, rest;
+        in >> pieces >> toMove >> castling >> enPassant;
+        std::getline(in, rest);
+
+        auto swapCase = [](std::string text) {
+            for (char& c : text) {
+                c = static_cast<char>(std::isupper(c) ? std::tolower(c) : std::toupper(c));
+            }
+            return text;
+        };
+
+        std::vector<std::string> ranks;
+        std::istringstream rankStream(pieces);
+        for (std::string rank; std::getline(rankStream, rank, '/');) {
+            ranks.push_back(swapCase(rank));
+        }
+        std::string mirrored;
+        for (auto it = ranks.rbegin(); it != ranks.rend(); ++it) {
+            mirrored += (mirrored.empty() ? "" : "/") + *it;
+        }
+
+        std::string swappedCastling = swapCase(castling);
+        std::string mirroredCastling;
+        for (char right : std::string_view("KQkq")) {
+            if (swappedCastling.find(right) != std::string::npos) {
+                mirroredCastling += right;
+            }
+        }
+        if (mirroredCastling.empty()) {
+            mirroredCastling = "-";
+        }
+
+        if (enPassant != "-") {
+            enPassant[1] = enPassant[1] == '3' ? '6' : '3';
+        }
+        return mirrored + ' ' + (toMove == "w" ? "b" : "w") + ' ' + mirroredCastling + ' ' + enPassant + rest;
+    }
+
+    BitBoard squares(std::initializer_list<std::string_view> sans) {
+        BitBoard bb = 0;
+        for (std::string_view san : sans) {
+            auto [col, row] = Board::SANToColRow(san).value();
+            bb |= BitBoard(1) << (col + Board::size * row);
+        }
+        return bb;
+    }
+
+    Score whiteScore(const Board& board) {
+        return board.colorToMove() == Color::White ? evaluate(board) : -evaluate(board);
+    }
+}
+
+TEST_CASE("Evaluation", "[chess][eval]") {
+    SECTION("Start position is balanced") {
+        Board board = Board::standardBoard();
+        CHECK(board.gamePhase() == PST::maxPhase);
+        CHECK(evaluate(board) == 0);
+    }
+
+    SECTION("Phase and tapering") {
+        Board kings = Board::fromFEN("4k3/8/8/8/8/8/8/4K3 w - - 0 1").extract();
+        CHECK(kings.gamePhase() == 0);
+
+        PST::TaperedScore score{100, -40};
+        CHECK(taperedScore(score, PST::maxPhase) == 100);
+        CHECK(taperedScore(score, 0) == -40);
+        CHECK(taperedScore(score, PST::maxPhase / 2) == 30);
+        // promoted pieces do not go past the middle game
+        CHECK(taperedScore(score, PST::maxPhase + 8) == 100);
+    }
+
+    SECTION("More material is better") {
+        Board board = Board::fromFEN("4k3/8/8/8/8/8/8/3QK3 w - - 0 1").extract();
+        CHECK(evaluate(board) > 800);
+        Board blackToMove = Board::fromFEN("4k3/8/8/8/8/8/8/3QK3 b - - 0 1").extract();
+        CHECK(evaluate(blackToMove) == -evaluate(board));
+    }
+
+    SECTION("A mirrored position has the negated score") {
+        auto fen = GENERATE(as<std::string_view>{},
+                            "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                            "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+                            "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+                            "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+                            "1b1qr1k1/rp1n2p1/2p1p1bp/p2p1p2/P1PP1P2/1Q2P2P/1P1N2P1/2RRBBK1 w - - 0 19",
+                            "4k3/8/8/3Pp3/8/8/8/4K3 w - e6 0 1");
+        std::string mirrored = mirrorFEN(fen);
+        CAPTURE(fen, mirrored);
+        Board board = Board::fromFEN(fen).extract();
+        Board mirror = Board::fromFEN(mirrored).extract();
+
+        CHECK(whiteScore(mirror) == -whiteScore(board));
+        // so from the side to move it is the same
+        CHECK(evaluate(mirror) == evaluate(board));
+        CHECK(mirror.gamePhase() == board.gamePhase());
+    }
+
+    SECTION("Incremental updates match a freshly set up board") {
+        std::mt19937 random(GENERATE(1u, 2u, 3u));
+        Board board = Board::fromFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1").extract();
+        const Score initial = evaluate(board);
+        // small enough that positions keep replacing each other
+        PawnHashTable pawns(4);
+
+        uint32_t played = 0;
+        for (; played < 200; ++played) {
+            MoveList moves = generateAllMoves(board);
+            if (moves.size() == 0) {
+                break;
+            }
+            board.makeMove(moves[std::uniform_int_distribution<size_t>(0, moves.size() - 1)(random)]);
+
+            Board fresh = Board::fromFEN(board.toFEN()).extract();
+            CAPTURE(board.toFEN());
+            REQUIRE(board.pieceSquareScore() == fresh.pieceSquareScore());
+            REQUIRE(board.gamePhase() == fresh.gamePhase());
+            REQUIRE(board.pawnHash() == fresh.pawnHash());
+            REQUIRE(evaluate(board) == evaluate(fresh));
+            REQUIRE(evaluate(board, pawns) == evaluate(board));
+        }
+
+        for (; played > 0; --played) {
+            board.undoMove();
+        }
+        CHECK(evaluate(board) == initial);
+    }
+}
+
+TEST_CASE("Pawn structure", "[chess][eval]") {
+    SECTION("Isolated pawns") {
+        CHECK(pawnStructureScore(squares({"a2", "c2"}), squares({"a7", "b7", "c7"})) == PawnTerms::isolated * 2);
+    }
+
+    SECTION("Doubled pawns") {
+        CHECK(pawnStructureScore(squares({"a2", "a3", "b2"}), squares({"a7", "b7"})) == PawnTerms::doubled);
+        // all pawns behind another one count
+        CHECK(pawnStructureScore(squares({"a2", "b2"}), squares({"a7", "b7", "b6", "b5"})) == -PawnTerms::doubled * 2);
+    }
+
+    SECTION("Passed pawns by how far they advanced") {
+        CHECK(pawnStructureScore(squares({"d5"}), squares({"a7"})) == PawnTerms::passed[4] - PawnTerms::passed[1]);
+        CHECK(pawnStructureScore(squares({"a7"}), squares({"d5"})) == PawnTerms::passed[6] - PawnTerms::passed[3]);
+        // a pawn on a neighbouring file ahead of it stops both
+        CHECK(pawnStructureScore(squares({"d5"}), squares({"e6"})) == PST::TaperedScore{});
+    }
+
+    SECTION("Backward pawns") {
+        // d3 cannot be defended by c4 and e5 controls d4, c4 is passed since d3 holds e5 back
+        CHECK(pawnStructureScore(squares({"c4", "d3"}), squares({"e5"}))
+              == PawnTerms::backward + PawnTerms::passed[3] - PawnTerms::isolated);
+    }
+
+    SECTION("Pawn shields") {
+        BitBoard pawns = squares({"f2", "g2", "h3", "a2"});
+        CHECK(pawnShieldScore(Color::White, 6, pawns) == PawnTerms::shieldNear * 2 + PawnTerms::shieldFar);
+        CHECK(pawnShieldScore(Color::White, 7, pawns) == PawnTerms::shieldNear * 2 + PawnTerms::shieldFar);
+        CHECK(pawnShieldScore(Color::White, 4, pawns) == PawnTerms::shieldNear);
+        // a king which left its first two rows has no shield
+        CHECK(pawnShieldScore(Color::White, 30, pawns) == PST::TaperedScore{});
+        CHECK(pawnShieldScore(Color::Black, 62, squares({"f7", "g6", "h7"}))
+              == PawnTerms::shieldNear * 2 + PawnTerms::shieldFar);
+    }
+
+    SECTION("The pawn hash only changes when pawns do") {
+        Board board = Board::fromFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1").extract();
+        uint64_t pawnHash = board.pawnHash();
+        PawnHashTable pawns;
+        PST::TaperedScore score = pawns.probe(board);
+        CHECK(score == pawnScore(board));
+
+        auto play = [&board](std::string_view san) {
+            auto move = board.parseSANMove(san);
+            REQUIRE(move.has_value());
+            board.makeMove(*move);
+        };
+        play("Nb5");
+        CHECK(board.pawnHash() == pawnHash);
+        play("Nc4");
+        CHECK(board.pawnHash() == pawnHash);
+        play("O-O");
+        CHECK(board.pawnHash() == pawnHash);
+        // only the shield of the castled king changed
+        CHECK(pawns.probe(board) == pawnScore(board));
+        CHECK(pawns.probe(board) != score);
+
+        play("exd5");
+        CHECK(board.pawnHash() != pawnHash);
+        CHECK(pawns.probe(board) == pawnScore(board));
+
+        board.undoMove();
+        CHECK(board.pawnHash() == pawnHash);
+    }
+}
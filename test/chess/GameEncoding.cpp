@@ -0,0 +1,149 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <chess/GameEncoding.h>
+#include <chess/PGN.h>
+#include <chess/players/Game.h>
+#include <chess/players/TrivialPlayers.h>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace Chess;
+
+namespace {
+    std::string playedGamesPGN(int games) {
+        std::string pgn;
+        for (int i = 0; i < games; ++i) {
+            auto white = indexPlayer(i);
+            auto black = alphabetically(i % 2 == 0);
+            GameResult result = playGame(white, black);
+            pgn += "[Round \"" + std::to_string(i) + "\"]\n\n" + result.pgn()
+                 + std::string(pgnResultMarker(result.final())) + "\n\n";
+        }
+        return pgn;
+    }
+}
+
+TEST_CASE("Binary game encoding", "[chess][encoding]") {
+
+    SECTION("Round trips a game in about a byte per ply") {
+        std::string_view pgn = "[Event \"Encoded\"]\n[FEN \"r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1\"]\n\n"
+                               "1. O-O O-O-O 2. Ra8+ Kb7 3. Ra3 Rd2 0-1";
+        PGNReader reader(pgn);
+        REQUIRE(reader.next());
+        const PGNGame& original = reader.game();
+        REQUIRE(original.error == PGNError::None);
+
+        std::string encoded;
+        REQUIRE(encodeGame(encoded, original));
+
+        // tag count, length prefixed tag names and values, result, ply count and a byte per ply
+        size_t tagBytes = 1 + (1 + 5 + 1 + 7) + (1 + 3 + 1 + original.tags[1].value.size());
+        CHECK(encoded.size() == tagBytes + 1 + 1 + original.moves.size());
+
+        PGNGame decoded;
+        size_t position = 0;
+        REQUIRE(decodeGame(encoded, position, decoded) == GameDecodeError::None);
+        CHECK(position == encoded.size());
+        CHECK(decoded.tag("Event") == std::optional<std::string_view>("Encoded"));
+        CHECK(decoded.moves == original.moves);
+        CHECK(decoded.result == GameResult::Final::BlackWin);
+        CHECK(decoded.board.toFEN() == original.board.toFEN());
+    }
+
+    SECTION("Rejects moves which are not legal") {
+        PGNGame game;
+        game.moves.push_back(Move{"e2", "e5"});
+        std::string encoded = "prefix";
+        CHECK_FALSE(encodeGame(encoded, game));
+        CHECK(encoded == "prefix");
+    }
+
+    SECTION("Reports corrupt data") {
+        PGNReader reader("1. e4 e5 2. Nf3 *");
+        REQUIRE(reader.next());
+        std::string encoded;
+        REQUIRE(encodeGame(encoded, reader.game()));
+
+        PGNGame decoded;
+        for (size_t length = 0; length < encoded.size(); ++length) {
+            size_t position = 0;
+            CHECK(decodeGame(std::string_view(encoded).substr(0, length), position, decoded) == GameDecodeError::Truncated);
+        }
+
+        std::string badIndex = encoded;
+        badIndex.back() = static_cast<char>(200);
+        size_t position = 0;
+        CHECK(decodeGame(badIndex, position, decoded) == GameDecodeError::InvalidMoveIndex);
+
+        std::string badResult = encoded;
+        badResult[1] = 9;
+        position = 0;
+        CHECK(decodeGame(badResult, position, decoded) == GameDecodeError::InvalidResult);
+    }
+}
+
+TEST_CASE("Game archives", "[chess][encoding]") {
+
+    std::string pgn = playedGamesPGN(6);
+    auto [archiveData, skipped] = pgnToArchive(pgn);
+    CHECK(skipped == 0);
+
+    auto archive = GameArchive::open(archiveData);
+    REQUIRE(archive.has_value());
+    REQUIRE(archive->size() == 6);
+
+    std::vector<std::vector<Move>> expectedMoves;
+    size_t pgnPlies = 0;
+    PGNReader(pgn).forEachGame([&](const PGNGame& game) {
+        expectedMoves.push_back(game.moves);
+        pgnPlies += game.moves.size();
+    });
+    // index and header on top of roughly one byte per ply
+    CHECK(archiveData.size() < pgnPlies + 6 * (8 + 16) + 25);
+    CHECK(archiveData.size() * 4 < pgn.size());
+
+    SECTION("Random access to every game") {
+        PGNGame game;
+        for (size_t i = archive->size(); i-- > 0;) {
+            CAPTURE(i);
+            REQUIRE(archive->read(i, game) == GameDecodeError::None);
+            CHECK(game.tag("Round") == std::optional<std::string_view>(std::to_string(i)));
+            CHECK(game.moves == expectedMoves[i]);
+        }
+    }
+
+    SECTION("Converts back to the same PGN games") {
+        std::ostringstream out;
+        REQUIRE(archiveToPGN(*archive, out));
+        std::string roundTrip = out.str();
+
+        size_t index = 0;
+        PGNReader(roundTrip).forEachGame([&](const PGNGame& game) {
+            CHECK(game.error == PGNError::None);
+            REQUIRE(index < expectedMoves.size());
+            CHECK(game.moves == expectedMoves[index]);
+            ++index;
+        });
+        CHECK(index == expectedMoves.size());
+    }
+
+    SECTION("Invalid archives are not opened") {
+        CHECK_FALSE(GameArchive::open("").has_value());
+        CHECK_FALSE(GameArchive::open(std::string_view(archiveData).substr(0, archiveData.size() - 1)).has_value());
+        CHECK_FALSE(GameArchive::open(std::string_view(archiveData).substr(1)).has_value());
+
+        std::string wrongCount = archiveData;
+        wrongCount[wrongCount.size() - 20] += 1;
+        CHECK_FALSE(GameArchive::open(wrongCount).has_value());
+    }
+
+    SECTION("An empty archive has no games") {
+        GameArchiveWriter writer;
+        std::string empty = writer.finish();
+        auto emptyArchive = GameArchive::open(empty);
+        REQUIRE(emptyArchive.has_value());
+        CHECK(emptyArchive->size() == 0);
+    }
+}
@@ -0,0 +1,65 @@
+#include <catch2/catch_test_macros.hpp>
+#include <chess/Board.h>
+#include <chess/HotPathCounters.h>
+#include <chess/MoveGen.h>
+#include <thread>
+
+using namespace Chess;
+
+TEST_CASE("Hot path counters", "[chess][counters]") {
+    Counters::resetThisThread();
+
+    if (!Counters::enabled()) {
+        generateAllMoves(Board::standardBoard());
+        Counters::Values values = Counters::thisThread();
+        for (auto value : values) {
+            REQUIRE(value == 0);
+        }
+        return;
+    }
+
+    SECTION("Counts move generation") {
+        MoveList list = generateAllMoves(Board::standardBoard());
+        Counters::Values values = Counters::thisThread();
+        REQUIRE(values[Counters::GenerateAllMovesCalls] == 1);
+        REQUIRE(values[Counters::PseudoLegalMoves] >= list.size());
+        REQUIRE(values[Counters::IllegalMoves] == values[Counters::PseudoLegalMoves] - list.size());
+    }
+
+    SECTION("Most moves are rejected in check") {
+        auto board = Board::fromFEN("4Q2Q/4r3/6n1/1bbK1krn/RR1RRnRR/2qn1R1n/4n1nN/Q3Q3 w - - 1 2").extract();
+        MoveList list = generateAllMoves(board);
+        Counters::Values values = Counters::thisThread();
+        REQUIRE(values[Counters::IllegalMoves] > list.size());
+    }
+
+    SECTION("Counts make and undo move") {
+        Board board = Board::standardBoard();
+        board.makeMove({"b1", "a3"});
+        board.undoMove();
+        Counters::Values values = Counters::thisThread();
+        REQUIRE(values[Counters::MakeMoveCalls] == 1);
+        REQUIRE(values[Counters::UndoMoveCalls] == 1);
+    }
+
+    SECTION("Counts repetition scans") {
+        Board board = Board::standardBoard();
+        for (auto [from, to] : {std::pair{"b1", "a3"}, {"g8", "h6"}, {"a3", "b1"}, {"h6", "g8"}}) {
+            board.makeMove({from, to});
+        }
+        REQUIRE(board.positionRepeated() == 1);
+        Counters::Values values = Counters::thisThread();
+        REQUIRE(values[Counters::RepetitionScans] == 1);
+        REQUIRE(values[Counters::RepetitionScanDepth] == 4);
+    }
+
+    SECTION("Counters are per thread") {
+        Counters::Values before = Counters::allThreads();
+        std::thread([] {
+            generateAllMoves(Board::standardBoard());
+        }).join();
+        REQUIRE(Counters::thisThread()[Counters::GenerateAllMovesCalls] == 0);
+        Counters::Values after = Counters::allThreads();
+        REQUIRE(after[Counters::GenerateAllMovesCalls] == before[Counters::GenerateAllMovesCalls] + 1);
+    }
+}
@@ -4,7 +4,10 @@
 #include <catch2/generators/catch_generators_random.hpp>
 #include <catch2/generators/catch_generators_adapters.hpp>
 #include <chess/MoveGen.h>
+#include <algorithm>
 #include <set>
+#include <string>
+#include <string_view>
 
 using namespace Chess;
 
@@ -1249,6 +1252,79 @@ TEST_CASE("Stale/check mate", "[chess][rules][movegen]") {
     }
 }
 
+TEST_CASE("Capture and check generation", "[chess][rules][movegen]") {
+    auto toSet = [](const MoveList& list) {
+        std::set<std::string> moves;
+        list.forEachMove([&](Move move) {
+            moves.insert(move.toSANSquares());
+        });
+        return moves;
+    };
+    auto givesCheck = [](Board& board, Move move) {
+        return board.moveExcursion(move, [](const Board& after) {
+            auto [col, row] = after.kingSquare(after.colorToMove());
+            return after.attacked(col, row);
+        });
+    };
+
+    SECTION("Only the captures and promotions of all moves") {
+        auto fen = GENERATE(as<std::string_view>{},
+                            "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                            "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+                            "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+                            "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+                            "4k3/8/8/3Pp3/8/8/8/4K3 w - e6 0 1",
+                            "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+        CAPTURE(fen);
+        Board board = Board::fromFEN(fen).extract();
+        auto [kingCol, kingRow] = board.kingSquare(board.colorToMove());
+        // every evasion is generated in check
+        bool inCheck = board.attacked(kingCol, kingRow);
+
+        std::set<std::string> expected;
+        generateAllMoves(board).forEachMove([&](Move move) {
+            if (inCheck || move.isPromotion() || move.flag == Move::Flag::EnPassant
+                || (move.flag != Move::Flag::Castling && board.pieceAt(move.colRowToPosition()).has_value())) {
+                expected.insert(move.toSANSquares());
+            }
+        });
+        CHECK(toSet(generateMoves(board, GenerationMode::Captures)) == expected);
+
+        MoveList withChecks = generateMoves(board, GenerationMode::CapturesAndChecks);
+        std::set<std::string> withChecksSet = toSet(withChecks);
+        CHECK(std::includes(withChecksSet.begin(), withChecksSet.end(), expected.begin(), expected.end()));
+        withChecks.forEachMove([&](Move move) {
+            if (!expected.contains(move.toSANSquares())) {
+                CAPTURE(move.toSANSquares());
+                CHECK(givesCheck(board, move));
+            }
+        });
+    }
+
+    SECTION("Quiet checks") {
+        Board board = Board::fromFEN("4k3/8/8/8/8/8/8/R3K2R w KQ - 0 1").extract();
+        CHECK(generateMoves(board, GenerationMode::Captures).size() == 0);
+        CHECK(toSet(generateMoves(board, GenerationMode::CapturesAndChecks)) == std::set<std::string>{"a1a8", "h1h8"});
+
+        // a pawn push, a knight and a bishop give check but a king never does
+        board = Board::fromFEN("8/4k3/8/3P4/7N/8/1B6/4K3 w - - 0 1").extract();
+        MoveList checks = generateMoves(board, GenerationMode::CapturesAndChecks);
+        CHECK(checks.size() == 5);
+        for (Move move : {Move{"d5", "d6"}, Move{"b2", "a3"}, Move{"b2", "f6"}, Move{"h4", "g6"}, Move{"h4", "f5"}}) {
+            CAPTURE(move.toSANSquares());
+            CHECK(checks.contains(move));
+        }
+    }
+
+    SECTION("Every evasion in check") {
+        Board board = Board::fromFEN("4k3/8/8/8/8/8/3q4/R3K2R w KQ - 0 1").extract();
+        CHECK(generateMoves(board, GenerationMode::Captures).size() == generateAllMoves(board).size());
+
+        Board mate = Board::fromFEN("6k1/8/8/8/8/8/5PPP/r5K1 w - - 0 1").extract();
+        CHECK(generateMoves(mate, GenerationMode::Captures).isCheckMate());
+    }
+}
+
 TEST_CASE("Specific examples", "[chess][movegen]") {
     SECTION("Move count") {
 
@@ -0,0 +1,102 @@
+#include "TestUtil.h"
+#include <catch2/catch_test_macros.hpp>
+#include <chess/MoveGen.h>
+#include <chess/MoveOrdering.h>
+#include <set>
+#include <vector>
+
+using namespace Chess;
+
+namespace {
+    std::vector<Move> pickAll(MovePicker picker) {
+        std::vector<Move> picked;
+        while (auto move = picker.next()) {
+            picked.push_back(*move);
+        }
+        return picked;
+    }
+}
+
+TEST_CASE("Move ordering", "[chess][search][ordering]") {
+    // the pawn can promote by taking the queen, the rook can take the queen and the pawn the knight,
+    // all without losing material
+    Board board = TestUtil::fromFEN("2q1k3/1P6/8/4n3/3P4/8/8/2R1K2Q w - - 0 1");
+    MoveList moves = generateAllMoves(board);
+    OrderingTables tables;
+
+    SECTION("Every move exactly once") {
+        std::vector<Move> picked = pickAll(MovePicker(board, moves, Move{}, tables, 0, Move{}));
+        REQUIRE(picked.size() == moves.size());
+        std::set<std::pair<int, int>> unique;
+        for (Move move : picked) {
+            CHECK(moves.contains(move));
+            unique.emplace(int(move.fromPosition), int(move.toPosition) * 8 + static_cast<int>(move.flag));
+        }
+        CHECK(unique.size() == moves.size());
+    }
+
+    SECTION("First move, then captures by most valuable victim and least valuable attacker") {
+        Move first{"e1", "f2"};
+        std::vector<Move> picked = pickAll(MovePicker(board, moves, first, tables, 0, Move{}));
+        REQUIRE(picked.size() > 10);
+        CHECK(picked[0] == first);
+        CHECK(picked[1] == Move{"b7", "c8", Move::Flag::PromotionToQueen});
+        CHECK(picked[2] == Move{"c1", "c8"});
+        CHECK(picked[3] == Move{"d4", "e5"});
+        CHECK(isQuietMove(board, picked[4]));
+
+        // promoting next to the queen loses the new queen so goes after the quiet moves
+        CHECK(picked[picked.size() - 7] == Move{"b7", "b8", Move::Flag::PromotionToQueen});
+        // and under promotions go last
+        for (size_t i = picked.size() - 6; i < picked.size(); ++i) {
+            REQUIRE(picked[i].isPromotion());
+            CHECK(picked[i].promotedType() != Piece::Type::Queen);
+        }
+    }
+
+    SECTION("Killers, counter move and history order the quiet moves") {
+        Move killer{"h1", "h4"};
+        Move older{"e1", "e2"};
+        Move counter{"h1", "g2"};
+        Move good{"c1", "d1"};
+        Move previous{"e7", "e8"};
+        std::vector<Move> tried = {Move{"c1", "b1"}};
+
+        tables.updateOnCutoff(Color::White, 3, 4, older, Move{}, nullptr, 0);
+        tables.updateOnCutoff(Color::White, 3, 4, killer, Move{}, nullptr, 0);
+        tables.updateOnCutoff(Color::White, 5, 4, counter, previous, nullptr, 0);
+        tables.updateOnCutoff(Color::White, 6, 6, good, Move{}, tried.data(), tried.size());
+        CHECK(tables.killers(3)[0] == killer);
+        CHECK(tables.killers(3)[1] == older);
+        CHECK(tables.counterMove(previous) == counter);
+        CHECK(tables.history(Color::White, good) > tables.history(Color::White, killer));
+        CHECK(tables.history(Color::White, tried[0]) < 0);
+        CHECK(tables.history(Color::Black, good) == 0);
+
+        std::vector<Move> quiets;
+        for (Move move : pickAll(MovePicker(board, moves, Move{}, tables, 3, previous))) {
+            if (isQuietMove(board, move)) {
+                quiets.push_back(move);
+            }
+        }
+        REQUIRE(quiets.size() > 5);
+        CHECK(quiets[0] == killer);
+        CHECK(quiets[1] == older);
+        CHECK(quiets[2] == counter);
+        CHECK(quiets[3] == good);
+        CHECK(quiets.back() == tried[0]);
+
+        tables.newSearch();
+        CHECK(tables.killers(3)[0] == Move{});
+        CHECK(tables.history(Color::White, good) > 0);
+    }
+
+    SECTION("History stays within its bounds") {
+        Move move{"h1", "h4"};
+        for (int i = 0; i < 1000; ++i) {
+            tables.updateOnCutoff(Color::White, 0, 40, move, Move{}, nullptr, 0);
+        }
+        CHECK(tables.history(Color::White, move) <= OrderingTables::maxHistory);
+        CHECK(tables.history(Color::White, move) > OrderingTables::maxHistory / 2);
+    }
+}
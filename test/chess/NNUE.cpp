@@ -0,0 +1,192 @@
+#include "TestUtil.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <chess/Evaluation.h>
+#include <chess/MoveGen.h>
+#include <chess/NNUE.h>
+#include <chess/NNUEKernels.h>
+#include <chess/Search.h>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string_view>
+#include <vector>
+
+using namespace Chess;
+
+namespace {
+    const NNUE::Network& testNetwork() {
+        static std::unique_ptr<NNUE::Network> network = NNUE::Network::random(42);
+        return *network;
+    }
+}
+
+TEST_CASE("Network kernels match the scalar versions", "[chess][eval][nnue]") {
+    CAPTURE(NNUE::Kernels::instructionSet());
+    std::mt19937 random(GENERATE(1u, 2u, 3u));
+    auto size = GENERATE(as<size_t>{}, 32, 256, 512);
+    auto fill = [&random](auto& values, int32_t min, int32_t max) {
+        std::uniform_int_distribution<int32_t> distribution(min, max);
+        for (auto& value : values) {
+            value = static_cast<std::remove_reference_t<decltype(value)>>(distribution(random));
+        }
+    };
+
+    std::vector<int16_t> values(size);
+    std::vector<int16_t> weights(size);
+    fill(values, -32768, 32767);
+    fill(weights, -32768, 32767);
+
+    SECTION("Adding and subtracting wrap like int16") {
+        std::vector<int16_t> vectorized = values;
+        std::vector<int16_t> scalar = values;
+        NNUE::Kernels::add(vectorized.data(), weights.data(), size);
+        NNUE::Kernels::detail::addScalar(scalar.data(), weights.data(), size);
+        CHECK(vectorized == scalar);
+
+        NNUE::Kernels::subtract(vectorized.data(), weights.data(), size);
+        NNUE::Kernels::detail::subtractScalar(scalar.data(), weights.data(), size);
+        CHECK(vectorized == scalar);
+        CHECK(vectorized == values);
+    }
+
+    SECTION("Clipped ReLU") {
+        std::vector<uint8_t> vectorized(size);
+        std::vector<uint8_t> scalar(size);
+        NNUE::Kernels::clippedReLU(values.data(), vectorized.data(), size);
+        NNUE::Kernels::detail::clippedReLUScalar(values.data(), scalar.data(), size);
+        CHECK(vectorized == scalar);
+    }
+
+    SECTION("Dot product of activations and int8 weights") {
+        std::vector<uint8_t> in(size);
+        std::vector<int8_t> int8Weights(size);
+        fill(in, 0, 127);
+        fill(int8Weights, -128, 127);
+        CHECK(NNUE::Kernels::dot(in.data(), int8Weights.data(), size)
+              == NNUE::Kernels::detail::dotScalar(in.data(), int8Weights.data(), size));
+
+        // the largest products
+        std::fill(in.begin(), in.end(), 127);
+        std::fill(int8Weights.begin(), int8Weights.end(), -128);
+        CHECK(NNUE::Kernels::dot(in.data(), int8Weights.data(), size) == -127 * 128 * int32_t(size));
+    }
+}
+
+TEST_CASE("Network evaluation", "[chess][eval][nnue]") {
+    const NNUE::Network& network = testNetwork();
+
+    SECTION("Incremental updates match the reference evaluation") {
+        auto fen = GENERATE(as<std::string_view>{},
+                            "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                            "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+                            "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+                            "4k3/8/8/3Pp3/8/8/8/4K3 w - e6 0 1");
+        CAPTURE(fen);
+        Board board = TestUtil::fromFEN(fen);
+        board.setNetwork(&network);
+        const Score initial = evaluate(board);
+        CHECK(initial == network.evaluateReference(board));
+
+        std::mt19937 random(7);
+        uint32_t played = 0;
+        for (; played < 100; ++played) {
+            MoveList moves = generateAllMoves(board);
+            if (moves.size() == 0) {
+                break;
+            }
+            board.makeMove(moves[std::uniform_int_distribution<size_t>(0, moves.size() - 1)(random)]);
+            CAPTURE(board.toFEN());
+            REQUIRE(evaluate(board) == network.evaluateReference(board));
+        }
+
+        for (; played > 0; --played) {
+            board.undoMove();
+            REQUIRE(evaluate(board) == network.evaluateReference(board));
+        }
+        CHECK(evaluate(board) == initial);
+    }
+
+    SECTION("Scored for the side to move") {
+        Board board = TestUtil::fromFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+        board.setNetwork(&network);
+        Board blackToMove = TestUtil::fromFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b KQkq - 0 1");
+        blackToMove.setNetwork(&network);
+        // the sides swap places in the input, so the scores differ (but not by the side to move)
+        CHECK(evaluate(board) == network.evaluateReference(board));
+        CHECK(evaluate(blackToMove) == network.evaluateReference(blackToMove));
+        CHECK(std::abs(evaluate(board)) <= NNUE::maxScore);
+    }
+
+    SECTION("Copies keep the network and without one the tables evaluate") {
+        Board board = TestUtil::fromFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+        const Score tables = evaluate(board);
+        board.setNetwork(&network);
+        Board copy = board;
+        CHECK(copy.network() == &network);
+        CHECK(evaluate(copy) == network.evaluateReference(board));
+
+        copy.setNetwork(nullptr);
+        CHECK(copy.network() == nullptr);
+        CHECK(evaluate(copy) == tables);
+
+        // every copy has its own accumulator
+        Board moved = board;
+        moved.makeMove(generateAllMoves(moved)[0]);
+        CHECK(evaluate(moved) == network.evaluateReference(moved));
+        CHECK(evaluate(board) == network.evaluateReference(board));
+    }
+
+    SECTION("Parsing into a board keeps the network") {
+        Board board = Board::standardBoard();
+        board.setNetwork(&network);
+        REQUIRE(board.parseFEN("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"));
+        CHECK(evaluate(board) == network.evaluateReference(board));
+    }
+
+    SECTION("Search with a network") {
+        Board board = TestUtil::fromFEN("4k3/8/8/3q4/8/8/8/3RK3 w - - 0 1");
+        Search search(SearchLimit::depth(2));
+        search.setNetwork(&network);
+        SearchResult result = search.run(board);
+        CHECK(result.depth == 2);
+        CHECK(generateAllMoves(board).contains(result.bestMove));
+    }
+}
+
+TEST_CASE("Network files", "[chess][eval][nnue]") {
+    const NNUE::Network& network = testNetwork();
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "actions_test_network.nnue";
+
+    REQUIRE(network.save(path.string()));
+    NNUE::LoadResult loaded = NNUE::Network::load(path.string());
+    REQUIRE(loaded);
+    REQUIRE(loaded.network != nullptr);
+
+    Board board = TestUtil::fromFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    CHECK(loaded.network->evaluateReference(board) == network.evaluateReference(board));
+    board.setNetwork(loaded.network.get());
+    CHECK(evaluate(board) == network.evaluateReference(board));
+
+    SECTION("Truncated") {
+        std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+        NNUE::LoadResult truncated = NNUE::Network::load(path.string());
+        CHECK(truncated.error == NNUE::LoadError::WrongSize);
+        CHECK(truncated.network == nullptr);
+    }
+
+    SECTION("Not a network") {
+        std::ofstream(path, std::ios::binary) << "not a network";
+        CHECK(NNUE::Network::load(path.string()).error == NNUE::LoadError::NotANetwork);
+    }
+
+    SECTION("Another version") {
+        std::ofstream(path, std::ios::binary) << "NNUE" << std::string(12, '\x7f');
+        CHECK(NNUE::Network::load(path.string()).error == NNUE::LoadError::WrongVersion);
+    }
+
+    std::filesystem::remove(path);
+    NNUE::LoadResult missing = NNUE::Network::load(path.string());
+    CHECK_FALSE(missing);
+    CHECK(missing.error == NNUE::LoadError::CannotRead);
+}
@@ -0,0 +1,190 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <chess/Board.h>
+#include <chess/PGN.h>
+#include <chess/players/Game.h>
+#include <chess/players/TrivialPlayers.h>
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace Chess;
+
+TEST_CASE("PGN reading", "[chess][parsing][pgn]") {
+
+    SECTION("Reads tags, moves and result") {
+        std::string_view pgn = "[Event \"Casual \\\"game\\\"\"]\n"
+                               "[Site \"?\"]\n"
+                               "[Result \"1-0\"]\n"
+                               "\n"
+                               "1. e4 e5 2. Bc4 {Aiming at f7} Nc6 (2... Nf6 3. d3) 3. Qh5!? $1 Nf6?? 4. Qxf7# 1-0\n";
+        PGNReader reader(pgn);
+        REQUIRE(reader.next());
+        const PGNGame& game = reader.game();
+
+        CHECK(game.error == PGNError::None);
+        REQUIRE(game.tags.size() == 3);
+        CHECK(game.tags[0].name == "Event");
+        CHECK(game.tags[0].value == "Casual \\\"game\\\"");
+        CHECK(game.tag("Site") == std::optional<std::string_view>("?"));
+        CHECK_FALSE(game.tag("White").has_value());
+        CHECK(game.offset == 0);
+
+        REQUIRE(game.moves.size() == 7);
+        CHECK(game.moves[0] == Move{"e2", "e4", Move::Flag::DoublePushPawn});
+        CHECK(game.moves[6] == Move{"h5", "f7"});
+        CHECK(game.result == GameResult::Final::WhiteWin);
+        CHECK(game.board.toFEN() == "r1bqkb1r/pppp1Qpp/2n2n2/4p3/2B1P3/8/PPPP1PPP/RNB1K1NR b KQkq - 0 4");
+
+        CHECK_FALSE(reader.next());
+    }
+
+    SECTION("Multiple games with all kinds of results") {
+        std::string_view pgn = "[Event \"A\"]\n\n1. d4 d5 1/2-1/2\n\n"
+                               "[Event \"B\"]\n\n1.e4 e5 2.Nf3 *\n"
+                               "[Event \"C\"]\n1. f3 e5 2. g4 Qh4# 0-1\n"
+                               "1. Nf3 1-0";
+        std::vector<std::string> events;
+        std::vector<size_t> moveCounts;
+        std::vector<GameResult::Final> results;
+        size_t games = PGNReader(pgn).forEachGame([&](const PGNGame& game) {
+            CHECK(game.error == PGNError::None);
+            events.emplace_back(game.tag("Event").value_or("-"));
+            moveCounts.push_back(game.moves.size());
+            results.push_back(game.result);
+        });
+
+        CHECK(games == 4);
+        CHECK(events == std::vector<std::string>{"A", "B", "C", "-"});
+        CHECK(moveCounts == std::vector<size_t>{2, 3, 4, 1});
+        CHECK(results == std::vector<GameResult::Final>{GameResult::Final::Draw, GameResult::Final::InProgress,
+                                                        GameResult::Final::BlackWin, GameResult::Final::WhiteWin});
+    }
+
+    SECTION("Starts from the FEN tag") {
+        std::string_view pgn = "[SetUp \"1\"]\n[FEN \"4k3/8/8/8/8/8/8/R3K2R w K - 0 1\"]\n\n1. O-O+ Kd7 2. Ra7+ *";
+        PGNReader reader(pgn);
+        REQUIRE(reader.next());
+        CHECK(reader.game().error == PGNError::None);
+        CHECK(reader.game().startFEN() == "4k3/8/8/8/8/8/8/R3K2R w K - 0 1");
+        REQUIRE(reader.game().moves.size() == 3);
+        CHECK(reader.game().moves[0] == Move{"e1", "h1", Move::Flag::Castling});
+    }
+
+    SECTION("A game with errors does not stop reading") {
+        std::string_view pgn = "[Event \"Bad move\"]\n\n1. e4 e5 2. Ke3 Nc6 1-0\n\n"
+                               "[Event \"Bad tag]\n\n1. d4 *\n\n"
+                               "[Event \"Bad FEN\"]\n[FEN \"8/8/8\"]\n\n1. d4 *\n\n"
+                               "[Event \"Fine\"]\n\n1. c4 {unterminated";
+        PGNReader reader(pgn);
+
+        REQUIRE(reader.next());
+        CHECK(reader.game().error == PGNError::InvalidMove);
+        CHECK(reader.game().errorOffset == pgn.find("Ke3"));
+        CHECK(reader.game().moves.size() == 2);
+        CHECK(reader.game().result == GameResult::Final::WhiteWin);
+
+        REQUIRE(reader.next());
+        CHECK(reader.game().error == PGNError::InvalidTag);
+        CHECK(reader.game().moves.size() == 1);
+
+        REQUIRE(reader.next());
+        CHECK(reader.game().error == PGNError::InvalidFEN);
+
+        REQUIRE(reader.next());
+        CHECK(reader.game().tag("Event") == std::optional<std::string_view>("Fine"));
+        CHECK(reader.game().error == PGNError::UnterminatedComment);
+        CHECK(reader.game().moves.size() == 1);
+
+        CHECK_FALSE(reader.next());
+    }
+
+    SECTION("Reads back played games") {
+        auto white = alphabetically();
+        auto black = indexPlayer(3);
+        GameResult played = playGame(white, black);
+
+        std::string_view marker = "*";
+        switch (played.final()) {
+            case GameResult::Final::WhiteWin:
+                marker = "1-0";
+                break;
+            case GameResult::Final::BlackWin:
+                marker = "0-1";
+                break;
+            case GameResult::Final::Draw:
+                marker = "1/2-1/2";
+                break;
+            case GameResult::Final::InProgress:
+                break;
+        }
+
+        std::string pgn = "[White \"alphabetically\"]\n\n" + played.pgn() + std::string(marker) + "\n";
+        PGNReader reader(pgn);
+        REQUIRE(reader.next());
+        CHECK(reader.game().error == PGNError::None);
+        CHECK(reader.game().result == played.final());
+        CHECK(reader.game().moves == played.moves);
+    }
+}
+
+TEST_CASE("Parallel PGN reading", "[chess][parsing][pgn]") {
+
+    std::string pgn;
+    for (int i = 0; i < 50; ++i) {
+        pgn += "[Event \"" + std::to_string(i) + "\"]\n[Round \"1\"]\n\n1. e4 { [not a tag] } e5\n2. Nf3 Nc6 1-0\n\n";
+    }
+
+    SECTION("Splits only at the start of a game") {
+        size_t parts = GENERATE(1, 2, 3, 7, 100);
+        auto split = splitPGNGames(pgn, parts);
+        CHECK(split.size() <= parts);
+
+        size_t total = 0;
+        for (auto part : split) {
+            CHECK(part.starts_with("[Event"));
+            total += part.size();
+        }
+        CHECK(total == pgn.size());
+    }
+
+    SECTION("A game right after the first line break") {
+        std::string input = "\n" + pgn;
+        // more parts than characters, so the first search starts at the very beginning
+        auto split = splitPGNGames(input, input.size() + 1);
+        REQUIRE(split.size() > 1);
+        CHECK(split.front() == "\n");
+
+        size_t total = 0;
+        for (size_t i = 1; i < split.size(); ++i) {
+            CHECK(split[i].starts_with("[Event"));
+            total += split[i].size();
+        }
+        CHECK(total + 1 == input.size());
+    }
+
+    SECTION("Reads all games once") {
+        size_t threads = GENERATE(1, 3, 8);
+        std::atomic<size_t> moves = 0;
+        std::atomic<size_t> offsetSum = 0;
+        std::atomic<size_t> errors = 0;
+        // Catch assertions are not thread safe, so only count in the callback
+        size_t games = readPGNParallel(pgn, threads, [&](const PGNGame& game, size_t thread) {
+            errors += thread >= threads;
+            moves += game.moves.size();
+            offsetSum += game.offset;
+            errors += game.error != PGNError::None;
+        });
+
+        CHECK(games == 50);
+        CHECK(moves == 50 * 4);
+        CHECK(errors == 0);
+
+        size_t expectedOffsets = 0;
+        PGNReader(pgn).forEachGame([&](const PGNGame& game) {
+            expectedOffsets += game.offset;
+        });
+        CHECK(offsetSum == expectedOffsets);
+    }
+}
@@ -5,6 +5,11 @@
 #include <catch2/generators/catch_generators_random.hpp>
 #include <catch2/generators/catch_generators_adapters.hpp>
 #include <chess/Board.h>
+#include <chess/MoveGen.h>
+#include <chess/SANList.h>
+#include <optional>
+#include <random>
+#include <string_view>
 
 using namespace Chess;
 
@@ -109,8 +114,11 @@ TEST_CASE("SAN move parsing", "[chess][parsing][san][move]") {
         const std::string& expectedName = (nm);                    \
         auto parsedMove = board.parseSANMove(expectedName);                  \
         auto moveName = board.moveToSAN(expectedMove);             \
-        CAPTURE(expectedMove, expectedName, parsedMove, moveName); \
+        auto bulk = board.movesToSAN(generateAllMoves(board));     \
+        auto bulkName = bulk.find(expectedMove);                   \
+        CAPTURE(expectedMove, expectedName, parsedMove, moveName, bulkName); \
         REQUIRE((parsedMove.has_value() && parsedMove == expectedMove && moveName == expectedName));                           \
+        REQUIRE(bulkName == std::optional<std::string_view>(expectedName)); \
     } while (false)
 
 
@@ -776,3 +784,119 @@ TEST_CASE("Long Move format", "[chess][san][parsing]") {
     }
 
 }
+
+TEST_CASE("Bulk SAN rendering", "[chess][san]") {
+
+    SECTION("Matches single move SAN in every position of some games") {
+        std::string startFEN = GENERATE(as<std::string>{},
+                                        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+                                        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                                        "3Q4/1Q4Q1/4Q3/2Q4R/Q4Q2/3Q4/1Q4Rp/1K1BBNNk w - - 0 1",
+                                        "1n1r1b1r/P1P1P1P1/2BNq1k1/7R/3Q4/1P1N2K1/P1PBP3/5R2 w - - 15 45");
+        CAPTURE(startFEN);
+        Board board = Board::fromFEN(startFEN).extract();
+        std::mt19937 rng(5);
+
+        for (int ply = 0; ply < 40; ++ply) {
+            MoveList moves = generateAllMoves(board);
+            if (moves.size() == 0) {
+                break;
+            }
+            SANList sans = board.movesToSAN(moves);
+            REQUIRE(sans.size() == moves.size());
+
+            size_t index = 0;
+            moves.forEachMove([&](const Move& move) {
+                CAPTURE(board.toFEN(), move);
+                REQUIRE(sans.move(index) == move);
+                REQUIRE(sans[index] == board.moveToSAN(move, moves));
+                REQUIRE(board.parseSANMove(sans[index], moves) == move);
+                REQUIRE(board.parseSANMove(sans[index]) == move);
+                ++index;
+            });
+
+            board.makeMove(sans.move(rng() % sans.size()));
+        }
+    }
+
+    SECTION("Check and mate suffixes only when requested") {
+        Board board = Board::fromFEN("rnbqkbnr/pppp1ppp/8/4p3/6P1/5P2/PPPPP2P/RNBQKBNR b KQkq g3 0 2").extract();
+        MoveList moves = generateAllMoves(board);
+        Move mate{"d8", "h4"};
+
+        SANList withoutSuffix = board.movesToSAN(moves);
+        CHECK(withoutSuffix.find(mate) == std::optional<std::string_view>("Qh4"));
+        SANList withSuffix = board.movesToSAN(moves, true);
+        CHECK(withSuffix.find(mate) == std::optional<std::string_view>("Qh4#"));
+        CHECK(withSuffix.find(Move{"d7", "d6"}) == std::optional<std::string_view>("d6"));
+
+        Board checkBoard = Board::fromFEN("4k3/8/8/8/8/8/8/R3K3 w - - 0 1").extract();
+        SANList checks = checkBoard.movesToSAN(generateAllMoves(checkBoard), true);
+        CHECK(checks.find(Move{"a1", "a8"}) == std::optional<std::string_view>("Ra8+"));
+        CHECK(checks.find(Move{"a1", "a2"}) == std::optional<std::string_view>("Ra2"));
+    }
+
+    SECTION("Does not allocate") {
+        Board board = Board::fromFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1").extract();
+        MoveList moves = generateAllMoves(board);
+        size_t count = 0;
+        CHECK_NO_ALLOCATIONS({
+            count = board.movesToSAN(moves, true).size();
+        });
+        CHECK(count == moves.size());
+    }
+}
+
+TEST_CASE("SAN parsing rejects invalid input", "[chess][parsing][san][move]") {
+
+    SECTION("Malformed or impossible moves in the start position") {
+        Board board = Board::standardBoard();
+        std::string_view sans = GENERATE(as<std::string_view>{},
+                                         "", "e", "+", "x", "=Q", "e5", "e2e4", "exd3", "Ke2", "Nd4", "Zf3",
+                                         "nf3", "O-O", "O-O-O-O", "0-0", "e4=Q", "e8", "Bb5", "a9", "i3",
+                                         "Nbb1c3", "Ng1xf3x", "\xff\xfe", "e4\xff");
+        CAPTURE(sans);
+        CHECK_FALSE(board.parseSANMove(sans).has_value());
+        CHECK_FALSE(board.parseSANMove(sans, generateAllMoves(board)).has_value());
+    }
+
+    SECTION("Check markers and full disambiguation are accepted") {
+        Board board = Board::standardBoard();
+        CHECK(board.parseSANMove("Nc3+") == Move{"b1", "c3"});
+        CHECK(board.parseSANMove("Nb1c3#") == Move{"b1", "c3"});
+        CHECK(board.parseSANMove("e4") == Move{"e2", "e4", Move::Flag::DoublePushPawn});
+    }
+
+    SECTION("Ambiguous moves are rejected") {
+        Board board = Board::fromFEN("1k6/8/8/8/8/8/K7/R6R w - - 0 1").extract();
+        CHECK_FALSE(board.parseSANMove("Rd1").has_value());
+        CHECK(board.parseSANMove("Rad1") == Move{"a1", "d1"});
+        CHECK(board.parseSANMove("Rhd1") == Move{"h1", "d1"});
+        CHECK_FALSE(board.parseSANMove("R1d1").has_value());
+    }
+
+    SECTION("Pinned pieces cannot move") {
+        Board board = Board::fromFEN("1k6/8/8/8/1q6/8/3N4/4K3 w - - 0 1").extract();
+        CHECK_FALSE(board.parseSANMove("Nf3").has_value());
+        CHECK(board.parseSANMove("Ke2") == Move{"e1", "e2"});
+    }
+
+    SECTION("Promotions must be given exactly on the last row") {
+        Board board = Board::fromFEN("8/P6k/8/8/8/8/8/K7 w - - 0 1").extract();
+        CHECK_FALSE(board.parseSANMove("a8").has_value());
+        CHECK_FALSE(board.parseSANMove("a8=K").has_value());
+        CHECK_FALSE(board.parseSANMove("a8=P").has_value());
+        CHECK(board.parseSANMove("a8=N") == Move{"a7", "a8", Move::Flag::PromotionToKnight});
+        CHECK_FALSE(board.parseSANMove("Ka2=Q").has_value());
+    }
+
+    SECTION("Castling needs the rights and a free path") {
+        Board board = Board::fromFEN("r3k2r/8/8/8/8/8/8/R3K2R w Kq - 0 1").extract();
+        CHECK(board.parseSANMove("O-O") == Move{"e1", "h1", Move::Flag::Castling});
+        CHECK_FALSE(board.parseSANMove("O-O-O").has_value());
+
+        board.makeMove(Move{"a1", "b1"});
+        CHECK(board.parseSANMove("O-O-O") == Move{"e8", "a8", Move::Flag::Castling});
+        CHECK_FALSE(board.parseSANMove("O-O").has_value());
+    }
+}
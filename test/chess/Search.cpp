@@ -0,0 +1,379 @@
+#include "TestUtil.h"
+#include <catch2/catch_test_macros.hpp>
+#include <chess/MoveGen.h>
+#include <chess/ParallelSearch.h>
+#include <chess/Search.h>
+#include <chess/players/Game.h>
+#include <chess/players/SearchPlayer.h>
+#include <chess/players/Stockfish.h>
+#include <chess/players/TrivialPlayers.h>
+#include <set>
+#include <thread>
+
+using namespace Chess;
+
+namespace {
+    void checkPVIsLegal(Board board, const SearchResult& result) {
+        REQUIRE_FALSE(result.pv.empty());
+        CHECK(result.pv.front() == result.bestMove);
+        for (Move move : result.pv) {
+            REQUIRE(generateAllMoves(board).contains(move));
+            board.makeMove(move);
+        }
+    }
+}
+
+TEST_CASE("Search finds tactics", "[chess][search]") {
+
+    SECTION("Mate in one") {
+        Board board = TestUtil::fromFEN("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1");
+        SearchResult result = Search(SearchLimit::depth(4)).run(board);
+        CHECK(result.bestMove == Move{"a1", "a8"});
+        CHECK(result.score == mateScore - 1);
+        CHECK(isMateScore(result.score));
+        // the quiescence search sees that the check has no evasions, so depth 1 already stops
+        CHECK(result.depth == 1);
+    }
+
+    SECTION("Mate in two with a rook ladder") {
+        Board board = TestUtil::fromFEN("7k/8/8/8/8/8/R7/1R4K1 w - - 0 1");
+        SearchResult result = Search(SearchLimit::depth(5)).run(board);
+        CHECK(result.score == mateScore - 3);
+        checkPVIsLegal(board, result);
+        CHECK(result.pv.size() == 3);
+    }
+
+    SECTION("Getting mated is scored from the side to move") {
+        Board board = TestUtil::fromFEN("7k/R7/1R6/8/8/8/8/6K1 b - - 0 1");
+        SearchResult result = Search(SearchLimit::depth(3)).run(board);
+        CHECK(result.score == -mateScore + 2);
+    }
+
+    SECTION("Takes a hanging queen") {
+        Board board = TestUtil::fromFEN("4k3/8/8/3q4/8/8/8/3RK3 w - - 0 1");
+        SearchResult result = Search(SearchLimit::depth(3)).run(board);
+        CHECK(result.bestMove == Move{"d1", "d5"});
+        CHECK(result.score >= pieceValue(Piece::Type::Queen) - pieceValue(Piece::Type::Rook));
+        checkPVIsLegal(board, result);
+    }
+
+    SECTION("Does not take a defended pawn with the queen at the horizon") {
+        Board board = TestUtil::fromFEN("4k3/8/3p4/4p3/8/8/8/4QK2 w - - 0 1");
+        SearchResult result = Search(SearchLimit::depth(1)).run(board);
+        CHECK(result.bestMove != Move{"e1", "e5"});
+    }
+
+    SECTION("Resolves the exchange started at the last ply") {
+        // Rxe5 wins a pawn since the rook recaptures after Rxe5
+        Board board = TestUtil::fromFEN("4k3/4r3/8/4p3/8/8/4R3/4R1K1 w - - 0 1");
+        SearchResult result = Search(SearchLimit::depth(1)).run(board);
+        CHECK(result.bestMove == Move{"e2", "e5"});
+    }
+
+    SECTION("Mates instead of stalemating") {
+        // Qc7 would stalemate, Qc8 mates
+        Board stalemate = TestUtil::fromFEN("k7/2Q5/1K6/8/8/8/8/8 b - - 1 1");
+        REQUIRE(generateAllMoves(stalemate).isStaleMate());
+
+        Board board = TestUtil::fromFEN("k7/8/1K6/8/8/8/8/2Q5 w - - 0 1");
+        SearchResult result = Search(SearchLimit::depth(2)).run(board);
+        CHECK(result.bestMove == Move{"c1", "c8"});
+        CHECK(result.score == mateScore - 1);
+    }
+}
+
+TEST_CASE("Search limits", "[chess][search]") {
+    Board board = Board::standardBoard();
+
+    SECTION("Depth") {
+        std::vector<uint32_t> depths;
+        SearchResult result = Search(SearchLimit::depth(3)).run(board, [&](const SearchResult& iteration) {
+            depths.push_back(iteration.depth);
+            CHECK(iteration.nodes > 0);
+        });
+        CHECK(depths == std::vector<uint32_t>{1, 2, 3});
+        CHECK(result.depth == 3);
+        checkPVIsLegal(board, result);
+        CHECK(result.pv.size() == 3);
+    }
+
+    SECTION("Nodes") {
+        SearchResult result = Search(SearchLimit::nodes(5000)).run(board);
+        CHECK(result.nodes <= 5001);
+        CHECK(result.depth >= 2);
+        CHECK(generateAllMoves(board).contains(result.bestMove));
+    }
+
+    SECTION("Time") {
+        auto start = std::chrono::steady_clock::now();
+        SearchResult result = Search(SearchLimit::moveTime(50)).run(board);
+        CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(2));
+        CHECK(result.depth >= 1);
+        CHECK(result.nodesPerSecond() > 0);
+    }
+
+    SECTION("Stopped from another thread") {
+        Search search(SearchLimit::depth(maxSearchPly));
+        std::thread stopper([&search] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            search.stop();
+        });
+        SearchResult result = search.run(board);
+        stopper.join();
+        CHECK(result.depth < maxSearchPly - 1);
+        CHECK(generateAllMoves(board).contains(result.bestMove));
+    }
+
+    SECTION("Stopped before running") {
+        Search search(SearchLimit::depth(maxSearchPly));
+        search.stop();
+        SearchResult result = search.run(board);
+        CHECK(result.depth == 0);
+        CHECK(generateAllMoves(board).contains(result.bestMove));
+    }
+}
+
+TEST_CASE("Multi PV search", "[chess][search][multipv]") {
+    SECTION("Lines are ranked and distinct") {
+        Board board = TestUtil::fromFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+        Search search(SearchLimit::depth(3));
+        search.setMultiPV(4);
+        std::vector<size_t> lineCounts;
+        SearchResult result = search.run(board, [&](const SearchResult& iteration) {
+            lineCounts.push_back(iteration.lines.size());
+        });
+        CHECK(lineCounts == std::vector<size_t>{4, 4, 4});
+
+        REQUIRE(result.lines.size() == 4);
+        CHECK(result.lines.front().move == result.bestMove);
+        CHECK(result.lines.front().score == result.score);
+        CHECK(result.lines.front().pv == result.pv);
+        std::set<std::string> moves;
+        for (size_t i = 0; i < result.lines.size(); ++i) {
+            const SearchLine& line = result.lines[i];
+            CAPTURE(i, line.move.toSANSquares());
+            CHECK(line.depth == 3);
+            if (i > 0) {
+                CHECK(line.score <= result.lines[i - 1].score);
+            }
+            REQUIRE_FALSE(line.pv.empty());
+            CHECK(line.pv.front() == line.move);
+            Board position = board;
+            for (Move move : line.pv) {
+                REQUIRE(generateAllMoves(position).contains(move));
+                position.makeMove(move);
+            }
+            moves.insert(line.move.toSANSquares());
+        }
+        CHECK(moves.size() == 4);
+    }
+
+    SECTION("The best line is the capture, the next one loses the rook instead") {
+        Board board = TestUtil::fromFEN("k7/8/8/7q/8/8/8/4K2R w - - 0 1");
+        Search search(SearchLimit::depth(4));
+        search.setMultiPV(2);
+        SearchResult result = search.run(board);
+        REQUIRE(result.lines.size() == 2);
+        CHECK(board.moveToSAN(result.bestMove) == "Rxh5");
+        CHECK(result.lines[0].score > 400);
+        CHECK(result.lines[1].score < -400);
+    }
+
+    SECTION("At most one line per legal move") {
+        Board board = TestUtil::fromFEN("k7/8/8/8/8/8/r7/7K w - - 0 1");
+        REQUIRE(generateAllMoves(board).size() == 1);
+        Search search(SearchLimit::depth(3));
+        search.setMultiPV(5);
+        SearchResult result = search.run(board);
+        REQUIRE(result.lines.size() == 1);
+        CHECK(result.lines.front().move == result.bestMove);
+    }
+
+    SECTION("One line is the regular search") {
+        Board board = TestUtil::fromFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+        SearchResult single = Search(SearchLimit::depth(4)).run(board);
+        REQUIRE(single.lines.size() == 1);
+        CHECK(single.lines.front().move == single.bestMove);
+        CHECK(single.lines.front().score == single.score);
+        CHECK(single.lines.front().depth == 4);
+    }
+
+    SECTION("Parallel search ranks the lines of the main search") {
+        Board board = TestUtil::fromFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+        ParallelSearch search(SearchLimit::depth(3), 2);
+        search.setMultiPV(3);
+        SearchResult result = search.run(board);
+        REQUIRE(result.lines.size() == 3);
+        CHECK(result.lines.front().move == result.bestMove);
+        checkPVIsLegal(board, result);
+    }
+
+    SECTION("Explained for the explainer") {
+        Board board = TestUtil::fromFEN("k7/8/8/7q/8/8/8/4K2R w - - 0 1");
+        Search search(SearchLimit::depth(2));
+        search.setMultiPV(3);
+        SearchResult result = search.run(board);
+        auto explained = explainLines(board, result);
+        REQUIRE(explained.size() == 3);
+        CHECK(explained[0].mv == result.bestMove);
+        CHECK(explained[0].score == result.score);
+        CHECK(explained[0].comment.starts_with("depth 2: Rxh5"));
+    }
+}
+
+TEST_CASE("Stockfish info lines", "[chess][search][stockfish]") {
+    auto line = Stockfish::parseInfo("info depth 12 seldepth 16 multipv 2 score cp -35 nodes 81234 nps 812340 "
+                                     "hashfull 12 tbhits 0 time 100 pv e7e5 g1f3 b8c6\n");
+    REQUIRE(line.has_value());
+    CHECK(line->rank == 2);
+    CHECK(line->depth == 12);
+    CHECK(line->score == -35);
+    CHECK(line->move == "e7e5");
+    CHECK(line->pv == std::vector<std::string>{"e7e5", "g1f3", "b8c6"});
+
+    line = Stockfish::parseInfo("info depth 5 seldepth 5 score mate 2 nodes 100 pv a2a8 h8g7 b1b7");
+    REQUIRE(line.has_value());
+    CHECK(line->rank == 1);
+    CHECK(line->score == mateScore - 3);
+
+    line = Stockfish::parseInfo("info depth 5 seldepth 5 score mate -1 nodes 100 pv h8g8");
+    REQUIRE(line.has_value());
+    CHECK(line->score == -mateScore + 2);
+
+    // no exact score, no pv or no info at all
+    CHECK_FALSE(Stockfish::parseInfo("info depth 9 seldepth 12 score cp 20 lowerbound nodes 10 pv e2e4").has_value());
+    CHECK_FALSE(Stockfish::parseInfo("info depth 9 currmove e2e4 currmovenumber 1").has_value());
+    CHECK_FALSE(Stockfish::parseInfo("info string NNUE evaluation enabled").has_value());
+    CHECK_FALSE(Stockfish::parseInfo("bestmove e2e4 ponder e7e5").has_value());
+    CHECK_FALSE(Stockfish::parseInfo("info depth 3 score cp x pv e2e4").has_value());
+}
+
+TEST_CASE("Search with a shared transposition table", "[chess][search][tt]") {
+    TranspositionTable table(4);
+    Board board = TestUtil::fromFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+    SearchResult first = Search(SearchLimit::depth(4), table).run(board);
+    CHECK(table.hashfull() > 0);
+    REQUIRE(table.probe(board.hash()).has_value());
+    CHECK(table.probe(board.hash())->move == first.bestMove);
+
+    // the second search starts with all results of the first one
+    SearchResult second = Search(SearchLimit::depth(4), table).run(board);
+    CHECK(second.bestMove == first.bestMove);
+    CHECK(second.score == first.score);
+    CHECK(second.nodes < first.nodes);
+    checkPVIsLegal(board, second);
+
+    // a mate stored deeper in the tree is still scored from the root
+    Board mate = TestUtil::fromFEN("7k/8/8/8/8/8/R7/1R4K1 w - - 0 1");
+    table.clear();
+    SearchResult mateResult = Search(SearchLimit::depth(5), table).run(mate);
+    CHECK(mateResult.score == mateScore - 3);
+    CHECK(Search(SearchLimit::depth(5), table).run(mate).score == mateScore - 3);
+}
+
+TEST_CASE("Parallel search", "[chess][search][smp]") {
+    Board board = TestUtil::fromFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+    SECTION("A single thread is the same as Search") {
+        SearchResult single = Search(SearchLimit::depth(4)).run(board);
+        ParallelSearch search(SearchLimit::depth(4), 1);
+        CHECK(search.threads() == 1);
+        SearchResult parallel = search.run(board);
+        CHECK(parallel.bestMove == single.bestMove);
+        CHECK(parallel.score == single.score);
+        CHECK(parallel.nodes == single.nodes);
+        CHECK(parallel.pv == single.pv);
+    }
+
+    SECTION("Multiple threads") {
+        ParallelSearch search(SearchLimit::depth(4), 4);
+        std::vector<uint32_t> depths;
+        SearchResult result = search.run(board, [&](const SearchResult& iteration) {
+            depths.push_back(iteration.depth);
+        });
+        CHECK(depths == std::vector<uint32_t>{1, 2, 3, 4});
+        CHECK(result.depth == 4);
+        checkPVIsLegal(board, result);
+
+        Board mate = TestUtil::fromFEN("7k/8/8/8/8/8/R7/1R4K1 w - - 0 1");
+        SearchResult mateResult = ParallelSearch(SearchLimit::depth(5), 3).run(mate);
+        CHECK(mateResult.score == mateScore - 3);
+        checkPVIsLegal(mate, mateResult);
+    }
+
+    SECTION("Node limit is shared by the threads") {
+        SearchResult result = ParallelSearch(SearchLimit::nodes(8000), 4).run(board);
+        CHECK(result.nodes <= 8004);
+        CHECK(generateAllMoves(board).contains(result.bestMove));
+    }
+
+    SECTION("Stopped from another thread") {
+        ParallelSearch search(SearchLimit::depth(maxSearchPly), 2);
+        std::thread stopper([&search] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            search.stop();
+        });
+        SearchResult result = search.run(board);
+        stopper.join();
+        CHECK(generateAllMoves(board).contains(result.bestMove));
+    }
+
+    SECTION("Stopped before running") {
+        ParallelSearch search(SearchLimit::depth(maxSearchPly), 2);
+        search.stop();
+        SearchResult result = search.run(board);
+        CHECK(result.depth == 0);
+        CHECK(generateAllMoves(board).contains(result.bestMove));
+
+        ParallelSearch limited(SearchLimit::depth(3), 2);
+        limited.stop();
+        CHECK(limited.run(board).depth == 0);
+        // until the stop is cleared
+        limited.clearStop();
+        CHECK(limited.run(board).depth == 3);
+    }
+}
+
+TEST_CASE("Selecting the best thread", "[chess][search][smp]") {
+    auto result = [](Move move, Score score, uint32_t depth) {
+        SearchResult r;
+        r.bestMove = move;
+        r.score = score;
+        r.depth = depth;
+        r.nodes = 10;
+        r.pv = {move};
+        return r;
+    };
+    Move e4{"e2", "e4"};
+    Move d4{"d2", "d4"};
+
+    SearchResult selected = selectBestThread({result(e4, 20, 6), result(d4, 30, 5), result(d4, 25, 5)});
+    CHECK(selected.bestMove == d4);
+    CHECK(selected.depth == 5);
+    CHECK(selected.nodes == 30);
+
+    // a mate wins any vote, the shortest one first
+    selected = selectBestThread({result(e4, 20, 8), result(d4, 20, 8), result(e4, mateScore - 7, 6),
+                                 result(d4, mateScore - 5, 5)});
+    CHECK(selected.bestMove == d4);
+    CHECK(selected.score == mateScore - 5);
+
+    // results without a completed iteration do not count
+    selected = selectBestThread({result(e4, 0, 0), result(d4, -50, 3)});
+    CHECK(selected.bestMove == d4);
+}
+
+TEST_CASE("Search player", "[chess][search][player]") {
+    auto player = searchPlayer(SearchLimit::depth(2));
+    CHECK(player->name() == "Search depth 2");
+    CHECK(player->isDeterministic());
+    CHECK_FALSE(searchPlayer(SearchLimit::moveTime(10))->isDeterministic());
+    CHECK_FALSE(searchPlayer(SearchLimit::depth(2), 2)->isDeterministic());
+    CHECK(searchPlayer(SearchLimit::depth(2), 2)->name() == "Search depth 2 threads 2");
+
+    auto opponent = indexPlayer(0);
+    GameResult result = playGame(player, opponent);
+    CHECK(result.final() != GameResult::Final::InProgress);
+    CHECK(result.final() != GameResult::Final::BlackWin);
+}
@@ -143,6 +143,11 @@ namespace TestUtil {
         return board;
     }
 
+    Chess::Board fromFEN(std::string_view fen) {
+        auto board = Chess::Board::fromFEN(fen);
+        REQUIRE(board);
+        return board.extract();
+    }
 }
 
 
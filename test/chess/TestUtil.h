@@ -3,8 +3,10 @@
 #include <catch2/generators/catch_generators.hpp>
 #include <chess/Types.h>
 #include <chess/Piece.h>
+#include <util/Allocations.h>
 #include <vector>
 #include <limits>
+#include <string_view>
 
 #ifndef EXTENDED_TESTS
 #define TEST_SOME(x) sample(2, x)
@@ -19,6 +21,15 @@
 #define TRUE_FALSE() bool(((__TIME__[7] - '0') + __LINE__ + __COUNTER__) % 2)
 #endif
 
+// Only actually verifies anything if built with WITH_ALLOCATION_COUNTING
+#define CHECK_NO_ALLOCATIONS(...)                                   \
+    do {                                                            \
+        util::Allocations::Counter allocationCounter;               \
+        __VA_ARGS__;                                                \
+        auto allocationsMade = allocationCounter.allocations();     \
+        CHECK(allocationsMade == 0u);                               \
+    } while (false)
+
 
 namespace Catch::Generators {
 
@@ -95,6 +106,9 @@ namespace TestUtil {
     Chess::Board generateCastlingBoard(Chess::Color toMove, bool kingSide, bool queenSide, bool withOppositeRook, bool withOpponent = false);
 
     Chess::Board createEnPassantBoard(Chess::Color c, Chess::BoardIndex col);
+
+    // Fails the test if the FEN does not parse
+    Chess::Board fromFEN(std::string_view fen);
 }
 
 namespace std { // NOLINT(cert-dcl58-cpp) This just really helps for logging!
@@ -0,0 +1,112 @@
+#include <catch2/catch_test_macros.hpp>
+#include <chess/TranspositionTable.h>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace Chess;
+
+TEST_CASE("Transposition table", "[chess][search][tt]") {
+    TranspositionTable table(1);
+    CHECK(table.sizeInBytes() == 1024 * 1024);
+    const size_t buckets = table.sizeInBytes() / 64;
+
+    SECTION("Stores and probes entries") {
+        CHECK_FALSE(table.probe(0).has_value());
+        CHECK_FALSE(table.probe(12345).has_value());
+
+        Move promotion{"b7", "a8", Move::Flag::PromotionToKnight};
+        table.store(12345, promotion, -31990, 17, Bound::Lower);
+        auto entry = table.probe(12345);
+        REQUIRE(entry.has_value());
+        CHECK(entry->move == promotion);
+        CHECK(entry->score == -31990);
+        CHECK(entry->depth == 17);
+        CHECK(entry->bound == Bound::Lower);
+
+        // same bucket but another key
+        CHECK_FALSE(table.probe(12345 + buckets).has_value());
+
+        table.store(0, Move{}, 0, 300, Bound::Exact);
+        auto zero = table.probe(0);
+        REQUIRE(zero.has_value());
+        CHECK(zero->depth == TranspositionTable::maxDepth);
+        CHECK(zero->move == Move{});
+
+        table.clear();
+        CHECK_FALSE(table.probe(12345).has_value());
+    }
+
+    SECTION("Storing a key again keeps the move if none is given") {
+        Move move{"e2", "e4", Move::Flag::DoublePushPawn};
+        table.store(42, move, 10, 3, Bound::Exact);
+        table.store(42, Move{}, -5, 4, Bound::Upper);
+        auto entry = table.probe(42);
+        REQUIRE(entry.has_value());
+        CHECK(entry->move == move);
+        CHECK(entry->score == -5);
+        CHECK(entry->bound == Bound::Upper);
+
+        // a much shallower bound does not replace a deep result of the same search
+        table.store(42, Move{}, 99, 1, Bound::Lower);
+        CHECK(table.probe(42)->score == -5);
+    }
+
+    SECTION("Replaces shallow and old entries first") {
+        auto key = [&](uint64_t i) {
+            return 7 + i * buckets;
+        };
+        for (uint64_t i = 0; i < TranspositionTable::entriesPerBucket; ++i) {
+            table.store(key(i), Move{}, Score(i), 10 + i, Bound::Exact);
+        }
+        table.store(key(4), Move{}, 4, 20, Bound::Exact);
+        CHECK_FALSE(table.probe(key(0)).has_value());
+        for (uint64_t i = 1; i <= 4; ++i) {
+            CHECK(table.probe(key(i)).has_value());
+        }
+
+        table.newSearch();
+        CHECK(table.hashfull() == 0);
+        table.store(key(5), Move{}, 5, 1, Bound::Exact);
+        // the shallowest entry of the previous search goes even though it is deeper
+        CHECK_FALSE(table.probe(key(1)).has_value());
+        CHECK(table.probe(key(5)).has_value());
+        CHECK(table.probe(key(4)).has_value());
+    }
+
+    SECTION("Concurrent stores never give data of another key") {
+        // few buckets so threads keep overwriting each others entries
+        constexpr uint64_t keys = 64 * 1024;
+        auto scoreFor = [](uint64_t key) {
+            return Score((key * 2654435761u) % 20000) - 10000;
+        };
+        auto depthFor = [](uint64_t key) {
+            return uint32_t(key % 200);
+        };
+
+        std::vector<std::thread> threads;
+        std::vector<size_t> mismatches(4, 0);
+        for (size_t t = 0; t < mismatches.size(); ++t) {
+            threads.emplace_back([&, t] {
+                for (uint64_t round = 0; round < 4; ++round) {
+                    for (uint64_t i = 0; i < keys; ++i) {
+                        uint64_t key = (i * 0x9e3779b97f4a7c15ull) ^ t;
+                        table.store(key, Move{}, scoreFor(key), depthFor(key), Bound::Exact);
+                        uint64_t other = ((i / 2) * 0x9e3779b97f4a7c15ull) ^ ((t + 1) % 4);
+                        if (auto entry = table.probe(other);
+                            entry && (entry->score != scoreFor(other) || entry->depth != depthFor(other))) {
+                            ++mismatches[t];
+                        }
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        for (size_t count : mismatches) {
+            CHECK(count == 0);
+        }
+        CHECK(table.hashfull() > 900);
+    }
+}
@@ -0,0 +1,82 @@
+#include <chess/EPD.h>
+#include <util/MappedFile.h>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace {
+    bool parseCount(std::string_view value, size_t& out) {
+        auto [p, ec] = std::from_chars(value.data(), value.data() + value.size(), out);
+        return ec == std::errc() && p == value.data() + value.size() && out > 0;
+    }
+}
+
+int main(int argv, char** argc) {
+    if (argv <= 1) {
+        std::cerr << "Use like " << argc[0] << " [options] <filename>\n";
+        return 1;
+    }
+
+    bool showHelp = false;
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t perftDepth = 0;
+    std::string fileName;
+
+    for (int i = 1; i < argv; i++) {
+        std::string arg = argc[i];
+        if (arg.empty()) {
+            std::cerr << "Empty arg? " << i << '\n';
+            continue;
+        }
+        if (arg[0] == '-') {
+            if (arg == "-h" || arg == "--help" || arg == "-?" || arg == "\\?") {
+                showHelp = true;
+                break;
+            } else if (arg == "-j" || arg == "--threads" || arg == "-p" || arg == "--perft") {
+                i++;
+                std::string_view value = i < argv ? argc[i] : "";
+                size_t& target = (arg == "-j" || arg == "--threads") ? threads : perftDepth;
+                if (!parseCount(value, target)) {
+                    std::cerr << "Invalid value for " << arg << " _" << value << "_\n";
+                    return 1;
+                }
+            }
+        } else {
+            fileName = arg;
+        }
+    }
+
+    if (showHelp) {
+        std::cerr << argc[0] << ":"
+                  << " Annotate all positions from an EPD file, writes the result to stdout\n"
+                  << "Use like " << argc[0] << " [options] <filename>\n"
+                  << "Options: \n"
+                  << "   -p, --perft <n>   Check D1 to D<n> with perft instead of writing the legal move count as D1\n"
+                  << "   -h, --help        Show this help message\n"
+                  << "   -j, --threads <n> Amount of threads to use, defaults to all cores\n"
+                ;
+
+        return 0;
+    }
+
+    auto file = util::MappedFile::open(fileName);
+    if (!file.has_value()) {
+        std::cerr << "Could not open file: " << fileName << '\n';
+        return 2;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    auto operation = perftDepth > 0 ? Chess::checkPerft(static_cast<uint32_t>(perftDepth)) : Chess::countLegalMoves();
+    Chess::EPDBatchStats stats = Chess::processEPD(file->contents(), threads, operation, std::cout);
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cerr << "Processed " << stats.records << " positions, " << stats.invalid << " invalid, "
+              << stats.failed << " failed in " << elapsed.count() << "s\n";
+
+    return stats.invalid == 0 && stats.failed == 0 ? 0 : 3;
+}
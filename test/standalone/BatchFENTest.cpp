@@ -1,7 +1,195 @@
 #include <chess/Board.h>
+#include <chess/MoveGen.h>
+#include <util/MappedFile.h>
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
 #include <iostream>
-#include <fstream>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    // FENError values are consecutive and TooManyFullMoves is the last one
+    constexpr size_t errorKinds = static_cast<size_t>(Chess::FENError::TooManyFullMoves) + 1;
+
+    // Chunks smaller than this are not worth a thread
+    constexpr size_t minChunkSize = 1u << 16u;
+
+    struct Stats {
+        uint64_t lines = 0;
+        uint64_t valid = 0;
+        std::array<uint64_t, errorKinds> invalid{};
+
+        uint64_t forcedDraws = 0;
+        // positions without exactly one king per side, these are valid FEN but we cannot generate moves
+        uint64_t notPlayable = 0;
+        uint64_t inCheck = 0;
+        uint64_t checkmate = 0;
+        uint64_t stalemate = 0;
+        std::array<uint64_t, Chess::MoveList::maxMoves + 1> legalMoves{};
+
+        // First invalid line of the chunk, only tracked when stopping on the first failure
+        std::optional<size_t> firstInvalidOffset;
+        std::string_view firstInvalidLine;
+        Chess::FENParseResult firstInvalidResult;
+
+        [[nodiscard]] uint64_t invalidCount() const {
+            uint64_t total = 0;
+            for (auto count : invalid) {
+                total += count;
+            }
+            return total;
+        }
+
+        void merge(const Stats& other) {
+            lines += other.lines;
+            valid += other.valid;
+            for (size_t i = 0; i < invalid.size(); ++i) {
+                invalid[i] += other.invalid[i];
+            }
+            forcedDraws += other.forcedDraws;
+            notPlayable += other.notPlayable;
+            inCheck += other.inCheck;
+            checkmate += other.checkmate;
+            stalemate += other.stalemate;
+            for (size_t i = 0; i < legalMoves.size(); ++i) {
+                legalMoves[i] += other.legalMoves[i];
+            }
+            if (other.firstInvalidOffset.has_value()
+                && (!firstInvalidOffset.has_value() || *other.firstInvalidOffset < *firstInvalidOffset)) {
+                firstInvalidOffset = other.firstInvalidOffset;
+                firstInvalidLine = other.firstInvalidLine;
+                firstInvalidResult = other.firstInvalidResult;
+            }
+        }
+    };
+
+    std::mutex outputLock;
+
+    void reportInvalid(std::string_view line, const Chess::FENParseResult& result) {
+        std::lock_guard guard(outputLock);
+        std::cerr << "Could not parse _" << line << "_" << '\n'
+                  << "      With error: " << result.message() << '\n';
+    }
+
+    void checkPosition(Stats& stats, const Chess::Board& board) {
+        using namespace Chess;
+        if (board.isDrawn(true)) {
+            ++stats.forcedDraws;
+        }
+
+        if (board.countPieces(Piece{Piece::Type::King, Color::White}) != 1
+            || board.countPieces(Piece{Piece::Type::King, Color::Black}) != 1) {
+            ++stats.notPlayable;
+            return;
+        }
+
+        auto [kingCol, kingRow] = board.kingSquare(board.colorToMove());
+        bool inCheck = board.attacked(kingCol, kingRow);
+        MoveList moves = generateAllMoves(board);
+        ++stats.legalMoves[moves.size()];
+
+        if (inCheck) {
+            ++stats.inCheck;
+            if (moves.size() == 0) {
+                ++stats.checkmate;
+            }
+        } else if (moves.size() == 0) {
+            ++stats.stalemate;
+        }
+    }
+
+    // Does not allocate per line, the board is reused and lines are views into the mapped file
+    Stats processChunk(std::string_view chunk, size_t chunkOffset, bool keepGoing) {
+        Stats stats;
+        Chess::Board board = Chess::Board::emptyBoard();
+
+        size_t position = 0;
+        while (position < chunk.size()) {
+            size_t lineEnd = chunk.find('\n', position);
+            if (lineEnd == std::string_view::npos) {
+                lineEnd = chunk.size();
+            }
+            std::string_view line = chunk.substr(position, lineEnd - position);
+            size_t lineOffset = chunkOffset + position;
+            position = lineEnd + 1;
+
+            if (!line.empty() && line.back() == '\r') {
+                line.remove_suffix(1);
+            }
+
+            ++stats.lines;
+            auto result = board.parseFEN(line);
+            if (!result) {
+                ++stats.invalid[static_cast<size_t>(result.error)];
+                if (keepGoing) {
+                    reportInvalid(line, result);
+                    continue;
+                }
+                stats.firstInvalidOffset = lineOffset;
+                stats.firstInvalidLine = line;
+                stats.firstInvalidResult = result;
+                break;
+            }
+
+            ++stats.valid;
+            checkPosition(stats, board);
+        }
+
+        return stats;
+    }
+
+    // Splits into at most count chunks which all end just after a newline (or at the end)
+    std::vector<std::string_view> splitChunks(std::string_view contents, size_t count) {
+        std::vector<std::string_view> chunks;
+        size_t start = 0;
+        for (size_t i = 1; i <= count && start < contents.size(); ++i) {
+            size_t end = contents.size();
+            if (i < count) {
+                size_t target = std::max(start, contents.size() / count * i);
+                end = contents.find('\n', target);
+                end = end == std::string_view::npos ? contents.size() : end + 1;
+            }
+            chunks.push_back(contents.substr(start, end - start));
+            start = end;
+        }
+        return chunks;
+    }
+
+    void printStats(const Stats& stats, bool quiet) {
+        std::cout << "Read " << stats.lines << " FENs with " << stats.invalidCount() << " failures\n";
+        std::cout << stats.forcedDraws << " position which are forced draws\n";
+
+        for (size_t i = 1; i < stats.invalid.size(); ++i) {
+            if (stats.invalid[i] > 0) {
+                std::cout << "  " << stats.invalid[i] << " x "
+                          << Chess::describeFENError(static_cast<Chess::FENError>(i)) << '\n';
+            }
+        }
+
+        std::cout << stats.notPlayable << " positions without exactly one king per side\n"
+                  << stats.inCheck << " positions in check\n"
+                  << stats.checkmate << " checkmates\n"
+                  << stats.stalemate << " stalemates\n";
+
+        if (quiet) {
+            return;
+        }
+
+        std::cout << "Legal moves histogram:\n";
+        for (size_t i = 0; i < stats.legalMoves.size(); ++i) {
+            if (stats.legalMoves[i] > 0) {
+                std::cout << "  " << i << ": " << stats.legalMoves[i] << '\n';
+            }
+        }
+    }
+}
 
 int main(int argv, char** argc) {
     if (argv <= 1) {
@@ -12,6 +200,7 @@ int main(int argv, char** argc) {
     bool showHelp = false;
     bool quiet = false;
     bool keepGoing = false;
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
     std::string fileName;
 
     for (int i = 1; i < argv; i++) {
@@ -28,6 +217,14 @@ int main(int argv, char** argc) {
                 quiet = true;
             } else if (arg == "-c" || arg == "--continue") {
                 keepGoing = true;
+            } else if (arg == "-j" || arg == "--threads") {
+                i++;
+                std::string_view value = i < argv ? argc[i] : "";
+                if (auto [p, ec] = std::from_chars(value.data(), value.data() + value.size(), threads);
+                    ec != std::errc() || p != value.data() + value.size() || threads == 0) {
+                    std::cerr << "Invalid thread count _" << value << "_\n";
+                    return 1;
+                }
             }
         } else {
             fileName = arg;
@@ -39,9 +236,10 @@ int main(int argv, char** argc) {
                   << " Read all FENs from file line by line\n"
                   << "Use like " << argc[0] << " [options] <filename>\n"
                   << "Options: \n"
-                  << "   -q, --quiet     Silence all output except invalid FENs and failures \n"
-                  << "   -h, --help      Show this help message\n"
-                  << "   -c, --continue  Don't stop after first non valid FEN or failure (failures might not be detectable)\n"
+                  << "   -q, --quiet       Silence all output except invalid FENs, failures and totals \n"
+                  << "   -h, --help        Show this help message\n"
+                  << "   -c, --continue    Don't stop after first non valid FEN or failure (failures might not be detectable)\n"
+                  << "   -j, --threads <n> Amount of threads to use, defaults to all cores\n"
                 ;
 
         return 0;
@@ -51,36 +249,49 @@ int main(int argv, char** argc) {
         std::cout << "Reading from " << fileName << '\n';
     }
 
-    uint64_t readLines = 0;
-    uint64_t failure = 0;
-    uint64_t overDraw = 0;
-
-    std::ifstream file(fileName);
-    if (file.is_open()) {
-        std::string line;
-        while (std::getline(file, line)) {
-            Chess::ExpectedBoard eb = Chess::Board::fromFEN(line);
-            if (!eb) {
-                ++failure;
-                std::cerr << "Could not parse _" << line << "_" << '\n'
-                    <<       "      With error: " << eb.error() << '\n';
-                if (!keepGoing) {
-                    return 3;
-                }
-            } else if (eb.value().isDrawn(true)) {
-                ++overDraw;
-            }
-            ++readLines;
-        }
-
-        file.close();
-    } else {
+    auto file = util::MappedFile::open(fileName);
+    if (!file.has_value()) {
         std::cerr << "Could not open file: " << fileName << '\n';
         return 2;
     }
 
-    std::cout << "Read " << readLines << " FENs with " << failure << " failures\n";
-    std::cout << overDraw << " position which are forced draws\n";
+    auto start = std::chrono::steady_clock::now();
+
+    std::string_view contents = file->contents();
+    auto chunks = splitChunks(contents, std::min(threads, contents.size() / minChunkSize + 1));
+    std::vector<Stats> chunkStats(chunks.size());
+    {
+        std::vector<std::thread> workers;
+        workers.reserve(chunks.size());
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            workers.emplace_back([&, i] {
+                size_t offset = static_cast<size_t>(chunks[i].data() - contents.data());
+                chunkStats[i] = processChunk(chunks[i], offset, keepGoing);
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    Stats total;
+    for (const auto& stats : chunkStats) {
+        total.merge(stats);
+    }
+
+    if (total.firstInvalidOffset.has_value()) {
+        reportInvalid(total.firstInvalidLine, total.firstInvalidResult);
+        return 3;
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    printStats(total, quiet);
+
+    if (!quiet) {
+        std::cout << "Took " << elapsed.count() << "s using " << chunks.size() << " thread(s), "
+                  << (static_cast<double>(contents.size()) / (1024.0 * 1024.0) / elapsed.count()) << " MiB/s\n";
+    }
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,144 @@
+#include <chess/PGN.h>
+#include <util/MappedFile.h>
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    // PGNError values are consecutive and InvalidMove is the last one
+    constexpr size_t errorKinds = static_cast<size_t>(Chess::PGNError::InvalidMove) + 1;
+
+    struct Stats {
+        uint64_t games = 0;
+        uint64_t plies = 0;
+        std::array<uint64_t, errorKinds> errors{};
+        std::array<uint64_t, 4> results{};
+
+        void add(const Chess::PGNGame& game) {
+            ++games;
+            plies += game.moves.size();
+            ++errors[static_cast<size_t>(game.error)];
+            ++results[static_cast<size_t>(game.result)];
+        }
+
+        void merge(const Stats& other) {
+            games += other.games;
+            plies += other.plies;
+            for (size_t i = 0; i < errors.size(); ++i) {
+                errors[i] += other.errors[i];
+            }
+            for (size_t i = 0; i < results.size(); ++i) {
+                results[i] += other.results[i];
+            }
+        }
+    };
+
+    std::mutex outputLock;
+
+    void reportInvalid(const Chess::PGNGame& game) {
+        std::lock_guard guard(outputLock);
+        std::cerr << "Game at offset " << game.offset << ": " << Chess::describePGNError(game.error)
+                  << " at offset " << game.errorOffset << '\n';
+    }
+}
+
+int main(int argv, char** argc) {
+    if (argv <= 1) {
+        std::cerr << "Use like " << argc[0] << " [options] <filename>\n";
+        return 1;
+    }
+
+    bool showHelp = false;
+    bool quiet = false;
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string fileName;
+
+    for (int i = 1; i < argv; i++) {
+        std::string arg = argc[i];
+        if (arg.empty()) {
+            std::cerr << "Empty arg? " << i << '\n';
+            continue;
+        }
+        if (arg[0] == '-') {
+            if (arg == "-h" || arg == "--help" || arg == "-?" || arg == "\\?") {
+                showHelp = true;
+                break;
+            } else if (arg == "-q" || arg == "--quiet") {
+                quiet = true;
+            } else if (arg == "-j" || arg == "--threads") {
+                i++;
+                std::string_view value = i < argv ? argc[i] : "";
+                if (auto [p, ec] = std::from_chars(value.data(), value.data() + value.size(), threads);
+                    ec != std::errc() || p != value.data() + value.size() || threads == 0) {
+                    std::cerr << "Invalid thread count _" << value << "_\n";
+                    return 1;
+                }
+            }
+        } else {
+            fileName = arg;
+        }
+    }
+
+    if (showHelp) {
+        std::cerr << argc[0] << ":"
+                  << " Read and replay all games from a PGN file\n"
+                  << "Use like " << argc[0] << " [options] <filename>\n"
+                  << "Options: \n"
+                  << "   -q, --quiet       Do not report every game with an error\n"
+                  << "   -h, --help        Show this help message\n"
+                  << "   -j, --threads <n> Amount of threads to use, defaults to all cores\n"
+                ;
+
+        return 0;
+    }
+
+    auto file = util::MappedFile::open(fileName);
+    if (!file.has_value()) {
+        std::cerr << "Could not open file: " << fileName << '\n';
+        return 2;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<Stats> threadStats(threads);
+    Chess::readPGNParallel(file->contents(), threads, [&](const Chess::PGNGame& game, size_t thread) {
+        threadStats[thread].add(game);
+        if (!quiet && game.error != Chess::PGNError::None) {
+            reportInvalid(game);
+        }
+    });
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    Stats total;
+    for (const auto& stats : threadStats) {
+        total.merge(stats);
+    }
+
+    std::cout << "Read " << total.games << " games with " << total.plies << " plies\n";
+    for (size_t i = 1; i < total.errors.size(); ++i) {
+        if (total.errors[i] > 0) {
+            std::cout << "  " << total.errors[i] << " x " << Chess::describePGNError(static_cast<Chess::PGNError>(i)) << '\n';
+        }
+    }
+
+    using Final = Chess::GameResult::Final;
+    std::cout << total.results[static_cast<size_t>(Final::WhiteWin)] << " white wins, "
+              << total.results[static_cast<size_t>(Final::BlackWin)] << " black wins, "
+              << total.results[static_cast<size_t>(Final::Draw)] << " draws, "
+              << total.results[static_cast<size_t>(Final::InProgress)] << " unfinished\n";
+
+    std::cout << "Took " << elapsed.count() << "s, "
+              << (static_cast<double>(total.games) / elapsed.count()) << " games/s, "
+              << (static_cast<double>(file->size()) / (1024.0 * 1024.0) / elapsed.count()) << " MiB/s\n";
+
+    return total.errors[0] == total.games ? 0 : 3;
+}
@@ -0,0 +1,55 @@
+#include <catch2/catch_test_macros.hpp>
+#include <new>
+#include <string>
+#include <util/Allocations.h>
+#include <vector>
+
+TEST_CASE("Counting allocations", "[util][allocations]") {
+
+    using namespace util::Allocations;
+
+    if (!countingEnabled()) {
+        WARN("Allocation counting is not enabled, build with WITH_ALLOCATION_COUNTING");
+        Counter counter;
+        std::vector<int> values(10);
+        REQUIRE(counter.allocations() == 0);
+        return;
+    }
+
+    SECTION("No allocations gives zero") {
+        Counter counter;
+        int value = 5;
+        value += 3;
+        REQUIRE(value == 8);
+        REQUIRE(counter.allocations() == 0);
+        REQUIRE(counter.bytes() == 0);
+    }
+
+    SECTION("Counts operator new and delete") {
+        Counter counter;
+        void* ptr = ::operator new(64);
+        ::operator delete(ptr);
+        auto stats = counter.stats();
+        REQUIRE(stats.allocations == 1);
+        REQUIRE(stats.deallocations == 1);
+        REQUIRE(stats.bytes == 64);
+    }
+
+    SECTION("Counts allocations of containers") {
+        Counter counter;
+        std::vector<uint64_t> values;
+        values.reserve(100);
+        REQUIRE(counter.allocations() == 1);
+        REQUIRE(counter.bytes() >= 100 * sizeof(uint64_t));
+    }
+
+    SECTION("Counter only counts after creation or reset") {
+        std::string longString(1000, 'x');
+        Counter counter;
+        REQUIRE(counter.allocations() == 0);
+        std::string copy = longString;
+        REQUIRE(counter.allocations() == 1);
+        counter.reset();
+        REQUIRE(counter.allocations() == 0);
+    }
+}
@@ -1,4 +1,6 @@
 #include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <random>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -100,3 +102,83 @@ TEST_CASE("Splitting strings", "[util]") {
     }
 
 }
+
+TEST_CASE("Scanning for characters", "[util]") {
+
+    using namespace util;
+
+    SECTION("Finds the first of any character at every position") {
+        std::string text(100, 'x');
+        for (size_t at = 0; at < text.size(); ++at) {
+            CAPTURE(at);
+            std::string withMatch = text;
+            withMatch[at] = '\n';
+            if (at + 3 < text.size()) {
+                withMatch[at + 3] = ' ';
+            }
+            CHECK(findFirstOf(withMatch, whitespace) == at);
+            CHECK(findFirstOf(withMatch, '\n', at) == at);
+            CHECK(findFirstOf(withMatch, '\n', at + 1) == std::string_view::npos);
+            CHECK(findFirstOf(std::string_view(withMatch).substr(0, at), whitespace) == std::string_view::npos);
+        }
+        CHECK(findFirstOf("", 'x') == std::string_view::npos);
+        CHECK(findFirstOf("abc", 'a', 10) == std::string_view::npos);
+    }
+
+    SECTION("Matches the scalar version on random text") {
+        std::mt19937 random(40);
+        std::string text(1000, ' ');
+        for (char& c : text) {
+            c = static_cast<char>('a' + random() % 26);
+        }
+        CharSet chars("qz;");
+        size_t from = 0;
+        while (from <= text.size()) {
+            size_t expected = detail::findFirstOfScalar(text, chars, from);
+            REQUIRE(findFirstOf(text, chars, from) == expected);
+            if (expected == std::string_view::npos) {
+                break;
+            }
+            from = expected + 1;
+        }
+    }
+}
+
+TEST_CASE("Tokenizing without allocating", "[util]") {
+
+    using namespace util;
+
+    SECTION("Runs of delimiters do not give empty tokens") {
+        std::vector<std::string_view> tokens;
+        for (std::string_view token : Tokenizer("  info depth\t12  score cp 35 \r\n")) {
+            tokens.push_back(token);
+        }
+        CHECK(tokens == std::vector<std::string_view>{"info", "depth", "12", "score", "cp", "35"});
+
+        Tokenizer empty("   ");
+        CHECK_FALSE(empty.next().has_value());
+    }
+
+    SECTION("Gives the same tokens as split for single character separators") {
+        std::string text = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+        std::vector<std::string_view> tokens;
+        Tokenizer tokenizer(text, ' ');
+        while (auto token = tokenizer.next()) {
+            tokens.push_back(*token);
+            CHECK(tokenizer.position() == static_cast<size_t>(token->data() + token->size() - text.data()));
+        }
+        CHECK(tokens == split(text, " "));
+    }
+
+    SECTION("Lines keep empty lines and drop carriage returns") {
+        std::vector<std::string_view> lines;
+        std::vector<size_t> starts;
+        LineScanner scanner("first\r\n\nthird\nlast");
+        for (auto it = scanner.begin(); it != scanner.end(); ++it) {
+            lines.push_back(*it);
+            starts.push_back(scanner.lineStart());
+        }
+        CHECK(lines == std::vector<std::string_view>{"first", "", "third", "last"});
+        CHECK(starts == std::vector<size_t>{0, 7, 8, 14});
+    }
+}
@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <chess/players/Game.h>
+#include <chess/players/TrivialPlayers.h>
+#include <set>
+#include <sstream>
+#include <string_view>
+#include <thread>
+#include <util/Trace.h>
+
+TEST_CASE("Tracing scopes", "[util][trace]") {
+
+    using namespace util::Trace;
+
+    auto countNamed = [](const std::vector<Event>& events, std::string_view name, char phase) {
+        return std::count_if(events.begin(), events.end(), [&](const Event& event) {
+            return event.name == name && event.phase == phase;
+        });
+    };
+
+    SECTION("Nothing is recorded when not started") {
+        start();
+        stop();
+        {
+            TRACE_SCOPE("Not recorded");
+        }
+        REQUIRE(events().empty());
+    }
+
+    SECTION("Nested scopes give ordered begin and end events") {
+        start();
+        {
+            TRACE_SCOPE("Outer");
+            {
+                TRACE_SCOPE("Inner");
+            }
+        }
+        stop();
+
+        auto recorded = events();
+        REQUIRE(recorded.size() == 4);
+        CHECK(recorded[0].name == std::string_view("Outer"));
+        CHECK(recorded[0].phase == 'B');
+        CHECK(recorded[1].name == std::string_view("Inner"));
+        CHECK(recorded[1].phase == 'B');
+        CHECK(recorded[2].name == std::string_view("Inner"));
+        CHECK(recorded[2].phase == 'E');
+        CHECK(recorded[3].name == std::string_view("Outer"));
+        CHECK(recorded[3].phase == 'E');
+        for (size_t i = 1; i < recorded.size(); ++i) {
+            CHECK(recorded[i - 1].timestampNs <= recorded[i].timestampNs);
+            CHECK(recorded[i].threadId == recorded[0].threadId);
+        }
+    }
+
+    SECTION("Starting again clears previous events") {
+        start();
+        {
+            TRACE_SCOPE("First");
+        }
+        start();
+        stop();
+        REQUIRE(events().empty());
+    }
+
+    SECTION("Full ring buffer keeps the newest events") {
+        start(8);
+        for (int i = 0; i < 3; ++i) {
+            TRACE_SCOPE("Old");
+        }
+        for (int i = 0; i < 4; ++i) {
+            TRACE_SCOPE("New");
+        }
+        stop();
+
+        auto recorded = events();
+        REQUIRE(recorded.size() == 8);
+        CHECK(countNamed(recorded, "New", 'B') == 4);
+        CHECK(countNamed(recorded, "New", 'E') == 4);
+        CHECK(countNamed(recorded, "Old", 'B') == 0);
+    }
+
+    SECTION("Every thread gets its own id") {
+        start();
+        {
+            TRACE_SCOPE("Main");
+            std::thread other([] {
+                TRACE_SCOPE("Other");
+            });
+            other.join();
+        }
+        stop();
+
+        auto recorded = events();
+        REQUIRE(recorded.size() == 4);
+        std::set<uint32_t> threads;
+        for (const Event& event : recorded) {
+            threads.insert(event.threadId);
+        }
+        CHECK(threads.size() == 2);
+        CHECK(countNamed(recorded, "Other", 'B') == 1);
+        CHECK(countNamed(recorded, "Other", 'E') == 1);
+    }
+
+    SECTION("Playing a game records the game loop") {
+        start();
+        auto player = Chess::indexPlayer(0);
+        auto result = Chess::playGame(player, player);
+        stop();
+
+        auto recorded = events();
+        CHECK(countNamed(recorded, "playGame", 'B') == 1);
+        CHECK(countNamed(recorded, "playGame", 'E') == 1);
+        CHECK(countNamed(recorded, "pickMove", 'B') > 0);
+        // PGN is only built on request
+        CHECK(countNamed(recorded, "PGN", 'B') == 0);
+        CHECK(countNamed(recorded, "generateAllMoves", 'E') == countNamed(recorded, "pickMove", 'E'));
+
+        start();
+        CHECK_FALSE(result.pgn().empty());
+        stop();
+        CHECK(countNamed(events(), "PGN", 'E') == 1);
+    }
+
+    SECTION("Writes Chrome trace JSON") {
+        start();
+        {
+            TRACE_SCOPE("Json \"quoted\"");
+        }
+        stop();
+
+        std::ostringstream out;
+        writeChromeTrace(out);
+        std::string json = out.str();
+        CHECK(json.find("\"traceEvents\":[") != std::string::npos);
+        CHECK(json.find(R"({"name":"Json \"quoted\"","ph":"B","ts":)") != std::string::npos);
+        CHECK(json.find(R"("ph":"E")") != std::string::npos);
+        CHECK(json.find(R"("pid":1,"tid":)") != std::string::npos);
+        CHECK(json.substr(json.size() - 3) == "]}\n");
+    }
+}